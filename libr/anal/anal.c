@@ -148,12 +148,50 @@ static void __anal_hint_on_bits(RAnal *a, ut64 addr, int bits, bool set) {
 
 }
 
+/* every pooled object is preceded by the pool it came from, so it can be
+ * released without the RAnal, and a NULL pool means it came from calloc */
+#define POOL_HDR (sizeof (void *) * 2)
+
+static const int pool_nodesizes[R_ANAL_POOL_LAST] = {
+	sizeof (RAnalOp), sizeof (RAnalBlock), sizeof (RAnalRef)
+};
+
+// zeroed storage for ops, blocks and refs, the pools lock themselves
+R_API void *r_anal_pool_alloc(RAnal *anal, RAnalPoolType type) {
+	r_return_val_if_fail (type >= 0 && type < R_ANAL_POOL_LAST, NULL);
+	RMemoryPool *pool = anal? anal->pools[type]: NULL;
+	ut8 *p = pool
+		? r_mem_pool_alloc (pool)
+		: calloc (1, POOL_HDR + pool_nodesizes[type]);
+	if (!p) {
+		return NULL;
+	}
+	*(RMemoryPool **)p = pool;
+	return p + POOL_HDR;
+}
+
+// p must come from r_anal_pool_alloc, its RAnal may be gone already
+R_API void r_anal_pool_release(void *p) {
+	if (p) {
+		ut8 *h = (ut8 *)p - POOL_HDR;
+		RMemoryPool *pool = *(RMemoryPool **)h;
+		if (pool) {
+			r_mem_pool_release (pool, h);
+		} else {
+			free (h);
+		}
+	}
+}
+
 R_API RAnal *r_anal_new() {
 	int i;
 	RAnal *anal = R_NEW0 (RAnal);
 	if (!anal) {
 		return NULL;
 	}
+	for (i = 0; i < R_ANAL_POOL_LAST; i++) {
+		anal->pools[i] = r_mem_pool_new (POOL_HDR + pool_nodesizes[i], 4096, 8);
+	}
 	anal->os = strdup (R_SYS_OS);
 	anal->reflines = anal->reflines2 = NULL;
 	anal->esil_goto_limit = R_ANAL_ESIL_GOTO_LIMIT;
@@ -179,6 +217,7 @@ R_API RAnal *r_anal_new() {
 	anal->sdb_hints = sdb_ns (anal->sdb, "hints", 1);
 	anal->hint_cbs.on_bits = __anal_hint_on_bits;
 	anal->sdb_types = sdb_ns (anal->sdb, "types", 1);
+	r_type_cache_init (anal->sdb_types);
 	anal->sdb_fmts = sdb_ns (anal->sdb, "spec", 1);
 	anal->sdb_cc = sdb_ns (anal->sdb, "cc", 1);
 	anal->sdb_zigns = sdb_ns (anal->sdb, "zigns", 1);
@@ -220,6 +259,7 @@ R_API void r_anal_plugin_free (RAnalPlugin *p) {
 }
 
 R_API RAnal *r_anal_free(RAnal *a) {
+	int i;
 	if (!a) {
 		return NULL;
 	}
@@ -240,6 +280,7 @@ R_API RAnal *r_anal_free(RAnal *a) {
 	r_rbtree_free (a->rb_hints_ranges, __anal_hint_range_tree_free);
 	ht_up_free (a->dict_refs);
 	ht_up_free (a->dict_xrefs);
+	r_type_cache_fini (a->sdb_types);
 	a->sdb = NULL;
 	sdb_ns_free (a->sdb);
 	if (a->esil) {
@@ -247,6 +288,10 @@ R_API RAnal *r_anal_free(RAnal *a) {
 		a->esil = NULL;
 	}
 	free (a->last_disasm_reg);
+	// ops and refs handed out may still be alive, they free the pool last
+	for (i = 0; i < R_ANAL_POOL_LAST; i++) {
+		r_mem_pool_drop (a->pools[i]);
+	}
 	free (a);
 	return NULL;
 }
@@ -347,21 +392,13 @@ R_API int r_anal_set_triplet(RAnal *anal, const char *os, const char *arch, int
 	return r_anal_use (anal, arch);
 }
 
-// copypasta from core/cbin.c
-static void sdb_concat_by_path(Sdb *s, const char *path) {
-	Sdb *db = sdb_new (0, path, 0);
-	sdb_merge (s, db);
-	sdb_close (db);
-	sdb_free (db);
-}
-
 R_API bool r_anal_set_os(RAnal *anal, const char *os) {
 	Sdb *types = anal->sdb_types;
 	const char *dir_prefix = r_sys_prefix (NULL);
 	const char *dbpath = sdb_fmt (R_JOIN_3_PATHS ("%s", R2_SDB_FCNSIGN, "types-%s.sdb"),
 		dir_prefix, os);
-	if (r_file_exists (dbpath)) {
-		sdb_concat_by_path (types, dbpath);
+	if (r_file_exists (dbpath) && sdb_layer (types, dbpath)) {
+		r_type_cache_invalidate (types);
 	}
 	return r_anal_set_triplet (anal, os, NULL, -1);
 }
@@ -411,7 +448,7 @@ R_API ut8 *r_anal_mask(RAnal *anal, int size, const ut8 *data, ut64 at) {
 		return anal->cur->anal_mask (anal, size, data, at);
 	}
 
-	if (!(op = r_anal_op_new ())) {
+	if (!(op = r_anal_op_new (anal))) {
 		return NULL;
 	}
 
@@ -469,13 +506,13 @@ R_API RList* r_anal_get_fcns (RAnal *anal) {
 R_API RAnalOp *r_anal_op_hexstr(RAnal *anal, ut64 addr, const char *str) {
 	int len;
 	ut8 *buf;
-	RAnalOp *op = R_NEW0 (RAnalOp);
+	RAnalOp *op = r_anal_op_new (anal);
 	if (!op) {
 		return NULL;
 	}
 	buf = calloc (1, strlen (str) + 1);
 	if (!buf) {
-		free (op);
+		r_anal_op_free (op);
 		return NULL;
 	}
 	len = r_hex_str2bin (str, buf);
@@ -508,6 +545,7 @@ R_API int r_anal_purge (RAnal *anal) {
 	sdb_reset (anal->sdb_meta);
 	sdb_reset (anal->sdb_hints);
 	sdb_reset (anal->sdb_types);
+	r_type_cache_invalidate (anal->sdb_types);
 	sdb_reset (anal->sdb_zigns);
 	sdb_reset (anal->sdb_classes);
 	sdb_reset (anal->sdb_classes_attrs);
@@ -586,15 +624,16 @@ R_API void r_anal_noreturn_list(RAnal *anal, int mode) {
 	}
 }
 
-#define K_NORET_ADDR(x) sdb_fmt ("addr.%"PFMT64x".noreturn", x)
+#define K_NORET_ADDR(k, x) sdb_numkey (k, sizeof (k), "addr.", x, ".noreturn")
 #define K_NORET_FUNC(x) sdb_fmt ("func.%s.noreturn", x)
 
 R_API bool r_anal_noreturn_add(RAnal *anal, const char *name, ut64 addr) {
 	const char *tmp_name = NULL;
 	Sdb *TDB = anal->sdb_types;
 	char *fnl_name = NULL;
+	char key[SDB_NUMKEY_BUFSZ];
 	if (addr != UT64_MAX) {
-		if (sdb_bool_set (TDB, K_NORET_ADDR (addr), true, 0)) {
+		if (sdb_bool_set (TDB, K_NORET_ADDR (key, addr), true, 0)) {
 			return true;
 		}
 	}
@@ -644,7 +683,8 @@ R_API int r_anal_noreturn_drop(RAnal *anal, const char *expr) {
 	const char *fcnname = NULL;
 	if (!strncmp (expr, "0x", 2)) {
 		ut64 n = r_num_math (NULL, expr);
-		sdb_unset (TDB, K_NORET_ADDR (n), 0);
+		char key[SDB_NUMKEY_BUFSZ];
+		sdb_unset (TDB, K_NORET_ADDR (key, n), 0);
 		RAnalFunction *fcn = r_anal_get_fcn_in (anal, n, -1);
 		if (!fcn) {
 			// eprintf ("can't find function at 0x%"PFMT64x"\n", n);
@@ -690,7 +730,8 @@ static bool r_anal_noreturn_at_name(RAnal *anal, const char *name) {
 }
 
 R_API bool r_anal_noreturn_at_addr(RAnal *anal, ut64 addr) {
-	return sdb_bool_get (anal->sdb_types, K_NORET_ADDR (addr), NULL);
+	char key[SDB_NUMKEY_BUFSZ];
+	return sdb_bool_get (anal->sdb_types, K_NORET_ADDR (key, addr), NULL);
 }
 
 bool noreturn_recurse(RAnal *anal, ut64 addr) {
@@ -819,6 +860,37 @@ R_API void r_anal_merge_hint_ranges(RAnal *a) {
 	}
 }
 
+/* moves the range hints starting in [from, to) by delta, the tree is
+ * keyed by the start so it is rebuilt rather than patched in place */
+R_API void r_anal_hint_ranges_rebase(RAnal *a, ut64 from, ut64 to, st64 delta) {
+	r_return_if_fail (a);
+	RAnalRange *range;
+	RListIter *iter;
+	RBIter it;
+	if (!delta || from >= to || !a->rb_hints_ranges) {
+		return;
+	}
+	RList *ranges = r_list_new ();
+	if (!ranges) {
+		return;
+	}
+	r_rbtree_foreach (a->rb_hints_ranges, it, range, RAnalRange, rb) {
+		r_list_append (ranges, range);
+	}
+	a->rb_hints_ranges = NULL;
+	r_list_foreach (ranges, iter, range) {
+		if (range->from >= from && range->from < to) {
+			range->from += delta;
+			if (range->to) {
+				range->to += delta;
+			}
+		}
+		memset (&range->rb, 0, sizeof (range->rb));
+		__anal_range_hint_tree_insert (&a->rb_hints_ranges, range);
+	}
+	r_list_free (ranges);
+}
+
 R_API void r_anal_bind(RAnal *anal, RAnalBind *b) {
 	if (b) {
 		b->anal = anal;
@@ -144,7 +144,7 @@ R_API RAnalOp * r_anal_ex_get_op(RAnal *anal, RAnalState *state, ut64 addr) {
 	if (anal->cur->op_from_buffer) {
 		current_op = anal->cur->op_from_buffer (anal, addr, data,  r_anal_state_get_len (state, addr));
 	} else {
-		current_op = r_anal_op_new();
+		current_op = r_anal_op_new (anal);
 		anal->cur->op (anal, current_op, addr, data,  r_anal_state_get_len (state, addr));
 	}
 	state->current_op = current_op;
@@ -164,7 +164,7 @@ R_API RAnalBlock * r_anal_ex_get_bb(RAnal *anal, RAnalState *state, ut64 addr) {
 	if (!op || !r_anal_state_addr_is_valid (state, addr)) {
 		return NULL;
 	}
-	current_bb = r_anal_bb_new ();
+	current_bb = r_anal_bb_new (anal);
 	if (!current_bb) {
 		return NULL;
 	}
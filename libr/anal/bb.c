@@ -7,8 +7,8 @@
 
 #define DFLT_NINSTR 3
 
-R_API RAnalBlock *r_anal_bb_new() {
-	RAnalBlock *bb = R_NEW0 (RAnalBlock);
+R_API RAnalBlock *r_anal_bb_new(RAnal *anal) {
+	RAnalBlock *bb = r_anal_pool_alloc (anal, R_ANAL_POOL_BB);
 	if (!bb) {
 		return NULL;
 	}
@@ -66,7 +66,7 @@ R_API void r_anal_bb_free(RAnalBlock *bb) {
 		// avoid double free
 		bb->next->prev = NULL;
 	}
-	R_FREE (bb); // double free
+	r_anal_pool_release (bb);
 }
 
 R_API RList *r_anal_bb_list_new() {
@@ -87,7 +87,7 @@ R_API int r_anal_bb(RAnal *anal, RAnalBlock *bb, ut64 addr, ut8 *buf, ut64 len,
 	len -= 16; // XXX: hack to avoid segfault by x86im
 	while (idx < len) {
 		// TODO: too slow object construction
-		if (!(op = r_anal_op_new ())) {
+		if (!(op = r_anal_op_new (anal))) {
 			eprintf ("Error: new (op)\n");
 			return R_ANAL_RET_ERROR;
 		}
@@ -64,7 +64,7 @@ R_API int r_anal_diff_fingerprint_bb(RAnal *anal, RAnalBlock *bb) {
 	if (anal->iob.read_at (anal->iob.io, bb->addr, buf, bb->size)) {
 		memcpy (bb->fingerprint, buf, bb->size);
 		if (anal->diff_ops) { // diff using only the opcode
-			if (!(op = r_anal_op_new ())) {
+			if (!(op = r_anal_op_new (anal))) {
 				free (bb->fingerprint);
 				free (buf);
 				return false;
@@ -78,7 +78,7 @@ R_API int r_anal_diff_fingerprint_bb(RAnal *anal, RAnalBlock *bb) {
 				}
 				idx += oplen;
 			}
-			free (op);
+			r_anal_op_free (op);
 		}
 	}
 	free (buf);
@@ -384,7 +384,7 @@ static RAnalBlock *bbget(RAnalFunction *fcn, ut64 addr, bool jumpmid) {
 }
 
 static RAnalBlock *appendBasicBlock(RAnal *anal, RAnalFunction *fcn, ut64 addr) {
-	RAnalBlock *bb = r_anal_bb_new ();
+	RAnalBlock *bb = r_anal_bb_new (anal);
 	if (!bb) {
 		return NULL;
 	}
@@ -408,15 +408,137 @@ static RAnalBlock *appendBasicBlock(RAnal *anal, RAnalFunction *fcn, ut64 addr)
 		r_anal_fcn_set_size (NULL, fcn, 0);\
 		return R_ANAL_RET_ERROR; }
 
-static int fcn_recurse(RAnal *anal, RAnalFunction *fcn, ut64 addr, ut8 *buf, ut64 len, int depth);
+typedef struct {
+	ut64 addr;
+	ut64 size;
+	ut8 *buf;
+	int pins;
+} RAnalFcnChunk;
+
+// unpinned chunks kept around after their users are done with them
+#define FCN_WINDOW_CHUNKS 4
+// a hit must leave at least this many bytes, enough for any instruction
+#define FCN_WINDOW_MIN 32
+
+static void fcn_chunk_free(void *p) {
+	RAnalFcnChunk *c = p;
+	if (c) {
+		free (c->buf);
+		free (c);
+	}
+}
+
+/* the read-ahead window lives as long as the outermost analysis of a
+ * function. Chunks are pinned while someone holds a pointer into them
+ * and only the unpinned ones are evicted, least recently used first */
+static void fcn_window_begin(RAnal *anal) {
+	if (!anal->fcn_window_refs++) {
+		anal->fcn_window = r_list_newf (fcn_chunk_free);
+	}
+}
+
+static void fcn_window_end(RAnal *anal) {
+	if (anal->fcn_window_refs > 0 && !--anal->fcn_window_refs) {
+		r_list_free (anal->fcn_window);
+		anal->fcn_window = NULL;
+	}
+}
+
+static void fcn_window_evict(RAnal *anal) {
+	RListIter *iter, *iter2;
+	RAnalFcnChunk *c;
+	int unpinned = 0;
+	r_list_foreach_safe (anal->fcn_window, iter, iter2, c) {
+		if (!c->pins && ++unpinned > FCN_WINDOW_CHUNKS) {
+			r_list_delete (anal->fcn_window, iter);
+		}
+	}
+}
+
+static void fcn_window_put(RAnal *anal, RAnalFcnChunk *c) {
+	if (c && c->pins > 0 && !--c->pins) {
+		fcn_window_evict (anal);
+	}
+}
+
+/* returns the bytes at addr and pins the chunk holding them in *pin, to be
+ * released with fcn_window_put. Any chunk with at least need bytes left
+ * after addr is reused, otherwise want bytes are read. *avail is set to
+ * the number of bytes that can be used from the returned pointer */
+static const ut8 *fcn_window_get(RAnal *anal, ut64 addr, ut64 want, ut64 need, ut64 *avail, RAnalFcnChunk **pin) {
+	const int addrbytes = anal->iob.io ? anal->iob.io->addrbytes : 1;
+	RListIter *iter;
+	RAnalFcnChunk *c;
+	if (!anal->fcn_window || !want) {
+		return NULL;
+	}
+	r_list_foreach (anal->fcn_window, iter, c) {
+		ut64 delta = (addr - c->addr) * addrbytes;
+		if (addr >= c->addr && delta < c->size && c->size - delta >= need) {
+			// most recently used first
+			r_list_split_iter (anal->fcn_window, iter);
+			r_list_prepend (anal->fcn_window, c);
+			free (iter);
+			c->pins++;
+			*pin = c;
+			*avail = c->size - delta;
+			return c->buf + delta;
+		}
+	}
+	c = R_NEW0 (RAnalFcnChunk);
+	if (!c) {
+		return NULL;
+	}
+	c->addr = addr;
+	c->size = R_MAX (want, need);
+	c->buf = malloc (c->size);
+	if (!c->buf) {
+		free (c);
+		return NULL;
+	}
+	anal->iob.read_at (anal->iob.io, addr, c->buf, c->size);
+	c->pins = 1;
+	r_list_prepend (anal->fcn_window, c);
+	fcn_window_evict (anal);
+	*pin = c;
+	*avail = c->size;
+	return c->buf;
+}
+
+// copies len bytes at addr, from a cached chunk when one holds all of them
+static void fcn_window_read(RAnal *anal, ut64 addr, ut8 *buf, ut64 len) {
+	const int addrbytes = anal->iob.io ? anal->iob.io->addrbytes : 1;
+	RListIter *iter;
+	RAnalFcnChunk *c;
+	if (anal->fcn_window) {
+		r_list_foreach (anal->fcn_window, iter, c) {
+			ut64 delta = (addr - c->addr) * addrbytes;
+			if (addr >= c->addr && delta < c->size && c->size - delta >= len) {
+				memcpy (buf, c->buf + delta, len);
+				return;
+			}
+		}
+	}
+	anal->iob.read_at (anal->iob.io, addr, buf, len);
+}
+
+static int fcn_recurse_window(RAnal *anal, RAnalFunction *fcn, ut64 addr, ut8 *buf, ut64 len, int depth, RAnalFcnChunk **grown);
+static int fcn_recurse(RAnal *anal, RAnalFunction *fcn, ut64 addr, ut8 *buf, ut64 len, int depth) {
+	return fcn_recurse_window (anal, fcn, addr, buf, len, depth, NULL);
+}
+
+/* blocks start with whatever is left of a cached chunk, fcn_recurse_window
+ * reads more through *grown when the block runs past its end */
 #define recurseAt(x) {\
-		ut8 *bbuf = malloc (anal->opt.bb_max_size);\
+		RAnalFcnChunk *bpin = NULL, *bgrown = NULL;\
+		ut64 bavail = 0;\
+		const ut8 *bbuf = fcn_window_get (anal, x, anal->opt.bb_max_size, FCN_WINDOW_MIN, &bavail, &bpin);\
 		if (bbuf) {\
-			anal->iob.read_at (anal->iob.io, x, bbuf, anal->opt.bb_max_size);\
-			ret = fcn_recurse (anal, fcn, x, bbuf, anal->opt.bb_max_size, depth - 1);\
+			ret = fcn_recurse_window (anal, fcn, x, (ut8 *)bbuf, R_MIN (bavail, anal->opt.bb_max_size), depth - 1, &bgrown);\
+			fcn_window_put (anal, bgrown);\
+			fcn_window_put (anal, bpin);\
 			r_anal_fcn_update_tinyrange_bbs (fcn);\
 			r_anal_fcn_set_size (anal, fcn, r_anal_fcn_size (fcn));\
-			free (bbuf);\
 		}\
 }
 
@@ -504,8 +626,8 @@ static int try_walkthrough_jmptbl(RAnal *anal, RAnalFunction *fcn, int depth, ut
 	if (!jmptbl) {
 		return 0;
 	}
+	fcn_window_read (anal, jmptbl_loc, jmptbl, jmptbl_size * sz);
 	// eprintf ("JMPTBL AT 0x%"PFMT64x"\n", jmptbl_loc);
-	anal->iob.read_at (anal->iob.io, jmptbl_loc, jmptbl, jmptbl_size * sz);
 	for (offs = 0; offs + sz - 1 < jmptbl_size * sz; offs += sz) {
 		switch (sz) {
 		case 1:
@@ -618,7 +740,7 @@ static bool is_delta_pointer_table(RAnal *anal, RAnalFunction *fcn, ut64 addr, u
 	RAnalOp *aop = jmp_aop;
 	RAnalOp mov_aop = {0};
 	RAnalOp add_aop = {0};
-	anal->iob.read_at (anal->iob.io, addr, (ut8 *)buf, JMPTBL_LEA_SEARCH_SZ);
+	fcn_window_read (anal, addr, buf, JMPTBL_LEA_SEARCH_SZ);
 	bool isValid = false;
 	for (i = 0; i + 8 < JMPTBL_LEA_SEARCH_SZ; i++) {
 		int len = r_anal_op (anal, aop, addr + i, buf + i, JMPTBL_LEA_SEARCH_SZ - i, R_ANAL_OP_MASK_BASIC);
@@ -662,7 +784,7 @@ static bool is_delta_pointer_table(RAnal *anal, RAnalFunction *fcn, ut64 addr, u
 #endif
 
 	/* check if jump table contains valid deltas */
-	anal->iob.read_at (anal->iob.io, *jmptbl_addr, (ut8 *)&jmptbl, 64);
+	fcn_window_read (anal, *jmptbl_addr, (ut8 *)&jmptbl, 64);
 	// XXX this is not endian safe
 	for (i = 0; i < 3; i++) {
 		dst = lea_ptr + jmptbl[0];
@@ -693,7 +815,7 @@ static bool try_get_delta_jmptbl_info(RAnal *anal, RAnalFunction *fcn, ut64 jmp_
 		return false;
 	}
 	// search for a cmp register with a resonable size
-	anal->iob.read_at (anal->iob.io, lea_addr, (ut8 *)buf, search_sz);
+	fcn_window_read (anal, lea_addr, buf, search_sz);
 
 	for (i = 0; i + 8 < search_sz; i++) {
 		int len = r_anal_op (anal, &tmp_aop, lea_addr + i, buf + i, search_sz - i, R_ANAL_OP_MASK_BASIC);
@@ -794,7 +916,7 @@ static bool try_get_jmptbl_info(RAnal *anal, RAnalFunction *fcn, ut64 addr, RAna
 		return false;
 	}
 	// search for a cmp register with a resonable size
-	anal->iob.read_at (anal->iob.io, prev_bb->addr, (ut8 *) bb_buf, prev_bb->size);
+	fcn_window_read (anal, prev_bb->addr, bb_buf, prev_bb->size);
 	isValid = false;
 
 	for (i = 0; i < prev_bb->op_pos_size; i++) {
@@ -935,7 +1057,7 @@ static void check_purity(HtUP *ht, RAnal *anal, RAnalFunction *fcn) {
 	r_list_free (refs);
 }
 
-static int fcn_recurse(RAnal *anal, RAnalFunction *fcn, ut64 addr, ut8 *buf, ut64 len, int depth) {
+static int fcn_recurse_window(RAnal *anal, RAnalFunction *fcn, ut64 addr, ut8 *buf, ut64 len, int depth, RAnalFcnChunk **grown) {
 	const int continue_after_jump = anal->opt.afterjmp;
 	const int noncode = anal->opt.noncode;
 	const int addrbytes = anal->iob.io ? anal->iob.io->addrbytes : 1;
@@ -1022,6 +1144,11 @@ static int fcn_recurse(RAnal *anal, RAnalFunction *fcn, ut64 addr, ut8 *buf, ut6
 		r_list_free (list);
 	}
 	ut64 movptr = UT64_MAX; // used by jmptbl when coded as "mov reg,[R*4+B]"
+	// bytes past widx come from wbuf once the block has grown out of buf
+	const ut64 olen = len;
+	const ut8 *wbuf = buf, *cur;
+	ut64 wlen = len, curlen;
+	int widx = 0;
 	while (addrbytes * idx < len) {
 		if (anal->limit && anal->limit->to <= addr + idx) {
 			break;
@@ -1030,33 +1157,55 @@ repeat:
 		if (r_cons_is_breaked ()) {
 			break;
 		}
+		if (grown && len < anal->opt.bb_max_size && idx >= widx
+				&& wlen - addrbytes * (idx - widx) < FCN_WINDOW_MIN) {
+			RAnalFcnChunk *c = NULL;
+			ut64 avail = 0;
+			const ut8 *p = fcn_window_get (anal, addr + idx, anal->opt.bb_max_size,
+				FCN_WINDOW_MIN, &avail, &c);
+			if (p) {
+				fcn_window_put (anal, *grown);
+				*grown = c;
+				wbuf = p;
+				widx = idx;
+				wlen = R_MIN (avail, anal->opt.bb_max_size - addrbytes * idx);
+				len = addrbytes * idx + wlen;
+			}
+		}
+		if (idx >= widx) {
+			cur = wbuf + addrbytes * (idx - widx);
+			curlen = wlen - addrbytes * (idx - widx);
+		} else {
+			cur = buf + addrbytes * idx;
+			curlen = olen - addrbytes * idx;
+		}
 		if ((len - addrbytes * idx) < 5 && len == anal->opt.bb_max_size) { // TODO: use opt.bb_max_size here
 			eprintf (" WARNING : block size exceeding max block size at 0x%08"PFMT64x"\n", addr);
 			eprintf ("[+] Try changing it with e anal.bb.maxsize\n");
 		}
 		r_anal_op_fini (&op);
-		if (isInvalidMemory (buf + addrbytes * idx, len - addrbytes * idx)) {
+		if (isInvalidMemory (cur, curlen)) {
 			FITFCNSZ ();
 			if (anal->verbose) {
 				eprintf ("Warning: FFFF opcode at 0x%08"PFMT64x "\n", addr + idx);
 			}
 			return R_ANAL_RET_ERROR;
 		}
-		if ((oplen = r_anal_op (anal, &op, addr + idx, buf + (addrbytes * idx), len - (addrbytes * idx), R_ANAL_OP_MASK_ALL)) < 1) {
+		if ((oplen = r_anal_op (anal, &op, addr + idx, cur, curlen, R_ANAL_OP_MASK_ALL)) < 1) {
 			RCore *core = anal->coreb.core;
 			if (!core || !core->bin || !core->bin->is_debugger) { // HACK
 				ut8 v = 0;
-				if (addrbytes * (idx + 3) < len) {
-					v += buf[addrbytes*idx] == 0xff;
-					v += buf[addrbytes*(idx+1)] == 0xff;
-					v += buf[addrbytes*(idx+2)] == 0xff;
-					v += buf[addrbytes*(idx+3)] == 0xff;
+				if (addrbytes * 3 < curlen) {
+					v += cur[0] == 0xff;
+					v += cur[addrbytes] == 0xff;
+					v += cur[addrbytes*2] == 0xff;
+					v += cur[addrbytes*3] == 0xff;
 				}
 				if (v < 2) {
 					// check if this is data, then just skip
-					const char *reason = (len - (addrbytes * idx) < 4)? "Truncated": "Invalid";
+					const char *reason = (curlen < 4)? "Truncated": "Invalid";
 					eprintf ("%s instruction of %d bytes at 0x%"PFMT64x"\n",
-							reason, (int)(len - (addrbytes * idx)), addr + idx);
+							reason, (int)curlen, addr + idx);
 				}
 			}
 			gotoBeach (R_ANAL_RET_END);
@@ -1722,7 +1871,9 @@ R_API int r_anal_fcn(RAnal *anal, RAnalFunction *fcn, ut64 addr, ut8 *buf, ut64
 		}
 	}
 	fcn->maxstack = 0;
+	fcn_window_begin (anal);
 	ret = fcn_recurse (anal, fcn, addr, buf, len, anal->opt.depth);
+	fcn_window_end (anal);
 	// update tinyrange for the function
 	r_anal_fcn_update_tinyrange_bbs (fcn);
 
@@ -1754,6 +1905,198 @@ R_API int r_anal_fcn(RAnal *anal, RAnalFunction *fcn, ut64 addr, ut8 *buf, ut64
 	return ret;
 }
 
+#define REBASE(x) if ((x) >= from && (x) < to) { (x) += delta; }
+
+static void fcn_rebase_bb(RAnalBlock *bb, ut64 from, ut64 to, st64 delta) {
+	RListIter *iter;
+	RAnalCaseOp *cop;
+	REBASE (bb->addr);
+	REBASE (bb->jump);
+	REBASE (bb->fail);
+	if (bb->switch_op) {
+		REBASE (bb->switch_op->addr);
+		r_list_foreach (bb->switch_op->cases, iter, cop) {
+			REBASE (cop->addr);
+			REBASE (cop->jump);
+			REBASE (cop->bb_ref_to);
+			REBASE (cop->bb_ref_from);
+		}
+	}
+}
+
+typedef struct {
+	RAnalVar *var;
+	char *xs[2]; // addresses reading and writing the var, as stored
+} FcnRebaseVar;
+
+typedef struct {
+	ut64 at;
+	char *def;
+} FcnRebaseLink;
+
+static void fcn_rebase_var_free(FcnRebaseVar *rv) {
+	if (rv) {
+		r_anal_var_free (rv->var);
+		free (rv->xs[0]);
+		free (rv->xs[1]);
+		free (rv);
+	}
+}
+
+static void fcn_rebase_link_free(FcnRebaseLink *rl) {
+	if (rl) {
+		free (rl->def);
+		free (rl);
+	}
+}
+
+/* take the access records of a var out of the db, with the per
+ * instruction entries that point back to it from the moved range */
+static FcnRebaseVar *fcn_rebase_var_take(RAnal *anal, RAnalFunction *fcn, RAnalVar *var, RList *links, ut64 from, ut64 to) {
+	FcnRebaseVar *rv = R_NEW0 (FcnRebaseVar);
+	if (!rv) {
+		r_anal_var_free (var);
+		return NULL;
+	}
+	rv->var = var;
+	int rw;
+	for (rw = 0; rw < 2; rw++) {
+		rv->xs[rw] = sdb_get (anal->sdb_fcns, sdb_fmt ("var.0x%"PFMT64x".%d.%d.%s",
+			fcn->addr, 1, var->delta, rw? "writes": "reads"), 0);
+		char *list = rv->xs[rw]? strdup (rv->xs[rw]): NULL;
+		char *next, *ptr = list;
+		while (ptr && *ptr) {
+			ut64 at = sdb_atoi (sdb_anext (ptr, &next));
+			if (at >= from && at < to) {
+				sdb_unset (anal->sdb_fcns, sdb_fmt ("inst.0x%"PFMT64x".vars", at), 0);
+			}
+			const char *key = sdb_fmt ("inst.0x%"PFMT64x".lvar", at);
+			char *def = sdb_get (anal->sdb_fcns, key, 0);
+			FcnRebaseLink *rl = def? R_NEW0 (FcnRebaseLink): NULL;
+			if (rl) {
+				rl->at = at;
+				rl->def = def;
+				r_list_append (links, rl);
+				sdb_unset (anal->sdb_fcns, key, 0);
+			} else {
+				free (def);
+			}
+			ptr = next;
+		}
+		free (list);
+	}
+	r_anal_var_delete (anal, fcn->addr, var->kind, 1, var->delta);
+	return rv;
+}
+
+static void fcn_rebase_var_put(RAnal *anal, RAnalFunction *fcn, FcnRebaseVar *rv, ut64 from, ut64 to, st64 delta) {
+	RAnalVar *var = rv->var;
+	int rw;
+	r_anal_var_add (anal, fcn->addr, 1, var->delta, var->kind,
+		var->type, var->size, var->isarg, var->name);
+	for (rw = 0; rw < 2; rw++) {
+		char *next, *ptr = rv->xs[rw];
+		while (ptr && *ptr) {
+			ut64 at = sdb_atoi (sdb_anext (ptr, &next));
+			if (at >= from && at < to) {
+				at += delta;
+			}
+			r_anal_var_access (anal, fcn->addr, var->kind, 1, var->delta, rw, at);
+			ptr = next;
+		}
+	}
+}
+
+/* move the functions starting in [from, to) by delta, with their basic
+ * blocks, variables and variable accesses. Used when the object they
+ * belong to is rebased */
+R_API int r_anal_fcn_rebase(RAnal *anal, ut64 from, ut64 to, st64 delta) {
+	r_return_val_if_fail (anal, -1);
+	RListIter *iter, *iter2;
+	RAnalFunction *fcn;
+	RAnalBlock *bb;
+	RAnalVar *var;
+	FcnRebaseLink *rl;
+	int i, n = 0;
+	if (!delta || from >= to) {
+		return 0;
+	}
+	RList *fcns = r_list_new ();
+	RList *vars = r_list_newf ((RListFree)r_list_free);
+	RList *links = r_list_newf ((RListFree)fcn_rebase_link_free);
+	if (!fcns || !vars || !links) {
+		r_list_free (fcns);
+		r_list_free (vars);
+		r_list_free (links);
+		return -1;
+	}
+	const char kinds[] = { R_ANAL_VAR_KIND_BPV, R_ANAL_VAR_KIND_SPV, R_ANAL_VAR_KIND_REG };
+	// variables are keyed by function address, take them out first so
+	// the new keys cannot clash with a function that has not moved yet
+	r_list_foreach (anal->fcns, iter, fcn) {
+		if (fcn->addr < from || fcn->addr >= to) {
+			continue;
+		}
+		RList *fvars = r_list_newf ((RListFree)fcn_rebase_var_free);
+		for (i = 0; i < R_ARRAY_SIZE (kinds); i++) {
+			RList *list = r_anal_var_list (anal, fcn, kinds[i]);
+			if (list) {
+				list->free = NULL;
+			}
+			r_list_foreach (list, iter2, var) {
+				FcnRebaseVar *rv = fcn_rebase_var_take (anal, fcn, var, links, from, to);
+				if (rv && !r_list_append (fvars, rv)) {
+					fcn_rebase_var_free (rv);
+				}
+			}
+			r_list_free (list);
+		}
+		r_list_append (fcns, fcn);
+		r_list_append (vars, fvars);
+	}
+	// same for the trees, nodes with equal keys must not coexist
+	r_list_foreach (fcns, iter, fcn) {
+		r_anal_fcn_tree_delete (anal, fcn);
+	}
+	iter2 = r_list_iterator (vars);
+	r_list_foreach (fcns, iter, fcn) {
+		RList *fvars = iter2->data;
+		iter2 = iter2->n;
+		fcn->addr += delta;
+		if (fcn->meta.min != UT64_MAX) {
+			REBASE (fcn->meta.min);
+		}
+		// meta.max is exclusive, it may sit right at the end of the range
+		if (fcn->meta.max >= from && fcn->meta.max <= to) {
+			fcn->meta.max += delta;
+		}
+		RListIter *it;
+		r_list_foreach (fcn->bbs, it, bb) {
+			fcn_rebase_bb (bb, from, to, delta);
+		}
+		r_anal_fcn_tree_insert (anal, fcn);
+		FcnRebaseVar *rv;
+		r_list_foreach (fvars, it, rv) {
+			fcn_rebase_var_put (anal, fcn, rv, from, to, delta);
+		}
+		n++;
+	}
+	// instruction to var links name the function by address
+	r_list_foreach (links, iter, rl) {
+		ut64 at = rl->at, faddr = sdb_atoi (rl->def);
+		const char *rest = strchr (rl->def, ',');
+		REBASE (at);
+		REBASE (faddr);
+		sdb_set (anal->sdb_fcns, sdb_fmt ("inst.0x%"PFMT64x".lvar", at),
+			sdb_fmt ("0x%"PFMT64x"%s", faddr, r_str_get (rest)), 0);
+	}
+	r_list_free (fcns);
+	r_list_free (vars);
+	r_list_free (links);
+	return n;
+}
+#undef REBASE
+
 // TODO: need to implement r_anal_fcn_remove(RAnal *anal, RAnalFunction *fcn);
 R_API int r_anal_fcn_insert(RAnal *anal, RAnalFunction *fcn) {
 	// RAnalFunction *f = r_anal_get_fcn_in (anal, fcn->addr, R_ANAL_FCN_TYPE_ROOT);
@@ -1842,6 +2185,59 @@ R_API int r_anal_fcn_del(RAnal *a, ut64 addr) {
 	return true;
 }
 
+static void fcn_bb_drop_refs(RAnal *anal, RAnalBlock *bb, ut64 addr, ut64 len) {
+	RListIter *iter;
+	RAnalRef *ref;
+	int i;
+	for (i = 0; i < bb->ninstr; i++) {
+		ut64 at = r_anal_bb_opaddr_i (bb, i);
+		ut64 end = (i + 1 < bb->ninstr)? r_anal_bb_opaddr_i (bb, i + 1): bb->addr + bb->size;
+		if (at == UT64_MAX || at >= addr + len) {
+			break;
+		}
+		if (end <= addr) {
+			continue;
+		}
+		RList *refs = r_anal_refs_get (anal, at);
+		r_list_foreach (refs, iter, ref) {
+			r_anal_xrefs_deln (anal, ref->at, ref->addr, ref->type);
+		}
+		r_list_free (refs);
+	}
+}
+
+/* marks the functions with a basic block overlapping [addr, addr + len) as
+ * dirty and drops the references made by the instructions overlapping it,
+ * returns the number of functions that became dirty */
+R_API int r_anal_fcn_invalidate(RAnal *anal, ut64 addr, ut64 len) {
+	r_return_val_if_fail (anal, 0);
+	RAnalFunction *fcn;
+	RAnalBlock *bb;
+	RListIter *iter;
+	FcnTreeIter it;
+	int n = 0;
+	if (!len || addr + len < addr) {
+		return 0;
+	}
+	fcn_tree_foreach_intersect (anal->fcn_tree, it, fcn, addr, addr + len) {
+		bool hit = false;
+		r_list_foreach (fcn->bbs, iter, bb) {
+			if (addr < bb->addr + bb->size && bb->addr < addr + len) {
+				// the refs of an already dirty function were made by
+				// the old bytes just the same
+				fcn_bb_drop_refs (anal, bb, addr, len);
+				hit = true;
+			}
+		}
+		if (hit && !fcn->is_dirty) {
+			fcn->is_dirty = true;
+			fcn->has_changed = true;
+			n++;
+		}
+	}
+	return n;
+}
+
 R_API RAnalFunction *r_anal_get_fcn_in(RAnal *anal, ut64 addr, int type) {
 #if 0
   // Linear scan
@@ -1964,7 +2360,9 @@ R_API bool r_anal_fcn_add_bb(RAnal *anal, RAnalFunction *fcn, ut64 addr, ut64 si
 			return false;
 		}
 		anal->iob.read_at (anal->iob.io, addr, bbuf, size);
+		fcn_window_begin (anal);
 		fcn_recurse (anal, fcn, addr, bbuf, size, 1);
+		fcn_window_end (anal);
 		r_anal_fcn_update_tinyrange_bbs (fcn);
 		r_anal_fcn_set_size (anal, fcn, r_anal_fcn_size (fcn));
 		free (bbuf);
@@ -653,22 +653,56 @@ static int node_match_buffer(RAnal *anal, const RFlirtNode *node, ut8 *b, ut64 a
 	return false;
 }
 
+#define FLIRT_PATTERN_SIZE 32
+
+/* Returns the first byte a child of the root can match, -1 for any. */
+static int node_first_byte(const RFlirtNode *node) {
+	if (node->length < 1 || node->variant_bool_array[0]) {
+		return -1;
+	}
+	return node->pattern_bytes[0];
+}
+
 static int node_match_functions(RAnal *anal, const RFlirtNode *root_node) {
 	/* Tries to find matching functions between the signature infos in root_node
 	* and the analyzed functions in anal
 	* Returns false on error. */
 
 	RListIter *it_func, *node_child_it;
+	RList *dispatch[256] = {0};
 	ut8 *func_buf = NULL;
+	int func_buf_size = 0;
 	RAnalFunction *func;
 	RFlirtNode *child;
-	int ret = true;
+	int i, ret = true;
+	int nfcns = 0, nmatches = 0;
 
 	if (r_list_length (anal->fcns) == 0) {
 		anal->cb_printf ("There is no analyzed functions. Have you run 'aa'?\n");
 		return true;
 	}
 
+	// first byte dispatch: only try the root children that can match the
+	// first byte of the function, keeping their order so the first
+	// signature loaded still wins on collisions
+	for (i = 0; i < 256; i++) {
+		if (!(dispatch[i] = r_list_new ())) {
+			ret = false;
+			goto exit;
+		}
+	}
+	r_list_foreach (root_node->child_list, node_child_it, child) {
+		int fb = node_first_byte (child);
+		if (fb < 0) {
+			for (i = 0; i < 256; i++) {
+				r_list_append (dispatch[i], child);
+			}
+		} else {
+			r_list_append (dispatch[fb], child);
+		}
+	}
+
+	ut64 t0 = r_sys_now ();
 	anal->flb.set_fs (anal->flb.f, "flirt");
 	r_list_foreach (anal->fcns, it_func, func) {
 		if (func->type != R_ANAL_FCN_TYPE_FCN && func->type != R_ANAL_FCN_TYPE_LOC) { // scan only for unknown functions
@@ -676,21 +710,42 @@ static int node_match_functions(RAnal *anal, const RFlirtNode *root_node) {
 		}
 
 		int func_size = r_anal_fcn_size (func);
-		func_buf = malloc (func_size);
+		if (func_size < 1) {
+			continue;
+		}
+		// one buffer for all the functions, padded to the pattern size
+		int need = R_MAX (func_size, FLIRT_PATTERN_SIZE);
+		if (need > func_buf_size) {
+			ut8 *b = realloc (func_buf, need);
+			if (!b) {
+				ret = false;
+				goto exit;
+			}
+			func_buf = b;
+			func_buf_size = need;
+		}
+		memset (func_buf + func_size, 0, need - func_size);
 		if (!anal->iob.read_at (anal->iob.io, func->addr, func_buf, func_size)) {
 			eprintf ("Couldn't read function\n");
 			ret = false;
 			goto exit;
 		}
-		r_list_foreach (root_node->child_list, node_child_it, child) {
+		nfcns++;
+		r_list_foreach (dispatch[func_buf[0]], node_child_it, child) {
 			if (node_match_buffer (anal, child, func_buf, func->addr, func_size, 0)) {
+				nmatches++;
 				break;
 			}
 		}
-		R_FREE (func_buf);
 	}
+	ut64 dt = r_sys_now () - t0;
+	eprintf ("%d matches in %d functions (%.1f functions/s)\n", nmatches, nfcns,
+		dt? nfcns * 1000000.0 / dt: 0.0);
 
 exit:
+	for (i = 0; i < 256; i++) {
+		r_list_free (dispatch[i]);
+	}
 	free (func_buf);
 	return ret;
 }
@@ -1459,24 +1514,54 @@ R_API void r_sign_flirt_dump(const RAnal *anal, const char *flirt_file) {
 
 R_API void r_sign_flirt_scan(RAnal *anal, const char *flirt_file) {
 	/*parses a flirt signature file and scan the currently opened file against it.*/
-	RBuffer *flirt_buf;
-	RFlirtNode *node;
-
-	if (!(flirt_buf = r_buf_new_slurp (flirt_file))) {
-		eprintf ("Can't open %s\n", flirt_file);
-		return;
+	RList *files = r_list_new ();
+	if (files) {
+		r_list_append (files, (void *)flirt_file);
+		r_sign_flirt_scan_files (anal, files);
+		r_list_free (files);
 	}
+}
 
-	node = flirt_parse (anal, flirt_buf);
-	r_buf_free (flirt_buf);
-	if (node) {
-		if (!node_match_functions (anal, node)) {
-			eprintf ("Error while scanning the file %s\n", flirt_file);
+R_API void r_sign_flirt_scan_files(RAnal *anal, RList *flirt_files) {
+	/*parses the flirt signature files and scans the currently opened file
+	 against all of them at once. Their trees are merged under a single
+	 root, on collisions the file listed first wins.*/
+	RListIter *iter, *it2;
+	RFlirtNode *node, *child;
+	const char *file;
+
+	RFlirtNode *root = R_NEW0 (RFlirtNode);
+	RList *nodes = r_list_newf ((RListFree)node_free);
+	if (!root || !nodes || !(root->child_list = r_list_new ())) {
+		goto exit;
+	}
+	r_list_foreach (flirt_files, iter, file) {
+		RBuffer *flirt_buf = r_buf_new_slurp (file);
+		if (!flirt_buf) {
+			eprintf ("Can't open %s\n", file);
+			continue;
 		}
-		node_free (node);
-		return;
-	} else {
-		eprintf ("We encountered an error while parsing the file %s. Sorry.\n", flirt_file);
-		return;
+		node = flirt_parse (anal, flirt_buf);
+		r_buf_free (flirt_buf);
+		if (!node) {
+			eprintf ("We encountered an error while parsing the file %s. Sorry.\n", file);
+			continue;
+		}
+		r_list_append (nodes, node);
+		r_list_foreach (node->child_list, it2, child) {
+			r_list_append (root->child_list, child);
+		}
+	}
+	if (!r_list_empty (root->child_list)) {
+		if (!node_match_functions (anal, root)) {
+			eprintf ("Error while scanning the signatures\n");
+		}
+	}
+exit:
+	if (root) {
+		// the children belong to the parsed trees
+		r_list_free (root->child_list);
+		free (root);
 	}
+	r_list_free (nodes);
 }
@@ -19,6 +19,65 @@ R_API void r_anal_hint_del(RAnal *a, ut64 addr, int size) {
 	}
 }
 
+typedef struct {
+	ut64 addr;
+	char *val;
+} HintRebaseItem;
+
+static void hint_rebase_item_free(HintRebaseItem *hri) {
+	if (hri) {
+		free (hri->val);
+		free (hri);
+	}
+}
+
+/* move the hints in [from, to) by delta, used when the object they
+ * belong to is rebased */
+R_API int r_anal_hint_rebase(RAnal *a, ut64 from, ut64 to, st64 delta) {
+	r_return_val_if_fail (a, -1);
+	SdbListIter *lsi;
+	SdbKv *kv;
+	RListIter *iter;
+	HintRebaseItem *hri;
+	char key[128];
+	int n = 0;
+	if (!delta || from >= to) {
+		return 0;
+	}
+	RList *items = r_list_newf ((RListFree)hint_rebase_item_free);
+	if (!items) {
+		return -1;
+	}
+	SdbList *ls = sdb_foreach_list (DB, false);
+	ls_foreach (ls, lsi, kv) {
+		const char *k = sdbkv_key (kv);
+		if (strncmp (k, "hint.0x", 7)) {
+			continue;
+		}
+		ut64 addr = sdb_atoi (k + 5);
+		if (addr < from || addr >= to || !(hri = R_NEW0 (HintRebaseItem))) {
+			continue;
+		}
+		hri->addr = addr;
+		hri->val = strdup (sdbkv_value (kv));
+		r_list_append (items, hri);
+	}
+	ls_free (ls);
+	r_list_foreach (items, iter, hri) {
+		setf (key, "hint.0x%08"PFMT64x, hri->addr);
+		sdb_unset (DB, key, 0);
+	}
+	r_list_foreach (items, iter, hri) {
+		setf (key, "hint.0x%08"PFMT64x, hri->addr + delta);
+		sdb_set (DB, key, hri->val, 0);
+		n++;
+	}
+	r_list_free (items);
+	// bits hints also live in the range tree
+	r_anal_hint_ranges_rebase (a, from, to, delta);
+	return n;
+}
+
 static void unsetHint(RAnal *a, const char *type, ut64 addr) {
 	char key[128];
 	setf (key, "hint.0x%08"PFMT64x, addr);
@@ -39,9 +39,7 @@ static char *meta_inrange_get (RAnal *a, ut64 addr, int size) {
 	char *res = NULL;
 	// return string array of all the offsets where there are stuff
 	for (; base <= base2; base++) {
-		const char *key = sdb_fmt ("range.0x%"PFMT64x, base);
-		// char *r = sdb_array_get (DB, key, 0, 0);
-		char *r = sdb_get (DB, key, 0);
+		char *r = sdb_get_at (DB, "range.0x", base, 0);
 		if (r) {
 			if (res) {
 				res = r_str_append (res, ",");
@@ -61,8 +59,9 @@ static bool meta_inrange_add (RAnal *a, ut64 addr, int size) {
 	ut64 base, base2;
 	base = META_RANGE_BASE (addr);
 	base2 = META_RANGE_BASE (addr + size - 1);
+	char key[SDB_NUMKEY_BUFSZ];
 	for (; base <= base2; base++) {
-		const char *key = sdb_fmt ("range.0x%"PFMT64x, base);
+		sdb_numkey (key, sizeof (key), "range.0x", base, NULL);
 		if (sdb_array_add_num (DB, key, addr, 0)) {
 			set = true;
 		}
@@ -77,8 +76,9 @@ static bool meta_inrange_del (RAnal *a, ut64 addr, int size) {
 	bool set = false;
 	ut64 base = META_RANGE_BASE (addr);
 	ut64 base2 = META_RANGE_BASE (addr + size - 1);
+	char key[SDB_NUMKEY_BUFSZ];
 	for (; base <= base2; base++) {
-		const char *key = sdb_fmt ("range.0x%"PFMT64x, base);
+		sdb_numkey (key, sizeof (key), "range.0x", base, NULL);
 		if (sdb_array_remove_num (DB, key, addr, 0)) {
 			set = true;
 		}
@@ -818,6 +818,77 @@ R_API int r_meta_list_at(RAnal *a, int type, int rad, ut64 addr) {
 	return r_meta_list_cb (a, type, rad, NULL, NULL, addr);
 }
 
+typedef struct {
+	char type;
+	ut64 addr;
+	int size;
+	char *val;
+} MetaRebaseItem;
+
+static void meta_rebase_item_free(MetaRebaseItem *mri) {
+	if (mri) {
+		free (mri->val);
+		free (mri);
+	}
+}
+
+/* move the items starting in [from, to) by delta, used when the object
+ * they annotate is rebased. Entries are taken out before any is put
+ * back so an item cannot land on one that has not moved yet */
+R_API int r_meta_rebase(RAnal *a, ut64 from, ut64 to, st64 delta) {
+	r_return_val_if_fail (a, -1);
+	SdbListIter *lsi;
+	SdbKv *kv;
+	RListIter *iter;
+	MetaRebaseItem *mri;
+	char key[SDB_NUMKEY_BUFSZ];
+	int n = 0;
+	if (!delta || from >= to) {
+		return 0;
+	}
+	RList *items = r_list_newf ((RListFree)meta_rebase_item_free);
+	if (!items) {
+		return -1;
+	}
+	SdbList *ls = sdb_foreach_list (DB, false);
+	ls_foreach (ls, lsi, kv) {
+		const char *k = sdbkv_key (kv);
+		// only "meta.<type>.0x<addr>", var comments carry a second number
+		if (strlen (k) < 10 || memcmp (k, "meta.", 5) || memcmp (k + 6, ".0x", 3)
+				|| strstr (k + 9, "0x")) {
+			continue;
+		}
+		ut64 addr = sdb_atoi (k + 7);
+		if (addr < from || addr >= to || !(mri = R_NEW0 (MetaRebaseItem))) {
+			continue;
+		}
+		mri->type = k[5];
+		mri->addr = addr;
+		mri->size = (int)sdb_atoi (sdbkv_value (kv));
+		mri->val = strdup (sdbkv_value (kv));
+		r_list_append (items, mri);
+	}
+	ls_free (ls);
+	r_list_foreach (items, iter, mri) {
+		const char type[2] = { mri->type, 0 };
+		meta_inrange_del (a, mri->addr, mri->size);
+		sdb_array_remove (DB, sdb_numkey (key, sizeof (key), "meta.0x", mri->addr, NULL), type, 0);
+		snprintf (key, sizeof (key), "meta.%c.0x%"PFMT64x, mri->type, mri->addr);
+		sdb_unset (DB, key, 0);
+	}
+	r_list_foreach (items, iter, mri) {
+		const char type[2] = { mri->type, 0 };
+		ut64 addr = mri->addr + delta;
+		snprintf (key, sizeof (key), "meta.%c.0x%"PFMT64x, mri->type, addr);
+		sdb_set (DB, key, mri->val, 0);
+		sdb_array_add (DB, sdb_numkey (key, sizeof (key), "meta.0x", addr, NULL), type, 0);
+		meta_inrange_add (a, addr, mri->size);
+		n++;
+	}
+	r_list_free (items);
+	return n;
+}
+
 static int meta_enumerate_cb(void *user, const char *k, const char *v) {
 	RAnalMetaUserItem *ui = user;
 	RList *list = ui->user;
@@ -12,8 +12,8 @@ struct VarUsedType {
 	st64 delta;
 };
 
-R_API RAnalOp *r_anal_op_new () {
-	RAnalOp *op = R_NEW (RAnalOp);
+R_API RAnalOp *r_anal_op_new(RAnal *anal) {
+	RAnalOp *op = r_anal_pool_alloc (anal, R_ANAL_POOL_OP);
 	r_anal_op_init (op);
 	return op;
 }
@@ -64,8 +64,7 @@ R_API void r_anal_op_free(void *_op) {
 		return;
 	}
 	r_anal_op_fini (_op);
-	memset (_op, 0, sizeof (RAnalOp));
-	free (_op);
+	r_anal_pool_release (_op);
 }
 
 R_API RAnalVar *get_link_var(RAnal *anal, ut64 faddr, RAnalVar *var) {
@@ -184,8 +183,63 @@ R_API int r_anal_op(RAnal *anal, RAnalOp *op, ut64 addr, const ut8 *data, int le
 	return ret;
 }
 
-R_API RAnalOp *r_anal_op_copy(RAnalOp *op) {
-	RAnalOp *nop = R_NEW0 (RAnalOp);
+/* decodes up to nops consecutive instructions at addr into ops and returns
+ * how many were decoded, each one must be r_anal_op_fini'd by the caller.
+ * Plugins implementing op_batch set up the disassembler once for the whole
+ * range, the asm.bits of addr is used for all of them. Unlike r_anal_op
+ * the variable lookup is only done for R_ANAL_OP_MASK_VAL, so a plain
+ * R_ANAL_OP_MASK_BASIC sweep skips esil, opex, operands and vars */
+R_API int r_anal_op_batch(RAnal *anal, RAnalOp *ops, int nops, ut64 addr, const ut8 *data, int len, int mask) {
+	r_return_val_if_fail (anal && ops && data && nops > 0 && len > 0, -1);
+	RAnalPlugin *cur = anal->cur;
+	bool hints = (mask & R_ANAL_OP_MASK_HINT) && !sdb_isempty (anal->sdb_hints);
+	int i, n;
+	if (!cur || !cur->op_batch || hints || (anal->pcalign && addr % anal->pcalign)) {
+		// hints can change the bits of any address, go one by one
+		int off = 0;
+		for (n = 0; n < nops && off < len; n++) {
+			r_anal_op (anal, &ops[n], addr + off, data + off, len - off, mask);
+			off += R_MAX (ops[n].size, 1);
+		}
+		return n;
+	}
+	anal->decode = (bool)(mask & R_ANAL_OP_MASK_ESIL);
+	anal->fillval = (bool)(mask & R_ANAL_OP_MASK_VAL);
+	if (anal->coreb.archbits) {
+		anal->coreb.archbits (anal->coreb.core, addr);
+	}
+	for (i = 0; i < nops; i++) {
+		r_anal_op_init (&ops[i]);
+	}
+	n = cur->op_batch (anal, ops, nops, addr, data, len);
+	for (i = 0; i < n; i++) {
+		RAnalOp *op = &ops[i];
+		if (anal->pcalign && op->addr % anal->pcalign) {
+			break;
+		}
+		if (op->size < 1) {
+			op->type = R_ANAL_OP_TYPE_ILL;
+		}
+		if (op->nopcode < 1) {
+			op->nopcode = 1;
+		}
+		if (mask & R_ANAL_OP_MASK_VAL) {
+			RAnalVar *tmp = get_used_var (anal, op);
+			if (tmp) {
+				r_anal_var_free (op->var);
+				op->var = tmp;
+			}
+		}
+	}
+	int ret = i;
+	for (; i < n; i++) {
+		r_anal_op_fini (&ops[i]);
+	}
+	return ret;
+}
+
+R_API RAnalOp *r_anal_op_copy(RAnal *anal, RAnalOp *op) {
+	RAnalOp *nop = r_anal_pool_alloc (anal, R_ANAL_POOL_OP);
 	if (!nop) {
 		return NULL;
 	}
@@ -193,7 +247,7 @@ R_API RAnalOp *r_anal_op_copy(RAnalOp *op) {
 	if (op->mnemonic) {
 		nop->mnemonic = strdup (op->mnemonic);
 		if (!nop->mnemonic) {
-			free (nop);
+			r_anal_pool_release (nop);
 			return NULL;
 		}
 	} else {
@@ -212,7 +266,7 @@ R_API RAnalOp *r_anal_op_copy(RAnalOp *op) {
 R_API int r_anal_op_execute(RAnal *anal, RAnalOp *op) {
 	while (op) {
 		if (op->delay > 0) {
-			anal->queued = r_anal_op_copy (op);
+			anal->queued = r_anal_op_copy (anal, op);
 			return false;
 		}
 		switch (op->type) {
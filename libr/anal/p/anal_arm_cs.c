@@ -3019,13 +3019,13 @@ static void op_fillval(RAnalOp *op , csh handle, cs_insn *insn, int bits) {
 	}
 }
 
-static int analop(RAnal *a, RAnalOp *op, ut64 addr, const ut8 *buf, int len) {
-	static csh handle = 0;
+static csh handle = 0;
+
+static bool arm_handle(RAnal *a) {
 	static int omode = -1;
 	static int obits = 32;
-	cs_insn *insn = NULL;
 	int mode = (a->bits==16)? CS_MODE_THUMB: CS_MODE_ARM;
-	int n, ret;
+	int ret;
 	mode |= (a->big_endian)? CS_MODE_BIG_ENDIAN: CS_MODE_LITTLE_ENDIAN;
 	if (a->cpu && strstr (a->cpu, "cortex")) {
 		mode |= CS_MODE_MCLASS;
@@ -3037,6 +3037,19 @@ static int analop(RAnal *a, RAnalOp *op, ut64 addr, const ut8 *buf, int len) {
 		omode = mode;
 		obits = a->bits;
 	}
+	if (handle == 0) {
+		ret = (a->bits == 64)?
+			cs_open (CS_ARCH_ARM64, mode, &handle):
+			cs_open (CS_ARCH_ARM, mode, &handle);
+		cs_option (handle, CS_OPT_DETAIL, CS_OPT_ON);
+		if (ret != CS_ERR_OK) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void arm_op_init(RAnal *a, RAnalOp *op, ut64 addr) {
 	op->type = R_ANAL_OP_TYPE_NULL;
 	op->size = (a->bits==16)? 2: 4;
 	op->stackop = R_ANAL_STACK_NULL;
@@ -3046,14 +3059,37 @@ static int analop(RAnal *a, RAnalOp *op, ut64 addr, const ut8 *buf, int len) {
 	op->ptr = op->val = -1;
 	op->refptr = 0;
 	r_strbuf_init (&op->esil);
-	if (handle == 0) {
-		ret = (a->bits == 64)?
-			cs_open (CS_ARCH_ARM64, mode, &handle):
-			cs_open (CS_ARCH_ARM, mode, &handle);
-		cs_option (handle, CS_OPT_DETAIL, CS_OPT_ON);
-		if (ret != CS_ERR_OK) {
-			return -1;
+}
+
+static void arm_op_insn(RAnal *a, RAnalOp *op, ut64 addr, const ut8 *buf, int len, cs_insn *insn) {
+	//bool thumb = cs_insn_group (handle, insn, ARM_GRP_THUMB);
+	bool thumb = a->bits == 16;
+	op->size = insn->size;
+	op->id = insn->id;
+	if (a->bits == 64) {
+		anop64 (handle, op, insn);
+		if (a->decode) {
+			analop64_esil (a, op, addr, buf, len, &handle, insn);
 		}
+	} else {
+		anop32 (a, handle, op, insn, thumb, (ut8*)buf, len);
+		if (a->decode) {
+			analop_esil (a, op, addr, buf, len, &handle, insn, thumb);
+		}
+	}
+	set_opdir (op);
+	if (a->fillval) {
+		op_fillval (op, handle, insn, a->bits);
+	}
+}
+
+static int analop(RAnal *a, RAnalOp *op, ut64 addr, const ut8 *buf, int len) {
+	cs_insn *insn = NULL;
+	int n;
+
+	arm_op_init (a, op, addr);
+	if (!arm_handle (a)) {
+		return -1;
 	}
 	int haa = hackyArmAnal (a, op, buf, len);
 	if (haa > 0) {
@@ -3064,31 +3100,43 @@ static int analop(RAnal *a, RAnalOp *op, ut64 addr, const ut8 *buf, int len) {
 	if (n < 1) {
 		op->type = R_ANAL_OP_TYPE_ILL;
 	} else {
-		//bool thumb = cs_insn_group (handle, insn, ARM_GRP_THUMB);
-		bool thumb = a->bits == 16;
-		op->size = insn->size;
-		op->id = insn->id;
-		if (a->bits == 64) {
-			anop64 (handle, op, insn);
-			if (a->decode) {
-				analop64_esil (a, op, addr, buf, len, &handle, insn);
-			}
-		} else {
-			anop32 (a, handle, op, insn, thumb, (ut8*)buf, len);
-			if (a->decode) {
-				analop_esil (a, op, addr, buf, len, &handle, insn, thumb);
-			}
-		}
-		set_opdir (op);
-		if (a->fillval) {
-			op_fillval (op, handle, insn, a->bits);
-		}
+		arm_op_insn (a, op, addr, buf, len, insn);
 		cs_free (insn, n);
 	}
 //		cs_close (&handle);
 	return op->size;
 }
 
+/* decodes consecutive instructions reusing a single cs_insn and its
+ * detail buffer, undecodable words are skipped by the instruction size */
+static int analop_batch(RAnal *a, RAnalOp *ops, int nops, ut64 addr, const ut8 *buf, int len) {
+	if (!arm_handle (a)) {
+		return 0;
+	}
+	cs_insn *insn = cs_malloc (handle);
+	if (!insn) {
+		return 0;
+	}
+	int i, off = 0;
+	for (i = 0; i < nops && off < len; i++) {
+		RAnalOp *op = &ops[i];
+		const uint8_t *code = buf + off;
+		size_t size = len - off;
+		uint64_t at = addr + off;
+		arm_op_init (a, op, addr + off);
+		if (hackyArmAnal (a, op, code, (int)size) < 1) {
+			if (cs_disasm_iter (handle, &code, &size, &at, insn)) {
+				arm_op_insn (a, op, addr + off, buf + off, len - off, insn);
+			} else {
+				op->type = R_ANAL_OP_TYPE_ILL;
+			}
+		}
+		off += R_MAX (op->size, 1);
+	}
+	cs_free (insn, 1);
+	return i;
+}
+
 static char *get_reg_profile(RAnal *anal) {
 	const char *p;
 	if (anal->bits == 64) {
@@ -3422,7 +3470,7 @@ static ut8 *anal_mask(RAnal *anal, int size, const ut8 *data, ut64 at) {
 		return NULL;
 	}
 
-	op = r_anal_op_new ();
+	op = r_anal_op_new (anal);
 	ret = malloc (size);
 	memset (ret, 0xff, size);
 
@@ -3452,7 +3500,7 @@ static ut8 *anal_mask(RAnal *anal, int size, const ut8 *data, ut64 at) {
 	}
 
 	anal->bits = obits;
-	free (op);
+	r_anal_op_free (op);
 
 	return ret;
 }
@@ -3468,6 +3516,7 @@ RAnalPlugin r_anal_plugin_arm_cs = {
 	.anal_mask = anal_mask,
 	.bits = 16 | 32 | 64,
 	.op = &analop,
+	.op_batch = &analop_batch,
 };
 
 #ifndef CORELIB
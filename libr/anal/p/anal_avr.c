@@ -2154,7 +2154,7 @@ static ut8 *anal_mask_avr(RAnal *anal, int size, const ut8 *data, ut64 at) {
 	ut8 *ret = NULL;
 	int idx;
 
-	if (!(op = r_anal_op_new ())) {
+	if (!(op = r_anal_op_new (anal))) {
 		return NULL;
 	}
 
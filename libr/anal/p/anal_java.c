@@ -817,7 +817,7 @@ static int java_op(RAnal *anal, RAnalOp *op, ut64 addr, const ut8 *data, int len
 /*
 static RAnalOp * java_op_from_buffer(RAnal *anal, RAnalState *state, ut64 addr) {
 
-	RAnalOp *op = r_anal_op_new ();
+	RAnalOp *op = r_anal_op_new (anal);
 	//  get opcode size
 	if (!op) return 0;
 	memset (op, '\0', sizeof (RAnalOp));
@@ -2731,16 +2731,11 @@ static int cs_len_prefix_opcode(uint8_t *item) {
 	return len;
 }
 
-static int analop(RAnal *a, RAnalOp *op, ut64 addr, const ut8 *buf, int len) {
+static bool x86_handle(RAnal *a) {
 	static int omode = 0;
-#if USE_ITER_API
-	static
-#endif
-	cs_insn *insn = NULL;
 	int mode = (a->bits==64)? CS_MODE_64:
 		(a->bits==32)? CS_MODE_32:
 		(a->bits==16)? CS_MODE_16: 0;
-	int n, ret;
 
 	if (handle && mode != omode) {
 		cs_close (&handle);
@@ -2748,25 +2743,78 @@ static int analop(RAnal *a, RAnalOp *op, ut64 addr, const ut8 *buf, int len) {
 	}
 	omode = mode;
 	if (handle == 0) {
-		ret = cs_open (CS_ARCH_X86, mode, &handle);
+		int ret = cs_open (CS_ARCH_X86, mode, &handle);
 		if (ret != CS_ERR_OK) {
 			handle = 0;
-			return 0;
+			return false;
 		}
+		cs_option (handle, CS_OPT_DETAIL, CS_OPT_ON);
 	}
+	return true;
+}
+
+static void x86_op_init(RAnalOp *op, ut64 addr) {
 	memset (op, '\0', sizeof (RAnalOp));
 	op->cycles = 1; // aprox
 	op->type = R_ANAL_OP_TYPE_NULL;
+	op->addr = addr;
 	op->jump = UT64_MAX;
 	op->fail = UT64_MAX;
 	op->ptr = op->val = UT64_MAX;
-	op->src[0] = NULL;
-	op->src[1] = NULL;
-	op->dst = NULL;
-	op->size = 0;
-	op->delay = 0;
 	r_strbuf_init (&op->esil);
-	cs_option (handle, CS_OPT_DETAIL, CS_OPT_ON);
+}
+
+static void x86_op_insn(RAnal *a, RAnalOp *op, ut64 addr, const ut8 *buf, int len, cs_insn *insn) {
+	// int rs = a->bits / 8;
+	//const char *pc = (a->bits==16)?"ip": (a->bits==32)?"eip":"rip";
+	//const char *sp = (a->bits==16)?"sp": (a->bits==32)?"esp":"rsp";
+	//const char *bp = (a->bits==16)?"bp": (a->bits==32)?"ebp":"rbp";
+	op->nopcode = cs_len_prefix_opcode (insn->detail->x86.prefix)
+		+cs_len_prefix_opcode (insn->detail->x86.opcode);
+	op->size = insn->size;
+	op->id = insn->id;
+	op->family = R_ANAL_OP_FAMILY_CPU; // almost everything is CPU
+	op->prefix = 0;
+	op->cond = cond_x862r2 (insn->id);
+	switch (insn->detail->x86.prefix[0]) {
+	case X86_PREFIX_REPNE:
+		op->prefix |= R_ANAL_OP_PREFIX_REPNE;
+		break;
+	case X86_PREFIX_REP:
+		op->prefix |= R_ANAL_OP_PREFIX_REP;
+		break;
+	case X86_PREFIX_LOCK:
+		op->prefix |= R_ANAL_OP_PREFIX_LOCK;
+		op->family = R_ANAL_OP_FAMILY_THREAD; // XXX ?
+		break;
+	}
+	anop (a, op, addr, buf, len, &handle, insn);
+	set_opdir (op, insn);
+	if (a->decode) {
+		anop_esil (a, op, addr, buf, len, &handle, insn);
+	}
+	if (a->fillval) {
+		op_fillval (a, op, &handle, insn);
+	}
+//#if X86_GRP_PRIVILEGE>0
+#if HAVE_CSGRP_PRIVILEGE
+	if (cs_insn_group (handle, insn, X86_GRP_PRIVILEGE)) {
+		op->family = R_ANAL_OP_FAMILY_PRIV;
+	}
+#endif
+}
+
+static int analop(RAnal *a, RAnalOp *op, ut64 addr, const ut8 *buf, int len) {
+#if USE_ITER_API
+	static
+#endif
+	cs_insn *insn = NULL;
+	int n;
+
+	if (!x86_handle (a)) {
+		return 0;
+	}
+	x86_op_init (op, addr);
 	// capstone-next
 #if USE_ITER_API
 	{
@@ -2783,53 +2831,51 @@ static int analop(RAnal *a, RAnalOp *op, ut64 addr, const ut8 *buf, int len) {
 	if (n < 1) {
 		op->type = R_ANAL_OP_TYPE_ILL;
 	} else {
-		// int rs = a->bits / 8;
-		//const char *pc = (a->bits==16)?"ip": (a->bits==32)?"eip":"rip";
-		//const char *sp = (a->bits==16)?"sp": (a->bits==32)?"esp":"rsp";
-		//const char *bp = (a->bits==16)?"bp": (a->bits==32)?"ebp":"rbp";
-		op->nopcode = cs_len_prefix_opcode (insn->detail->x86.prefix)
-			+cs_len_prefix_opcode (insn->detail->x86.opcode);
-		op->size = insn->size;
-		op->id = insn->id;
-		op->family = R_ANAL_OP_FAMILY_CPU; // almost everything is CPU
-		op->prefix = 0;
-		op->cond = cond_x862r2 (insn->id);
-		switch (insn->detail->x86.prefix[0]) {
-		case X86_PREFIX_REPNE:
-			op->prefix |= R_ANAL_OP_PREFIX_REPNE;
-			break;
-		case X86_PREFIX_REP:
-			op->prefix |= R_ANAL_OP_PREFIX_REP;
-			break;
-		case X86_PREFIX_LOCK:
-			op->prefix |= R_ANAL_OP_PREFIX_LOCK;
-			op->family = R_ANAL_OP_FAMILY_THREAD; // XXX ?
-			break;
-		}
-		anop (a, op, addr, buf, len, &handle, insn);
-		set_opdir (op, insn);
-		if (a->decode) {
-			anop_esil (a, op, addr, buf, len, &handle, insn);
-		}
-		if (a->fillval) {
-			op_fillval (a, op, &handle, insn);
-		}
+		x86_op_insn (a, op, addr, buf, len, insn);
 	}
-//#if X86_GRP_PRIVILEGE>0
-	if (insn) {
-#if HAVE_CSGRP_PRIVILEGE
-		if (cs_insn_group (handle, insn, X86_GRP_PRIVILEGE)) {
-			op->family = R_ANAL_OP_FAMILY_PRIV;
-		}
-#endif
 #if !USE_ITER_API
+	if (insn) {
 		cs_free (insn, n);
-#endif
 	}
+#endif
 	//cs_close (&handle);
 	return op->size;
 }
 
+/* decodes consecutive instructions reusing a single cs_insn and its
+ * detail buffer instead of allocating them for every instruction */
+static int analop_batch(RAnal *a, RAnalOp *ops, int nops, ut64 addr, const ut8 *buf, int len) {
+	if (!x86_handle (a)) {
+		return 0;
+	}
+	cs_insn *insn = cs_malloc (handle);
+	if (!insn) {
+		return 0;
+	}
+	const uint8_t *code = buf;
+	size_t size = len;
+	uint64_t at = addr;
+	int i;
+	for (i = 0; i < nops && size > 0; i++) {
+		RAnalOp *op = &ops[i];
+		const ut8 *cur = code;
+		ut64 cur_addr = at;
+		int cur_len = (int)size;
+		x86_op_init (op, cur_addr);
+		if (cs_disasm_iter (handle, &code, &size, &at, insn)) {
+			x86_op_insn (a, op, cur_addr, cur, cur_len, insn);
+		} else {
+			// skip the undecodable byte like r_anal_op callers do
+			op->type = R_ANAL_OP_TYPE_ILL;
+			code++;
+			size--;
+			at++;
+		}
+	}
+	cs_free (insn, 1);
+	return i;
+}
+
 #if 0
 static int x86_int_0x80(RAnalEsil *esil, int interrupt) {
 	int syscall;
@@ -3296,6 +3342,7 @@ RAnalPlugin r_anal_plugin_x86_cs = {
 	.arch = "x86",
 	.bits = 16|32|64,
 	.op = &analop,
+	.op_batch = &analop_batch,
 	.archinfo = archinfo,
 	.get_reg_profile = &get_reg_profile,
 	.fini = fini,
@@ -20,6 +20,13 @@ struct VarType {
 #define SETKEY(x, ...) snprintf (key, sizeof (key) - 1, x, ## __VA_ARGS__);
 #define SETKEY2(x, ...) snprintf (key2, sizeof (key) - 1, x, ## __VA_ARGS__);
 #define SETVAL(x, ...) snprintf (val, sizeof (val) - 1, x, ## __VA_ARGS__);
+
+/* "fcn.0x<addr>.<kind>" holds the list of vars of a kind in a function */
+static char *var_list_key(char *buf, size_t size, ut64 addr, char kind) {
+	const char suffix[3] = { '.', kind, 0 };
+	return sdb_numkey (buf, size, "fcn.0x", addr, suffix);
+}
+
 R_API bool r_anal_var_display(RAnal *anal, int delta, char kind, const char *type) {
 	char *fmt = r_type_format (anal->sdb_types, type);
 	RRegItem *i;
@@ -94,7 +101,8 @@ R_API bool r_anal_var_add(RAnal *a, ut64 addr, int scope, int delta, char kind,
 			sign = "_";
 		}
 		/* local variable */
-		const char *fcn_key = sdb_fmt ("fcn.0x%"PFMT64x ".%c", addr, kind);
+		char fcn_key[SDB_NUMKEY_BUFSZ];
+		var_list_key (fcn_key, sizeof (fcn_key), addr, kind);
 		const char *var_key = sdb_fmt ("var.0x%"PFMT64x ".%c.%d.%s%d", addr, kind, scope, sign, delta);
 		const char *name_key = sdb_fmt ("var.0x%"PFMT64x ".%d.%s", addr, scope, name);
 		const char *shortvar = sdb_fmt ("%d.%s%d", scope, sign, delta);
@@ -108,7 +116,8 @@ R_API bool r_anal_var_add(RAnal *a, ut64 addr, int scope, int delta, char kind,
 		free (name_val);
 	} else {
 		/* global variable */
-		const char *var_global = sdb_fmt ("var.0x%"PFMT64x, addr);
+		char var_global[SDB_NUMKEY_BUFSZ];
+		sdb_numkey (var_global, sizeof (var_global), "var.0x", addr, NULL);
 		const char *var_def = sdb_fmt ("%c.%s,%d,%s", kind, type, size, name);
 		sdb_array_add (DB, var_global, var_def, 0);
 	}
@@ -156,7 +165,8 @@ R_API int r_anal_var_retype(RAnal *a, ut64 addr, int scope, int delta, char kind
 	if (scope > 0) {
 		char *sign = delta >= 0 ? "": "_";
 		/* local variable */
-		const char *fcn_key = sdb_fmt ("fcn.0x%"PFMT64x ".%c", fcn->addr, kind);
+		char fcn_key[SDB_NUMKEY_BUFSZ];
+		var_list_key (fcn_key, sizeof (fcn_key), fcn->addr, kind);
 		const char *var_key = sdb_fmt ("var.0x%"PFMT64x ".%c.%d.%s%d", fcn->addr, kind, scope, sign, R_ABS(delta));
 		const char *name_key = sdb_fmt ("var.0x%"PFMT64x ".%d.%s", fcn->addr, scope, name);
 		const char *shortvar = sdb_fmt ("%d.%s%d", scope, sign, R_ABS(delta));
@@ -185,7 +195,8 @@ R_API int r_anal_var_retype(RAnal *a, ut64 addr, int scope, int delta, char kind
 		}
 	} else {
 		/* global variable */
-		const char *var_global = sdb_fmt ("var.0x%"PFMT64x, fcn->addr);
+		char var_global[SDB_NUMKEY_BUFSZ];
+		sdb_numkey (var_global, sizeof (var_global), "var.0x", fcn->addr, NULL);
 		sdb_array_add (DB, var_global, var_def, 0);
 	}
 	return true;
@@ -219,7 +230,8 @@ R_API int r_anal_var_delete(RAnal *a, ut64 addr, const char kind, int scope, int
 			delta = -delta;
 			sign = "_";
 		}
-		char *fcn_key = sdb_fmt ("fcn.0x%"PFMT64x ".%c", addr, kind);
+		char fcn_key[SDB_NUMKEY_BUFSZ];
+		var_list_key (fcn_key, sizeof (fcn_key), addr, kind);
 		char *var_key = sdb_fmt ("var.0x%"PFMT64x ".%c.%d.%s%d", addr, kind, scope, sign, delta);
 		char *name_key = sdb_fmt ("var.0x%"PFMT64x ".%d.%s", addr, scope, av->name);
 		char *shortvar = sdb_fmt ("%d.%s%d", scope, sign, delta);
@@ -230,7 +242,8 @@ R_API int r_anal_var_delete(RAnal *a, ut64 addr, const char kind, int scope, int
 			delta = -delta;
 		}
 	} else {
-		char *var_global = sdb_fmt ("var.0x%"PFMT64x, addr);
+		char var_global[SDB_NUMKEY_BUFSZ];
+		sdb_numkey (var_global, sizeof (var_global), "var.0x", addr, NULL);
 		char *var_def = sdb_fmt ("%c.%s,%d,%s", kind, av->type, av->size, av->name);
 		sdb_array_remove (DB, var_global, var_def, 0);
 	}
@@ -244,8 +257,8 @@ R_API bool r_anal_var_delete_byname(RAnal *a, RAnalFunction *fcn, int kind, cons
 	if (!a || !fcn) {
 		return false;
 	}
-	varlist = sdb_get (DB, sdb_fmt ("fcn.0x%"PFMT64x ".%c",
-			fcn->addr, kind), 0);
+	char key[SDB_NUMKEY_BUFSZ];
+	varlist = sdb_get (DB, var_list_key (key, sizeof (key), fcn->addr, kind), 0);
 	if (varlist) {
 		char *next, *ptr = varlist;
 		if (varlist && *varlist) {
@@ -753,7 +766,8 @@ static RList *var_generate_list(RAnal *a, RAnalFunction *fcn, int kind, bool dyn
 	if (kind < 1) {
 		kind = R_ANAL_VAR_KIND_BPV; // by default show vars
 	}
-	char *varlist = sdb_get (DB, sdb_fmt ("fcn.0x%"PFMT64x ".%c", fcn->addr, kind), 0);
+	char key[SDB_NUMKEY_BUFSZ];
+	char *varlist = sdb_get (DB, var_list_key (key, sizeof (key), fcn->addr, kind), 0);
 	if (varlist && *varlist) {
 		char *next, *ptr = varlist;
 		do {
@@ -24,8 +24,8 @@ xrefs
 // XXX: is it possible to have multiple type for the same (from, to) pair?
 //      if it is, things need to be adjusted
 
-static RAnalRef *r_anal_ref_new(ut64 addr, ut64 at, ut64 type) {
-	RAnalRef *ref = R_NEW (RAnalRef);
+static RAnalRef *r_anal_ref_new(RAnal *anal, ut64 addr, ut64 at, ut64 type) {
+	RAnalRef *ref = r_anal_pool_alloc (anal, R_ANAL_POOL_REF);
 	if (ref) {
 		ref->addr = addr;
 		ref->at = at;
@@ -35,7 +35,7 @@ static RAnalRef *r_anal_ref_new(ut64 addr, ut64 at, ut64 type) {
 }
 
 static void r_anal_ref_free(void *ref) {
-	free (ref);
+	r_anal_pool_release (ref);
 }
 
 R_API RList *r_anal_ref_list_new() {
@@ -50,20 +50,25 @@ static void xrefs_ref_free(HtUPKv *kv) {
 	r_anal_ref_free (kv->value);
 }
 
+typedef struct {
+	RAnal *anal;
+	RList *list;
+} ListRefsUser;
+
 static bool appendRef(void *u, const ut64 k, const void *v) {
-	RList *list = (RList *)u;
+	ListRefsUser *user = (ListRefsUser *)u;
 	RAnalRef *ref = (RAnalRef *)v;
-	RAnalRef *cloned = r_anal_ref_new (ref->addr, ref->at, ref->type);
+	RAnalRef *cloned = r_anal_ref_new (user->anal, ref->addr, ref->at, ref->type);
 	if (cloned) {
-		r_list_append (list, cloned);
+		r_list_append (user->list, cloned);
 		return true;
 	}
 	return false;
 }
 
-static bool mylistrefs_cb(void *list, const ut64 k, const void *v) {
+static bool mylistrefs_cb(void *user, const ut64 k, const void *v) {
 	HtUP *ht = (HtUP *)v;
-	ht_up_foreach (ht, appendRef, list);
+	ht_up_foreach (ht, appendRef, user);
 	return true;
 }
 
@@ -83,9 +88,10 @@ static int ref_cmp(const RAnalRef *a, const RAnalRef *b) {
 	return 0;
 }
 
-static void listxrefs(HtUP *m, ut64 addr, RList *list) {
+static void listxrefs(RAnal *anal, HtUP *m, ut64 addr, RList *list) {
+	ListRefsUser user = { anal, list };
 	if (addr == UT64_MAX) {
-		ht_up_foreach (m, mylistrefs_cb, list);
+		ht_up_foreach (m, mylistrefs_cb, &user);
 	} else {
 		bool found;
 		HtUP *d = ht_up_find (m, addr, &found);
@@ -93,12 +99,12 @@ static void listxrefs(HtUP *m, ut64 addr, RList *list) {
 			return;
 		}
 
-		ht_up_foreach (d, appendRef, list);
+		ht_up_foreach (d, appendRef, &user);
 	}
 	r_list_sort (list, (RListComparator)ref_cmp);
 }
 
-static void setxref(HtUP *m, ut64 from, ut64 to, int type) {
+static void setxref(RAnal *anal, HtUP *m, ut64 from, ut64 to, int type) {
 	bool found;
 	HtUP *ht = ht_up_find (m, from, &found);
 	if (!found) {
@@ -108,7 +114,7 @@ static void setxref(HtUP *m, ut64 from, ut64 to, int type) {
 		}
 		ht_up_insert (m, from, ht);
 	}
-	RAnalRef *ref = r_anal_ref_new (to, from, type);
+	RAnalRef *ref = r_anal_ref_new (anal, to, from, type);
 	if (ref) {
 		ht_up_update (ht, to, ref);
 	}
@@ -125,8 +131,8 @@ R_API int r_anal_xrefs_set(RAnal *anal, ut64 from, ut64 to, const RAnalRefType t
 	if (!anal->iob.is_valid_offset (anal->iob.io, to, 0)) {
 		return false;
 	}
-	setxref (anal->dict_xrefs, to, from, type);
-	setxref (anal->dict_refs, from, to, type);
+	setxref (anal, anal->dict_xrefs, to, from, type);
+	setxref (anal, anal->dict_refs, from, to, type);
 	return true;
 }
 
@@ -150,7 +156,7 @@ R_API int r_anal_xref_del(RAnal *anal, ut64 from, ut64 to) {
 }
 
 R_API int r_anal_xrefs_from(RAnal *anal, RList *list, const char *kind, const RAnalRefType type, ut64 addr) {
-	listxrefs (anal->dict_refs, addr, list);
+	listxrefs (anal, anal->dict_refs, addr, list);
 	return true;
 }
 
@@ -159,7 +165,7 @@ R_API RList *r_anal_xrefs_get(RAnal *anal, ut64 to) {
 	if (!list) {
 		return NULL;
 	}
-	listxrefs (anal->dict_xrefs, to, list);
+	listxrefs (anal, anal->dict_xrefs, to, list);
 	if (r_list_empty (list)) {
 		r_list_free (list);
 		list = NULL;
@@ -172,7 +178,7 @@ R_API RList *r_anal_refs_get(RAnal *anal, ut64 from) {
 	if (!list) {
 		return NULL;
 	}
-	listxrefs (anal->dict_refs, from, list);
+	listxrefs (anal, anal->dict_refs, from, list);
 	if (r_list_empty (list)) {
 		r_list_free (list);
 		list = NULL;
@@ -185,7 +191,7 @@ R_API RList *r_anal_xrefs_get_from(RAnal *anal, ut64 to) {
 	if (!list) {
 		return NULL;
 	}
-	listxrefs (anal->dict_refs, to, list);
+	listxrefs (anal, anal->dict_refs, to, list);
 	if (r_list_empty (list)) {
 		r_list_free (list);
 		list = NULL;
@@ -198,7 +204,7 @@ R_API void r_anal_xrefs_list(RAnal *anal, int rad) {
 	RAnalRef *ref;
 	PJ *pj = NULL;
 	RList *list = r_anal_ref_list_new();
-	listxrefs (anal->dict_refs, UT64_MAX, list);
+	listxrefs (anal, anal->dict_refs, UT64_MAX, list);
 	if (rad == 'j') {
 		pj = pj_new ();
 		if (!pj) {
@@ -320,11 +326,46 @@ R_API bool r_anal_xrefs_init(RAnal *anal) {
 	return true;
 }
 
+/* move both ends of the references that fall in [from, to) by delta.
+ * The dictionaries are keyed by address, so they are rebuilt in one pass */
+R_API int r_anal_xrefs_rebase(RAnal *anal, ut64 from, ut64 to, st64 delta) {
+	r_return_val_if_fail (anal, -1);
+	RListIter *iter;
+	RAnalRef *ref;
+	int n = 0;
+	if (!delta || from >= to) {
+		return 0;
+	}
+	RList *list = r_anal_ref_list_new ();
+	if (!list) {
+		return -1;
+	}
+	listxrefs (anal, anal->dict_refs, UT64_MAX, list);
+	if (!r_anal_xrefs_init (anal)) {
+		r_list_free (list);
+		return -1;
+	}
+	r_list_foreach (list, iter, ref) {
+		ut64 at = ref->at, addr = ref->addr;
+		if (at >= from && at < to) {
+			at += delta;
+			n++;
+		}
+		if (addr >= from && addr < to) {
+			addr += delta;
+		}
+		setxref (anal, anal->dict_xrefs, addr, at, ref->type);
+		setxref (anal, anal->dict_refs, at, addr, ref->type);
+	}
+	r_list_free (list);
+	return n;
+}
+
 R_API int r_anal_xrefs_count(RAnal *anal) {
 	return anal->dict_xrefs->count;
 }
 
-static RList *fcn_get_refs(RAnalFunction *fcn, HtUP *ht) {
+static RList *fcn_get_refs(RAnal *anal, RAnalFunction *fcn, HtUP *ht) {
 	RListIter *iter;
 	RAnalBlock *bb;
 	RList *list = r_anal_ref_list_new ();
@@ -337,7 +378,7 @@ static RList *fcn_get_refs(RAnalFunction *fcn, HtUP *ht) {
 
 		for (i = 0; i < bb->ninstr; ++i) {
 			ut64 at = bb->addr + r_anal_bb_offset_inst (bb, i);
-			listxrefs (ht, at, list);
+			listxrefs (anal, ht, at, list);
 		}
 	}
 	return list;
@@ -345,11 +386,11 @@ static RList *fcn_get_refs(RAnalFunction *fcn, HtUP *ht) {
 
 R_API RList *r_anal_fcn_get_refs(RAnal *anal, RAnalFunction *fcn) {
 	r_return_val_if_fail (anal && fcn, NULL);
-	return fcn_get_refs (fcn, anal->dict_refs);
+	return fcn_get_refs (anal, fcn, anal->dict_refs);
 }
 
 R_API RList *r_anal_fcn_get_xrefs(RAnal *anal, RAnalFunction *fcn) {
-	return fcn_get_refs (fcn, anal->dict_xrefs);
+	return fcn_get_refs (anal, fcn, anal->dict_xrefs);
 }
 
 R_API const char *r_anal_ref_type_tostring(RAnalRefType t) {
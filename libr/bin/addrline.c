@@ -0,0 +1,220 @@
+/* radare - LGPL - Copyright 2019 - pancake */
+
+#include <r_bin.h>
+
+/* Compact address to source line table. Rows are appended while parsing
+ * (.debug_line emits them mostly in address order) and sorted once on the
+ * first query, file names are interned so each row is 16 bytes. */
+
+typedef struct {
+	RBinAddrLine row;
+	ut32 seq;
+} SortRow;
+
+static int sortrow_addr_cmp(const void *a, const void *b) {
+	const SortRow *ra = a, *rb = b;
+	if (ra->row.addr != rb->row.addr) {
+		return ra->row.addr < rb->row.addr? -1: 1;
+	}
+	return ra->seq < rb->seq? -1: ra->seq > rb->seq;
+}
+
+static int row_line_cmp(const void *a, const void *b) {
+	const RBinAddrLine *ra = a, *rb = b;
+	if (ra->file != rb->file) {
+		return ra->file < rb->file? -1: 1;
+	}
+	if (ra->line != rb->line) {
+		return ra->line < rb->line? -1: 1;
+	}
+	if (ra->addr != rb->addr) {
+		return ra->addr < rb->addr? -1: 1;
+	}
+	return 0;
+}
+
+R_API RBinAddrLineStore *r_bin_addrline_new(void) {
+	RBinAddrLineStore *s = R_NEW0 (RBinAddrLineStore);
+	if (!s) {
+		return NULL;
+	}
+	s->file_ids = ht_pp_new0 ();
+	if (!s->file_ids) {
+		free (s);
+		return NULL;
+	}
+	r_vector_init (&s->rows, sizeof (RBinAddrLine), NULL, NULL);
+	r_pvector_init (&s->files, free);
+	s->sorted = true;
+	return s;
+}
+
+R_API void r_bin_addrline_free(RBinAddrLineStore *s) {
+	if (s) {
+		r_vector_clear (&s->rows);
+		r_pvector_clear (&s->files);
+		ht_pp_free (s->file_ids);
+		if (s->by_line) {
+			r_vector_free (s->by_line);
+		}
+		free (s);
+	}
+}
+
+R_API bool r_bin_addrline_add(RBinAddrLineStore *s, ut64 addr, const char *file, ut32 line) {
+	r_return_val_if_fail (s && file, false);
+	bool found = false;
+	ut32 id = (ut32)(size_t)ht_pp_find (s->file_ids, file, &found);
+	if (!found) {
+		char *name = strdup (file);
+		if (!name || !r_pvector_push (&s->files, name)) {
+			free (name);
+			return false;
+		}
+		id = r_pvector_len (&s->files) - 1;
+		ht_pp_insert (s->file_ids, file, (void *)(size_t)id);
+	}
+	RBinAddrLine row = { addr, id, line };
+	RBinAddrLine *last = r_vector_empty (&s->rows)? NULL
+		: r_vector_index_ptr (&s->rows, s->rows.len - 1);
+	if (last && last->addr >= addr) {
+		s->sorted = false;
+	}
+	if (!r_vector_push (&s->rows, &row)) {
+		return false;
+	}
+	if (s->by_line) {
+		r_vector_free (s->by_line);
+		s->by_line = NULL;
+	}
+	return true;
+}
+
+/* sort by address keeping the first row added for each address, the
+ * same row a first-come sdb_add used to keep */
+static bool addrline_sort(RBinAddrLineStore *s) {
+	size_t i, n = s->rows.len;
+	if (s->sorted) {
+		return true;
+	}
+	SortRow *tmp = malloc (n * sizeof (SortRow));
+	if (!tmp) {
+		return false;
+	}
+	RBinAddrLine *rows = s->rows.a;
+	for (i = 0; i < n; i++) {
+		tmp[i].row = rows[i];
+		tmp[i].seq = i;
+	}
+	qsort (tmp, n, sizeof (SortRow), sortrow_addr_cmp);
+	size_t j = 0;
+	for (i = 0; i < n; i++) {
+		if (j && rows[j - 1].addr == tmp[i].row.addr) {
+			continue;
+		}
+		rows[j++] = tmp[i].row;
+	}
+	free (tmp);
+	s->rows.len = j;
+	r_vector_shrink (&s->rows);
+	s->sorted = true;
+	return true;
+}
+
+static size_t addrline_lower_bound(RBinAddrLineStore *s, ut64 addr) {
+	RBinAddrLine *rows = s->rows.a;
+	size_t lo = 0, hi = s->rows.len;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (rows[mid].addr < addr) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/* returns the row for exactly this address or NULL */
+R_API const RBinAddrLine *r_bin_addrline_get(RBinAddrLineStore *s, ut64 addr) {
+	r_return_val_if_fail (s, NULL);
+	if (!addrline_sort (s)) {
+		return NULL;
+	}
+	size_t i = addrline_lower_bound (s, addr);
+	if (i < s->rows.len) {
+		RBinAddrLine *row = r_vector_index_ptr (&s->rows, i);
+		if (row->addr == addr) {
+			return row;
+		}
+	}
+	return NULL;
+}
+
+R_API const char *r_bin_addrline_file(RBinAddrLineStore *s, const RBinAddrLine *row) {
+	r_return_val_if_fail (s && row, NULL);
+	return row->file < r_pvector_len (&s->files)? r_pvector_at (&s->files, row->file): NULL;
+}
+
+/* returns the lowest address of file:line, UT64_MAX if there is none */
+R_API ut64 r_bin_addrline_find(RBinAddrLineStore *s, const char *file, ut32 line) {
+	r_return_val_if_fail (s && file, UT64_MAX);
+	bool found = false;
+	ut32 id = (ut32)(size_t)ht_pp_find (s->file_ids, file, &found);
+	if (!found || !addrline_sort (s)) {
+		return UT64_MAX;
+	}
+	if (!s->by_line) {
+		s->by_line = r_vector_clone (&s->rows);
+		if (!s->by_line) {
+			return UT64_MAX;
+		}
+		qsort (s->by_line->a, s->by_line->len, sizeof (RBinAddrLine), row_line_cmp);
+	}
+	RBinAddrLine *rows = s->by_line->a;
+	RBinAddrLine key = { 0, id, line };
+	size_t lo = 0, hi = s->by_line->len;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (row_line_cmp (&rows[mid], &key) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (lo < s->by_line->len && rows[lo].file == id && rows[lo].line == line) {
+		return rows[lo].addr;
+	}
+	return UT64_MAX;
+}
+
+R_API bool r_bin_addrline_del(RBinAddrLineStore *s, ut64 addr) {
+	r_return_val_if_fail (s, false);
+	if (!addrline_sort (s)) {
+		return false;
+	}
+	size_t i = addrline_lower_bound (s, addr);
+	if (i < s->rows.len && ((RBinAddrLine *)r_vector_index_ptr (&s->rows, i))->addr == addr) {
+		r_vector_remove_at (&s->rows, i, NULL);
+		if (s->by_line) {
+			r_vector_free (s->by_line);
+			s->by_line = NULL;
+		}
+		return true;
+	}
+	return false;
+}
+
+/* iterates the rows sorted by address */
+R_API void r_bin_addrline_foreach(RBinAddrLineStore *s, RBinAddrLineCallback cb, void *user) {
+	r_return_if_fail (s && cb);
+	RBinAddrLine *row;
+	if (!addrline_sort (s)) {
+		return;
+	}
+	r_vector_foreach (&s->rows, row) {
+		if (!cb (user, row, r_pvector_at (&s->files, row->file))) {
+			break;
+		}
+	}
+}
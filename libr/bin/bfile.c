@@ -689,6 +689,8 @@ R_API void r_bin_file_free(void /*RBinFile*/ *bf_) {
 		sdb_free (a->sdb_addrinfo);
 		a->sdb_addrinfo = NULL;
 	}
+	r_bin_addrline_free (a->addrline);
+	r_bin_dwarf_index_free (a->dwarf_index);
 	free (a->file);
 	a->o = NULL;
 	r_list_free (a->objs);
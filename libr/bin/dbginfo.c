@@ -3,6 +3,33 @@
 #include <r_types.h>
 #include <r_bin.h>
 
+/* the DWARF line table is parsed for every format, not only for the
+ * plugins providing their own dbginfo */
+static bool addrline_get(RBinFile *bf, ut64 addr, char *file, int len, int *line) {
+	if (!bf->addrline) {
+		return false;
+	}
+	const RBinAddrLine *row = r_bin_addrline_get (bf->addrline, addr);
+	const char *name = row? r_bin_addrline_file (bf->addrline, row): NULL;
+	if (!name) {
+		return false;
+	}
+	// line programs often name files relative to the unit's
+	// compilation directory, resolve them against it
+	const char *dir = NULL;
+	if (bf->dwarf_index && *name != '/' && !r_file_exists (name)) {
+		const RBinDwarfCompUnit *cu = r_bin_dwarf_index_at (bf->dwarf_index, addr);
+		dir = r_bin_dwarf_unit_str (cu, DW_AT_comp_dir);
+	}
+	if (dir) {
+		snprintf (file, len, "%s/%s", dir, name);
+	} else {
+		snprintf (file, len, "%s", name);
+	}
+	*line = row->line;
+	return true;
+}
+
 R_API int r_bin_addr2line(RBin *bin, ut64 addr, char *file, int len, int *line) {
 	RBinFile *binfile = r_bin_cur (bin);
 	RBinObject *o = r_bin_cur_object (bin);
@@ -10,13 +37,13 @@ R_API int r_bin_addr2line(RBin *bin, ut64 addr, char *file, int len, int *line)
 	ut64 baddr = r_bin_get_baddr (bin);
 	if (cp && cp->dbginfo) {
 		if (o && addr >= baddr && addr < baddr + bin->cur->o->size) {
-			if (cp->dbginfo->get_line) {
-				return cp->dbginfo->get_line (
-					bin->cur, addr, file, len, line);
+			if (cp->dbginfo->get_line && cp->dbginfo->get_line (
+					bin->cur, addr, file, len, line)) {
+				return true;
 			}
 		}
 	}
-	return false;
+	return binfile && len > 0 && addrline_get (binfile, addr, file, len, line);
 }
 
 R_API char *r_bin_addr2text(RBin *bin, ut64 addr, int origin) {
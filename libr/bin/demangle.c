@@ -83,15 +83,23 @@ R_API int r_bin_demangle_type(const char *str) {
 	return R_BIN_NM_NONE;
 }
 
+static void demangled_free_kv(HtPPKv *kv) {
+	free (kv->key);
+	free (kv->value);
+}
+
+static char *demangle(RBinFile *binfile, const char *def, const char *str, ut64 vaddr);
+
+/* Symbols, imports, relocs and their flags all ask for the same names
+ * again, so the results are memoized per object. The key is the name
+ * without the reloc./sym./imp. prefixes, the language used to pick the
+ * demangler and the vaddr: the C++ and Rust demanglers register class
+ * methods at that address, so a hit is only taken for a call that would
+ * register the very same method. */
 R_API char *r_bin_demangle(RBinFile *binfile, const char *def, const char *str, ut64 vaddr) {
-	int type = -1;
 	if (!str || !*str) {
 		return NULL;
 	}
-	RBin *bin = binfile? binfile->rbin: NULL;
-	RBinObject *o = binfile? binfile->o: NULL;
-	RListIter *iter;
-	const char *lib;
 	if (!strncmp (str, "reloc.", 6)) {
 		str += 6;
 	}
@@ -101,6 +109,43 @@ R_API char *r_bin_demangle(RBinFile *binfile, const char *def, const char *str,
 	if (!strncmp (str, "imp.", 4)) {
 		str += 4;
 	}
+	// if str is sym. or imp. when str+=4 str points to the end so just return
+	if (!*str) {
+		return NULL;
+	}
+	RBinObject *o = binfile? binfile->o: NULL;
+	if (!o) {
+		return demangle (binfile, def, str, vaddr);
+	}
+	if (!o->demangled) {
+		o->demangled = ht_pp_new (NULL, demangled_free_kv, NULL);
+		if (!o->demangled) {
+			return demangle (binfile, def, str, vaddr);
+		}
+	}
+	const char *lang = (def && *def)? def: (o->info? o->info->lang: NULL);
+	char *key = r_str_newf ("%s:%"PFMT64x":%s", r_str_get (lang), vaddr, str);
+	if (!key) {
+		return NULL;
+	}
+	bool found = false;
+	const char *res = ht_pp_find (o->demangled, key, &found);
+	if (found) {
+		free (key);
+		return res? strdup (res): NULL;
+	}
+	char *dn = demangle (binfile, def, str, vaddr);
+	ht_pp_insert (o->demangled, key, dn? strdup (dn): NULL);
+	free (key);
+	return dn;
+}
+
+static char *demangle(RBinFile *binfile, const char *def, const char *str, ut64 vaddr) {
+	int type = -1;
+	RBin *bin = binfile? binfile->rbin: NULL;
+	RBinObject *o = binfile? binfile->o: NULL;
+	RListIter *iter;
+	const char *lib;
 	if (o) {
 		r_list_foreach (o->libs, iter, lib) {
 			size_t len = strlen (lib);
@@ -121,7 +166,7 @@ R_API char *r_bin_demangle(RBinFile *binfile, const char *def, const char *str,
 		//	str++;
 		}
 	}
-	// if str is sym. or imp. when str+=4 str points to the end so just return
+	// nothing left after the library prefix
 	if (!*str) {
 		return NULL;
 	}
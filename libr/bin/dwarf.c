@@ -390,13 +390,10 @@ beach:
 	return buf;
 }
 
-static inline void add_sdb_addrline(Sdb *s, ut64 addr, const char *file, ut64 line, FILE *f, int mode) {
+static inline void add_addrline(RBinFile *bf, ut64 addr, const char *file, ut64 line, FILE *f, int mode) {
 	const char *p;
-	char *fileline;
-	char offset[64];
-	char *offset_ptr;
 
-	if (!s || !file) {
+	if (!bf || !file) {
 		return;
 	}
 	p = r_str_rchr (file, NULL, '/');
@@ -424,11 +421,10 @@ static inline void add_sdb_addrline(Sdb *s, ut64 addr, const char *file, ut64 li
 #else
 	p = file;
 #endif
-	fileline = r_str_newf ("%s|%"PFMT64d, p, line);
-	offset_ptr = sdb_itoa (addr, offset, 16);
-	sdb_add (s, offset_ptr, fileline, 0);
-	sdb_add (s, fileline, offset_ptr, 0);
-	free (fileline);
+	if (!bf->addrline && !(bf->addrline = r_bin_addrline_new ())) {
+		return;
+	}
+	r_bin_addrline_add (bf->addrline, addr, p, (ut32)line);
 }
 
 static const ut8* r_bin_dwarf_parse_ext_opcode(const RBin *a, const ut8 *obuf,
@@ -462,10 +458,10 @@ static const ut8* r_bin_dwarf_parse_ext_opcode(const RBin *a, const ut8 *obuf,
 	case DW_LNE_end_sequence:
 		regs->end_sequence = DWARF_TRUE;
 
-		if (binfile && binfile->sdb_addrinfo && hdr->file_names) {
+		if (binfile && hdr->file_names) {
 			int fnidx = regs->file - 1;
 			if (fnidx >= 0 && fnidx < hdr->file_names_count) {
-				add_sdb_addrline(binfile->sdb_addrinfo, regs->address,
+				add_addrline (binfile, regs->address,
 						hdr->file_names[fnidx].name, regs->line, f, mode);
 			}
 		}
@@ -545,10 +541,10 @@ static const ut8* r_bin_dwarf_parse_spec_opcode(
 			advance_adr, regs->address, hdr->line_base +
 			(adj_opcode % hdr->line_range), regs->line);
 	}
-	if (binfile && binfile->sdb_addrinfo && hdr->file_names) {
+	if (binfile && hdr->file_names) {
 		int idx = regs->file -1;
 		if (idx >= 0 && idx < hdr->file_names_count) {
-			add_sdb_addrline (binfile->sdb_addrinfo, regs->address,
+			add_addrline (binfile, regs->address,
 					hdr->file_names[idx].name,
 					regs->line, f, mode);
 		}
@@ -582,10 +578,10 @@ static const ut8* r_bin_dwarf_parse_std_opcode(
 		if (f) {
 			fprintf (f, "Copy\n");
 		}
-		if (binfile && binfile->sdb_addrinfo && hdr->file_names) {
+		if (binfile && hdr->file_names) {
 			int fnidx = regs->file - 1;
 			if (fnidx >= 0 && fnidx < hdr->file_names_count) {
-				add_sdb_addrline (binfile->sdb_addrinfo,
+				add_addrline (binfile,
 					regs->address,
 					hdr->file_names[fnidx].name,
 					regs->line, f, mode);
@@ -842,23 +838,6 @@ R_API int r_bin_dwarf_parse_aranges_raw(const ut8 *obuf, int len, FILE *f) {
 	return 0;
 }
 
-static int r_bin_dwarf_init_debug_info(RBinDwarfDebugInfo *inf) {
-	if (!inf) {
-		return -1;
-	}
-	inf->comp_units = calloc (sizeof (RBinDwarfCompUnit), DEBUG_INFO_CAPACITY);
-
-	// XXX - should we be using error codes?
-	if (!inf->comp_units) {
-		return -ENOMEM;
-	}
-
-	inf->capacity = DEBUG_INFO_CAPACITY;
-	inf->length = 0;
-
-	return true;
-}
-
 static int r_bin_dwarf_init_die(RBinDwarfDIE *die) {
 	if (!die) {
 		return -EINVAL;
@@ -1089,17 +1068,6 @@ static void r_bin_dwarf_free_comp_unit(RBinDwarfCompUnit *cu) {
 	R_FREE (cu->dies);
 }
 
-static void r_bin_dwarf_free_debug_info(RBinDwarfDebugInfo *inf) {
-	size_t i;
-	if (!inf) {
-		return;
-	}
-	for (i = 0; i < inf->length; i++) {
-		r_bin_dwarf_free_comp_unit (&inf->comp_units[i]);
-	}
-	R_FREE (inf->comp_units);
-}
-
 static void r_bin_dwarf_dump_attr_value(const RBinDwarfAttrValue *val, FILE *f) {
 	size_t i;
 	if (!val || !f) {
@@ -1160,52 +1128,50 @@ static void r_bin_dwarf_dump_attr_value(const RBinDwarfAttrValue *val, FILE *f)
 	};
 }
 
-static void r_bin_dwarf_dump_debug_info(FILE *f, const RBinDwarfDebugInfo *inf) {
-	size_t i, j, k;
+static void r_bin_dwarf_dump_comp_unit(FILE *f, const RBinDwarfCompUnit *cu) {
+	size_t j, k;
 	RBinDwarfDIE *dies;
 	RBinDwarfAttrValue *values;
-	if (!inf || !f) {
+	if (!cu || !f) {
 		return;
 	}
 
-	for (i = 0; i < inf->length; i++) {
-		fprintf (f, "  Compilation Unit @ offset 0x%"PFMT64x":\n", inf->comp_units [i].offset);
-		fprintf (f, "   Length:        0x%x\n", inf->comp_units [i].hdr.length);
-		fprintf (f, "   Version:       %d\n", inf->comp_units [i].hdr.version);
-		fprintf (f, "   Abbrev Offset: 0x%x\n", inf->comp_units [i].hdr.abbrev_offset);
-		fprintf (f, "   Pointer Size:  %d\n", inf->comp_units [i].hdr.pointer_size);
+	fprintf (f, "  Compilation Unit @ offset 0x%"PFMT64x":\n", cu->offset);
+	fprintf (f, "   Length:        0x%x\n", cu->hdr.length);
+	fprintf (f, "   Version:       %d\n", cu->hdr.version);
+	fprintf (f, "   Abbrev Offset: 0x%x\n", cu->hdr.abbrev_offset);
+	fprintf (f, "   Pointer Size:  %d\n", cu->hdr.pointer_size);
 
-		dies = inf->comp_units[i].dies;
+	dies = cu->dies;
 
-		for (j = 0; j < inf->comp_units[i].length; j++) {
-			fprintf (f, "    Abbrev Number: %"PFMT64u" ", dies[j].abbrev_code);
+	for (j = 0; j < cu->length; j++) {
+		fprintf (f, "    Abbrev Number: %"PFMT64u" ", dies[j].abbrev_code);
 
-			if (dies[j].tag && dies[j].tag <= DW_TAG_volatile_type &&
-				       dwarf_tag_name_encodings[dies[j].tag]) {
-				fprintf (f, "(%s)\n", dwarf_tag_name_encodings[dies[j].tag]);
-			} else {
-				fprintf (f, "(Unknown abbrev tag)\n");
-			}
+		if (dies[j].tag && dies[j].tag <= DW_TAG_volatile_type &&
+			       dwarf_tag_name_encodings[dies[j].tag]) {
+			fprintf (f, "(%s)\n", dwarf_tag_name_encodings[dies[j].tag]);
+		} else {
+			fprintf (f, "(Unknown abbrev tag)\n");
+		}
+
+		if (!dies[j].abbrev_code) {
+			continue;
+		}
+		values = dies[j].attr_values;
 
-			if (!dies[j].abbrev_code) {
+		for (k = 0; k < dies[j].length; k++) {
+			if (!values[k].name) {
 				continue;
 			}
-			values = dies[j].attr_values;
-
-			for (k = 0; k < dies[j].length; k++) {
-				if (!values[k].name) {
-					continue;
-				}
 
-				if (values[k].name < DW_AT_vtable_elem_location &&
-						dwarf_attr_encodings[values[k].name]) {
-					fprintf (f, "     %-18s : ", dwarf_attr_encodings[values[k].name]);
-				} else {
-					fprintf (f, "     TODO\t");
-				}
-				r_bin_dwarf_dump_attr_value (&values[k], f);
-				fprintf (f, "\n");
+			if (values[k].name < DW_AT_vtable_elem_location &&
+					dwarf_attr_encodings[values[k].name]) {
+				fprintf (f, "     %-18s : ", dwarf_attr_encodings[values[k].name]);
+			} else {
+				fprintf (f, "     TODO\t");
 			}
+			r_bin_dwarf_dump_attr_value (&values[k], f);
+			fprintf (f, "\n");
 		}
 	}
 }
@@ -1357,18 +1323,91 @@ static const ut8 *r_bin_dwarf_parse_attr_value(const ut8 *obuf, int obuf_len,
 	return buf;
 }
 
-static const ut8 *r_bin_dwarf_parse_comp_unit(Sdb *s, const ut8 *obuf,
+static RBinDwarfDebugAbbrev *r_bin_dwarf_parse_abbrev_raw(const ut8 *obuf, size_t len, int mode) {
+	const ut8 *buf = obuf, *buf_end = obuf + len;
+	ut64 tmp, spec1, spec2, offset;
+	ut8 has_children;
+	RBinDwarfAbbrevDecl *tmpdecl;
+
+	// XXX - Set a suitable value here.
+	if (!obuf || len < 3) {
+		return NULL;
+	}
+	RBinDwarfDebugAbbrev *da = R_NEW0 (RBinDwarfDebugAbbrev);
+
+	r_bin_dwarf_init_debug_abbrev (da);
+
+	while (buf && buf+1 < buf_end) {
+		offset = buf - obuf;
+		buf = r_uleb128 (buf, (size_t)(buf_end-buf), &tmp);
+		if (!buf || !tmp) {
+			continue;
+		}
+		if (da->length == da->capacity) {
+			r_bin_dwarf_expand_debug_abbrev(da);
+		}
+		tmpdecl = &da->decls[da->length];
+		r_bin_dwarf_init_abbrev_decl (tmpdecl);
+
+		tmpdecl->code = tmp;
+		buf = r_uleb128 (buf, (size_t)(buf_end-buf), &tmp);
+		tmpdecl->tag = tmp;
+
+		tmpdecl->offset = offset;
+		if (buf >= buf_end) {
+			break;
+		}
+		has_children = READ (buf, ut8);
+		tmpdecl->has_children = has_children;
+		do {
+			if (tmpdecl->length == tmpdecl->capacity) {
+				r_bin_dwarf_expand_abbrev_decl (tmpdecl);
+			}
+			buf = r_uleb128 (buf, (size_t)(buf_end - buf), &spec1);
+			buf = r_uleb128 (buf, (size_t)(buf_end - buf), &spec2);
+			tmpdecl->specs[tmpdecl->length].attr_name = spec1;
+			tmpdecl->specs[tmpdecl->length].attr_form = spec2;
+			tmpdecl->length++;
+		} while (spec1 && spec2);
+
+		da->length++;
+	}
+
+	if (mode == R_MODE_PRINT) {
+		dump_r_bin_dwarf_debug_abbrev (stdout, da);
+	}
+	return da;
+}
+
+RBinSection *getsection(RBin *a, const char *sn) {
+	RListIter *iter;
+	RBinSection *section = NULL;
+	RBinFile *binfile = a ? a->cur: NULL;
+	RBinObject *o = binfile ? binfile->o : NULL;
+
+	if ( o && o->sections) {
+		r_list_foreach (o->sections, iter, section) {
+			if (strstr (section->name, sn)) {
+				return section;
+			}
+		}
+	}
+	return NULL;
+}
+
+static const ut8 *r_bin_dwarf_parse_comp_unit(const ut8 *obuf,
 		RBinDwarfCompUnit *cu, const RBinDwarfDebugAbbrev *da,
-		size_t offset, const ut8 *debug_str, size_t debug_str_len) {
+		size_t offset, const ut8 *debug_str, size_t debug_str_len, size_t max_dies) {
 	const ut8 *buf = obuf, *buf_end = obuf + (cu->hdr.length - 7);
 	ut64 abbr_code;
 	size_t i;
-	
-	if (cu->hdr.length > debug_str_len) {
-		//avoid oob read
-		return NULL;
-	}
+
+	// the unit length was checked against .debug_info by index_units,
+	// comparing it with the size of .debug_str rejected most small units
 	while (buf && buf < buf_end && buf >= obuf) {
+		if (max_dies && cu->length >= max_dies) {
+			break;
+		}
 		if (cu->length && cu->capacity == cu->length) {
 			r_bin_dwarf_expand_cu (cu);
 		}
@@ -1385,35 +1424,27 @@ static const ut8 *r_bin_dwarf_parse_comp_unit(Sdb *s, const ut8 *obuf,
 			continue;
 		}
 
-		cu->dies[cu->length].abbrev_code = abbr_code;
-		cu->dies[cu->length].tag = da->decls[abbr_code - 1].tag;
 		abbr_code += offset;
-
-		if (da->capacity < abbr_code) {
+		if (abbr_code > da->length) {
 			return NULL;
 		}
+		const RBinDwarfAbbrevDecl *decl = &da->decls[abbr_code - 1];
+		cu->dies[cu->length].abbrev_code = abbr_code - offset;
+		cu->dies[cu->length].tag = decl->tag;
 
-		for (i = 0; i < da->decls[abbr_code - 1].length; i++) {
+		for (i = 0; i < decl->length; i++) {
 			if (cu->dies[cu->length].length == cu->dies[cu->length].capacity) {
 				r_bin_dwarf_expand_die (&cu->dies[cu->length]);
 			}
-			if (i >= cu->dies[cu->length].capacity || i >= da->decls[abbr_code - 1].capacity) {
+			if (i >= cu->dies[cu->length].capacity || i >= decl->capacity) {
 				eprintf ("Warning: malformed dwarf attribute capacity doesn't match length\n");
 				break;
 			}
 			memset (&cu->dies[cu->length].attr_values[i], 0, sizeof (cu->dies[cu->length].attr_values[i]));
 			buf = r_bin_dwarf_parse_attr_value (buf, buf_end - buf,
-					&da->decls[abbr_code - 1].specs[i],
+					&decl->specs[i],
 					&cu->dies[cu->length].attr_values[i],
 					&cu->hdr, debug_str, debug_str_len);
-			if (cu->dies[cu->length].attr_values[i].name == DW_AT_comp_dir) {
-				const char *name = cu->dies[cu->length].attr_values[i].encoding.str_struct.string;
-				if ((size_t)name > 1024) { // solve some null derefs
-					sdb_set (s, "DW_AT_comp_dir", name, 0);
-				} else {
-					eprintf ("Invalid string pointer at %p\n", name);
-				}
-			}
 			cu->dies[cu->length].length++;
 		}
 		cu->length++;
@@ -1421,207 +1452,483 @@ static const ut8 *r_bin_dwarf_parse_comp_unit(Sdb *s, const ut8 *obuf,
 	return buf;
 }
 
-R_API int r_bin_dwarf_parse_info_raw(Sdb *s, RBinDwarfDebugAbbrev *da,
-		const ut8 *obuf, size_t len,
-		const ut8 *debug_str, size_t debug_str_len, int mode) {
-	const ut8 *buf = obuf, *buf_end = obuf + len;
-	size_t k, offset = 0;
-	int curr_unit = 0;
-	RBinDwarfDebugInfo di = {0};
-	RBinDwarfDebugInfo *inf = &di;
-	bool ret = true;
+/* .debug_info index: unit headers and .debug_aranges are read up front,
+ * DIEs are decoded only for the units that get queried and kept in a
+ * small LRU, unless a full load asks for all of them */
 
-	if (!da || !s || !obuf) {
-		return false;
+static bool index_find_abbrev(const RBinDwarfDebugAbbrev *da, ut64 offset, size_t *idx) {
+	size_t lo = 0, hi = da->length;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (da->decls[mid].offset < offset) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
 	}
-
-	if (r_bin_dwarf_init_debug_info (inf) < 0) {
-		ret = false;
-		goto out;
+	if (lo < da->length && da->decls[lo].offset == offset) {
+		*idx = lo;
+		return true;
 	}
-	while (buf < buf_end) {
-		if (inf->length >= inf->capacity) {
-			break;
-		}
+	return false;
+}
 
-		if (r_bin_dwarf_init_comp_unit (&inf->comp_units[curr_unit]) < 0) {
-			ret = false;
-			curr_unit--;
-			goto out_debug_info;
+static void index_units(RBinDwarfIndex *ix) {
+	const ut8 *buf = ix->info, *buf_end = ix->info + ix->info_len;
+	while (buf + 11 < buf_end) {
+		RBinDwarfUnit u = {{0}};
+		u.offset = buf - ix->info;
+		u.hdr.length = READ32 (buf);
+		u.hdr.version = READ16 (buf);
+		u.hdr.abbrev_offset = READ32 (buf);
+		u.hdr.pointer_size = READ (buf, ut8);
+		if (u.hdr.length < 7 || u.hdr.length > ix->info_len - u.offset - 4) {
+			break;
 		}
-
-		inf->comp_units[curr_unit].offset = buf - obuf;
-		inf->comp_units[curr_unit].hdr.pointer_size = 0;
-		inf->comp_units[curr_unit].hdr.abbrev_offset = 0;
-		inf->comp_units[curr_unit].hdr.length = READ32 (buf);
-		inf->comp_units[curr_unit].hdr.version = READ16 (buf);
-
-		if (inf->comp_units[curr_unit].hdr.version != 2) {
-//			eprintf ("DWARF: version %d is not yet supported.\n",
-//					inf->comp_units[curr_unit].hdr.version);
-			ret = false;
-			goto out_debug_info;
+		if (ix->da) {
+			u.abbrev_found = index_find_abbrev (ix->da, u.hdr.abbrev_offset, &u.abbrev_idx);
 		}
-		if (inf->comp_units[curr_unit].hdr.length > len) {
-			ret = false;
-			goto out_debug_info;
+		if (!r_vector_push (&ix->units, &u)) {
+			break;
 		}
+		buf = ix->info + u.offset + 4 + u.hdr.length;
+	}
+}
 
-		inf->comp_units[curr_unit].hdr.abbrev_offset = READ32 (buf);
-		inf->comp_units[curr_unit].hdr.pointer_size = READ (buf, ut8);
-		inf->length++;
+static int arange_cmp(const void *a, const void *b) {
+	const RBinDwarfARange *ra = a, *rb = b;
+	if (ra->from != rb->from) {
+		return ra->from < rb->from? -1: 1;
+	}
+	return 0;
+}
 
-		/* Linear search FIXME */
-		if (da->decls->length >= da->capacity) {
-			eprintf ("WARNING: malformed dwarf have not enough buckets for decls.\n");
+static void index_aranges(RBinDwarfIndex *ix, const ut8 *obuf, size_t len) {
+	const ut8 *buf = obuf, *buf_end = obuf + len;
+	while (buf + 12 < buf_end) {
+		const ut8 *set = buf;
+		ut32 length = r_read_le32 (buf);
+		if (length < 8 || length > buf_end - set - 4) {
+			break;
 		}
-		const int k_max = R_MIN (da->capacity, da->decls->length);
-		for (k = 0; k < k_max; k++) {
-			if (da->decls[k].offset ==
-				inf->comp_units[curr_unit].hdr.abbrev_offset) {
-				offset = k;
+		const ut8 *set_end = set + 4 + length;
+		ut32 info_offset = r_read_le32 (set + 6);
+		ut8 addr_size = set[10];
+		ut8 seg_size = set[11];
+		size_t tuple = 2 * addr_size;
+		if ((addr_size != 4 && addr_size != 8) || seg_size) {
+			buf = set_end;
+			continue;
+		}
+		// tuples are aligned to their own size from the start of the set
+		buf = set + (R_ROUND (12, tuple));
+		while (buf + tuple <= set_end) {
+			ut64 addr = addr_size == 8? r_read_le64 (buf): r_read_le32 (buf);
+			ut64 size = addr_size == 8? r_read_le64 (buf + 8): r_read_le32 (buf + 4);
+			buf += tuple;
+			if (!addr && !size) {
 				break;
 			}
+			RBinDwarfARange r = { addr, addr + size, info_offset };
+			r_vector_push (&ix->aranges, &r);
 		}
+		buf = set_end;
+	}
+	qsort (ix->aranges.a, ix->aranges.len, sizeof (RBinDwarfARange), arange_cmp);
+}
 
-		buf = r_bin_dwarf_parse_comp_unit (s, buf, &inf->comp_units[curr_unit],
-			da, offset, debug_str, debug_str_len);
-
-		if (!buf) {
-			ret = false;
-			goto out_debug_info;
-		}
+static RBinDwarfCompUnit *index_decode_unit(const RBinDwarfIndex *ix, const RBinDwarfUnit *u, size_t max_dies, bool *broken) {
+	*broken = true;
+	if (u->hdr.version != 2 || !u->abbrev_found) {
+		return NULL;
+	}
+	RBinDwarfCompUnit *cu = R_NEW0 (RBinDwarfCompUnit);
+	if (!cu) {
+		return NULL;
+	}
+	if (r_bin_dwarf_init_comp_unit (cu) < 0) {
+		free (cu);
+		return NULL;
+	}
+	cu->hdr = u->hdr;
+	cu->offset = u->offset;
+	// a partially decoded unit is still kept, like the old eager parser did
+	*broken = !r_bin_dwarf_parse_comp_unit (ix->info + u->offset + 11, cu, ix->da,
+			u->abbrev_idx, ix->str, ix->str_len, max_dies);
+	return cu;
+}
 
-		curr_unit++;
+static void index_unit_free(RBinDwarfUnit *u) {
+	if (u->cu) {
+		r_bin_dwarf_free_comp_unit (u->cu);
+		R_FREE (u->cu);
 	}
+}
 
-	if (mode == R_MODE_PRINT) {
-		r_bin_dwarf_dump_debug_info (NULL, inf);
+static void index_unit_fini(void *e, void *user) {
+	index_unit_free ((RBinDwarfUnit *)e);
+}
+
+static void index_init(RBinDwarfIndex *ix) {
+	r_vector_init (&ix->units, sizeof (RBinDwarfUnit), index_unit_fini, NULL);
+	r_vector_init (&ix->aranges, sizeof (RBinDwarfARange), NULL, NULL);
+	ix->cache_max = R_BIN_DWARF_CU_CACHE;
+}
+
+static void index_fini(RBinDwarfIndex *ix) {
+	r_vector_clear (&ix->units);
+	r_vector_clear (&ix->aranges);
+	if (ix->owned) {
+		free (ix->info);
+		free (ix->str);
+		r_bin_dwarf_free_debug_abbrev (ix->da);
+		free (ix->da);
 	}
+}
 
-out_debug_info:
-	for (; curr_unit >= 0; curr_unit--) {
-		r_bin_dwarf_free_comp_unit (&inf->comp_units[curr_unit]);
+static ut8 *read_section(RBin *a, const char *name, size_t *len) {
+	RBinSection *section = getsection (a, name);
+	RBinFile *binfile = a->cur;
+	*len = 0;
+	if (!section || section->size < 1 || section->size > (UT32_MAX >> 1) || section->size > binfile->size) {
+		return NULL;
 	}
-	r_bin_dwarf_free_debug_info (inf);
-out:
-	return ret;
+	ut8 *buf = calloc (1, section->size + 1);
+	if (!buf) {
+		return NULL;
+	}
+	if (r_buf_read_at (binfile->buf, section->paddr, buf, section->size) < 1) {
+		free (buf);
+		return NULL;
+	}
+	*len = section->size;
+	return buf;
 }
 
-static RBinDwarfDebugAbbrev *r_bin_dwarf_parse_abbrev_raw(const ut8 *obuf, size_t len, int mode) {
-	const ut8 *buf = obuf, *buf_end = obuf + len;
-	ut64 tmp, spec1, spec2, offset;
-	ut8 has_children;
-	RBinDwarfAbbrevDecl *tmpdecl;
+static RBinDwarfDebugAbbrev *abbrev_dup(const RBinDwarfDebugAbbrev *da) {
+	size_t i;
+	RBinDwarfDebugAbbrev *dup = R_NEW0 (RBinDwarfDebugAbbrev);
+	if (!dup) {
+		return NULL;
+	}
+	dup->decls = calloc (R_MAX (da->length, 1), sizeof (RBinDwarfAbbrevDecl));
+	if (!dup->decls) {
+		free (dup);
+		return NULL;
+	}
+	dup->capacity = R_MAX (da->length, 1);
+	for (i = 0; i < da->length; i++) {
+		RBinDwarfAbbrevDecl *d = &dup->decls[i];
+		*d = da->decls[i];
+		d->capacity = d->length;
+		d->specs = d->length? r_mem_dup (da->decls[i].specs, d->length * sizeof (RBinDwarfAttrSpec)): NULL;
+		if (d->length && !d->specs) {
+			r_bin_dwarf_free_debug_abbrev (dup);
+			free (dup);
+			return NULL;
+		}
+		dup->length++;
+	}
+	return dup;
+}
 
-	// XXX - Set a suitable value here.
-	if (!obuf || len < 3) {
+/* da, when given, is copied instead of parsing .debug_abbrev again */
+static RBinDwarfIndex *index_new(RBin *a, const RBinDwarfDebugAbbrev *da) {
+	if (!a->cur) {
 		return NULL;
 	}
-	RBinDwarfDebugAbbrev *da = R_NEW0 (RBinDwarfDebugAbbrev);
+	RBinDwarfIndex *ix = R_NEW0 (RBinDwarfIndex);
+	if (!ix) {
+		return NULL;
+	}
+	index_init (ix);
+	ix->owned = true;
+	ix->info = read_section (a, "debug_info", &ix->info_len);
+	if (!ix->info) {
+		r_bin_dwarf_index_free (ix);
+		return NULL;
+	}
+	ix->str = read_section (a, "debug_str", &ix->str_len);
+	size_t len;
+	ut8 *buf;
+	if (da) {
+		ix->da = abbrev_dup (da);
+	} else {
+		buf = read_section (a, "debug_abbrev", &len);
+		ix->da = r_bin_dwarf_parse_abbrev_raw (buf, len, 0);
+		free (buf);
+	}
+	index_units (ix);
+	buf = read_section (a, "debug_aranges", &len);
+	if (buf) {
+		index_aranges (ix, buf, len);
+		free (buf);
+	}
+	return ix;
+}
 
-	r_bin_dwarf_init_debug_abbrev (da);
+R_API RBinDwarfIndex *r_bin_dwarf_index_new(RBin *a) {
+	r_return_val_if_fail (a, NULL);
+	return index_new (a, NULL);
+}
 
-	while (buf && buf+1 < buf_end) {
-		offset = buf - obuf;
-		buf = r_uleb128 (buf, (size_t)(buf_end-buf), &tmp);
-		if (!buf || !tmp) {
-			continue;
-		}
-		if (da->length == da->capacity) {
-			r_bin_dwarf_expand_debug_abbrev(da);
-		}
-		tmpdecl = &da->decls[da->length];
-		r_bin_dwarf_init_abbrev_decl (tmpdecl);
+R_API void r_bin_dwarf_index_free(RBinDwarfIndex *ix) {
+	if (ix) {
+		index_fini (ix);
+		free (ix);
+	}
+}
 
-		tmpdecl->code = tmp;
-		buf = r_uleb128 (buf, (size_t)(buf_end-buf), &tmp);
-		tmpdecl->tag = tmp;
+R_API size_t r_bin_dwarf_index_count(RBinDwarfIndex *ix) {
+	r_return_val_if_fail (ix, 0);
+	return ix->units.len;
+}
 
-		tmpdecl->offset = offset;
-		if (buf >= buf_end) {
-			break;
+static void index_evict(RBinDwarfIndex *ix, const RBinDwarfUnit *keep) {
+	RBinDwarfUnit *u, *lru = NULL;
+	r_vector_foreach (&ix->units, u) {
+		if (u->cu && u != keep && (!lru || u->used < lru->used)) {
+			lru = u;
 		}
-		has_children = READ (buf, ut8);
-		tmpdecl->has_children = has_children;
-		do {
-			if (tmpdecl->length == tmpdecl->capacity) {
-				r_bin_dwarf_expand_abbrev_decl (tmpdecl);
-			}
-			buf = r_uleb128 (buf, (size_t)(buf_end - buf), &spec1);
-			buf = r_uleb128 (buf, (size_t)(buf_end - buf), &spec2);
-			tmpdecl->specs[tmpdecl->length].attr_name = spec1;
-			tmpdecl->specs[tmpdecl->length].attr_form = spec2;
-			tmpdecl->length++;
-		} while (spec1 && spec2);
-
-		da->length++;
 	}
+	if (lru) {
+		index_unit_free (lru);
+		ix->cached--;
+	}
+}
 
-	if (mode == R_MODE_PRINT) {
-		dump_r_bin_dwarf_debug_abbrev (stdout, da);
+/* the returned unit stays valid until the next query evicts it */
+R_API const RBinDwarfCompUnit *r_bin_dwarf_index_get(RBinDwarfIndex *ix, size_t n) {
+	r_return_val_if_fail (ix, NULL);
+	if (n >= ix->units.len) {
+		return NULL;
 	}
-	return da;
+	RBinDwarfUnit *u = r_vector_index_ptr (&ix->units, n);
+	if (!u->cu) {
+		u->cu = index_decode_unit (ix, u, 0, &u->broken);
+		if (!u->cu) {
+			return NULL;
+		}
+		ix->cached++;
+		if (ix->cache_max && ix->cached > ix->cache_max) {
+			index_evict (ix, u);
+		}
+	}
+	u->used = ++ix->tick;
+	return u->cu;
 }
 
-RBinSection *getsection(RBin *a, const char *sn) {
-	RListIter *iter;
-	RBinSection *section = NULL;
-	RBinFile *binfile = a ? a->cur: NULL;
-	RBinObject *o = binfile ? binfile->o : NULL;
+/* unit covering addr according to .debug_aranges */
+R_API const RBinDwarfCompUnit *r_bin_dwarf_index_at(RBinDwarfIndex *ix, ut64 addr) {
+	r_return_val_if_fail (ix, NULL);
+	RBinDwarfARange *r = ix->aranges.a;
+	size_t lo = 0, hi = ix->aranges.len;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (r[mid].from <= addr) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (!lo || addr >= r[lo - 1].to) {
+		return NULL;
+	}
+	ut64 info_offset = r[lo - 1].info_offset;
+	RBinDwarfUnit *u = ix->units.a;
+	lo = 0;
+	hi = ix->units.len;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (u[mid].offset < info_offset) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (lo < ix->units.len && u[lo].offset == info_offset) {
+		return r_bin_dwarf_index_get (ix, lo);
+	}
+	return NULL;
+}
 
-	if ( o && o->sections) {
-		r_list_foreach (o->sections, iter, section) {
-			if (strstr (section->name, sn)) {
-				return section;
-			}
+/* string value of an attribute of the unit's root DIE, like DW_AT_name
+ * or DW_AT_comp_dir */
+R_API const char *r_bin_dwarf_unit_str(const RBinDwarfCompUnit *cu, ut64 attr) {
+	size_t j;
+	if (!cu || !cu->length) {
+		return NULL;
+	}
+	const RBinDwarfDIE *die = &cu->dies[0];
+	for (j = 0; j < die->length; j++) {
+		const RBinDwarfAttrValue *v = &die->attr_values[j];
+		if (v->name != attr) {
+			continue;
+		}
+		if (v->form == DW_FORM_string || v->form == DW_FORM_strp) {
+			return v->encoding.str_struct.string;
 		}
+		break;
 	}
 	return NULL;
 }
 
-R_API int r_bin_dwarf_parse_info(RBinDwarfDebugAbbrev *da, RBin *a, int mode) {
-	ut8 *buf, *debug_str_buf = 0;
-	int len, debug_str_len = 0, ret;
-	RBinSection *debug_str;
-	RBinSection *section = getsection (a, "debug_info");
-	RBinFile *binfile = a ? a->cur: NULL;
+typedef struct {
+	RBinDwarfIndex *ix;
+	size_t first;
+	size_t step;
+} IndexLoadJob;
 
-	if (binfile && section) {
-		debug_str = getsection (a, "debug_str");
-		if (debug_str) {
-			debug_str_len = debug_str->size;
-			debug_str_buf = calloc (1, debug_str_len + 1);
-			ret = r_buf_read_at (binfile->buf, debug_str->paddr,
-					     debug_str_buf, debug_str_len);
-			if (!ret) {
-				free (debug_str_buf);
-				return false;
+static RThreadFunctionRet index_load_th(RThread *th) {
+	IndexLoadJob *job = th->user;
+	RBinDwarfIndex *ix = job->ix;
+	size_t i;
+	for (i = job->first; i < ix->units.len; i += job->step) {
+		RBinDwarfUnit *u = r_vector_index_ptr (&ix->units, i);
+		if (!u->cu) {
+			u->cu = index_decode_unit (ix, u, 0, &u->broken);
+		}
+	}
+	return R_TH_STOP;
+}
+
+/* decode every unit, splitting them across threads; units only read the
+ * shared section buffers and abbrevs so they can be decoded independently */
+R_API bool r_bin_dwarf_index_load(RBinDwarfIndex *ix, int threads) {
+	r_return_val_if_fail (ix, false);
+	size_t i, n = ix->units.len;
+	if (threads < 1) {
+		threads = 1;
+	}
+	if (threads > n) {
+		threads = R_MAX (n, 1);
+	}
+	IndexLoadJob *jobs = calloc (threads, sizeof (IndexLoadJob));
+	RThread **ths = calloc (threads, sizeof (RThread *));
+	if (!jobs || !ths) {
+		free (jobs);
+		free (ths);
+		return false;
+	}
+	for (i = 0; i < threads; i++) {
+		jobs[i].ix = ix;
+		jobs[i].first = i;
+		jobs[i].step = threads;
+		if (i) {
+			ths[i] = r_th_new (index_load_th, &jobs[i], 0);
+		}
+	}
+	RThread self = { .user = &jobs[0] };
+	index_load_th (&self);
+	for (i = 1; i < threads; i++) {
+		if (ths[i]) {
+			r_th_wait (ths[i]);
+			r_th_free (ths[i]);
+		} else {
+			self.user = &jobs[i];
+			index_load_th (&self);
+		}
+	}
+	free (ths);
+	free (jobs);
+	bool ret = true;
+	RBinDwarfUnit *u;
+	ix->cached = 0;
+	ix->cache_max = 0;
+	r_vector_foreach (&ix->units, u) {
+		if (u->cu) {
+			ix->cached++;
+		}
+		if (u->broken) {
+			ret = false;
+		}
+	}
+	return ret;
+}
+
+static void index_set_comp_dir(Sdb *s, const RBinDwarfCompUnit *cu) {
+	size_t i, j;
+	for (i = 0; i < cu->length; i++) {
+		const RBinDwarfDIE *die = &cu->dies[i];
+		for (j = 0; j < die->length; j++) {
+			if (die->attr_values[j].name == DW_AT_comp_dir) {
+				const char *name = die->attr_values[j].encoding.str_struct.string;
+				if ((size_t)name > 1024) { // solve some null derefs
+					sdb_set (s, "DW_AT_comp_dir", name, 0);
+				} else {
+					eprintf ("Invalid string pointer at %p\n", name);
+				}
 			}
 		}
+	}
+}
 
-		len = section->size;
-		if (len > (UT32_MAX >> 1) || len < 1) {
-			free (debug_str_buf);
-			return false;
+/* only the root DIE of each unit is decoded to pick up DW_AT_comp_dir,
+ * printing decodes everything when there is a dump stream (DBGFD) */
+static bool index_parse_info(Sdb *s, RBinDwarfIndex *ix, int mode) {
+	size_t i;
+	bool ret = true;
+	FILE *f = (mode == R_MODE_PRINT)? DBGFD: NULL;
+	if (f) {
+		ret = r_bin_dwarf_index_load (ix, R_BIN_DWARF_LOAD_THREADS);
+	}
+	for (i = 0; i < ix->units.len; i++) {
+		RBinDwarfUnit *u = r_vector_index_ptr (&ix->units, i);
+		bool broken = false;
+		RBinDwarfCompUnit *root = u->cu? NULL: index_decode_unit (ix, u, 1, &broken);
+		const RBinDwarfCompUnit *cu = u->cu? u->cu: root;
+		if (!cu) {
+			ret = false;
+			continue;
 		}
-		buf = calloc (1, len);
-		if (!buf) {
-			free (debug_str_buf);
-			return false;
+		index_set_comp_dir (s, cu);
+		if (f) {
+			r_bin_dwarf_dump_comp_unit (f, cu);
 		}
-		if (!r_buf_read_at (binfile->buf, section->paddr, buf, len)) {
-			free (debug_str_buf);
-			free (buf);
+		if (root) {
+			if (broken) {
+				ret = false;
+			}
+			r_bin_dwarf_free_comp_unit (root);
+			free (root);
+		}
+	}
+	return ret;
+}
+
+R_API int r_bin_dwarf_parse_info_raw(Sdb *s, RBinDwarfDebugAbbrev *da,
+		const ut8 *obuf, size_t len,
+		const ut8 *debug_str, size_t debug_str_len, int mode) {
+	RBinDwarfIndex ix = {0};
+	if (!da || !s || !obuf) {
+		return false;
+	}
+	index_init (&ix);
+	ix.info = (ut8 *)obuf;
+	ix.info_len = len;
+	ix.str = (ut8 *)debug_str;
+	ix.str_len = debug_str_len;
+	ix.da = da;
+	index_units (&ix);
+	bool ret = index_parse_info (s, &ix, mode);
+	index_fini (&ix);
+	return ret;
+}
+
+/* the index kept in the bin file outlives da, so it takes a copy of it
+ * for the units it decodes later on */
+R_API int r_bin_dwarf_parse_info(RBinDwarfDebugAbbrev *da, RBin *a, int mode) {
+	RBinFile *binfile = a ? a->cur: NULL;
+	if (!binfile || !da) {
+		return false;
+	}
+	if (!binfile->dwarf_index) {
+		binfile->dwarf_index = index_new (a, da);
+		if (!binfile->dwarf_index) {
 			return false;
 		}
-		ret = r_bin_dwarf_parse_info_raw (binfile->sdb_addrinfo, da, buf, len,
-				debug_str_buf, debug_str_len, mode);
-		R_FREE (debug_str_buf);
-		free (buf);
-		return ret;
 	}
-	return false;
+	return index_parse_info (binfile->sdb_addrinfo, binfile->dwarf_index, mode);
 }
 
 static RBinDwarfRow *r_bin_dwarf_row_new(ut64 addr, const char *file, int line, int col) {
@@ -1642,6 +1949,14 @@ static void r_bin_dwarf_row_free(void *p) {
 	free (row);
 }
 
+static bool addrline_row_cb(void *user, const RBinAddrLine *r, const char *file) {
+	RBinDwarfRow *row = r_bin_dwarf_row_new (r->addr, file, r->line, 0);
+	if (row) {
+		r_list_append ((RList *)user, row);
+	}
+	return true;
+}
+
 R_API RList *r_bin_dwarf_parse_line(RBin *a, int mode) {
 	ut8 *buf;
 	RList *list = NULL;
@@ -1668,35 +1983,13 @@ R_API RList *r_bin_dwarf_parse_line(RBin *a, int mode) {
 			return NULL;
 		}
 		list->free = r_bin_dwarf_row_free;
+		// parsing again must not pile up the same rows
+		r_bin_addrline_free (binfile->addrline);
+		binfile->addrline = NULL;
 		r_bin_dwarf_parse_line_raw2 (a, buf, len, mode);
-		// k bin/cur/addrinfo/*
-		SdbListIter *iter;
-		SdbKv *kv;
-		SdbList *ls = sdb_foreach_list (binfile->sdb_addrinfo, false);
-		ls_foreach (ls, iter, kv) {
-			if (!strncmp (sdbkv_key (kv), "0x", 2)) {
-				ut64 addr;
-				RBinDwarfRow *row;
-				int line;
-				char *file = strdup (sdbkv_value (kv));
-				if (!file) {
-					free (buf);
-					ls_free (ls);
-					r_list_free (list);
-					return NULL;
-				}
-				char *tok = strchr (file, '|');
-				if (tok) {
-					*tok++ = 0;
-					line = atoi (tok);
-					addr = r_num_math (NULL, sdbkv_key (kv));
-					row = r_bin_dwarf_row_new (addr, file, line, 0);
-					r_list_append (list, row);
-				}
-				free (file);
-			}
+		if (binfile->addrline) {
+			r_bin_addrline_foreach (binfile->addrline, addrline_row_cb, list);
 		}
-		ls_free (ls);
 		free (buf);
 	}
 	return list;
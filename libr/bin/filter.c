@@ -29,21 +29,55 @@ static char *hashify(char *s, ut64 vaddr) {
 	return os;
 }
 
+#define FNV_PRIME 0x100000001b3ULL
+#define FNV_STEP(h, b) (((h) ^ (ut8)(b)) * FNV_PRIME)
+
+/* 64 bit FNV-1a over a kind byte, the vaddr when there is one and the
+ * name. The kind byte keeps name keys and vaddr+name keys from ever
+ * hashing the same input, whatever the vaddr is, and no "addr.name"
+ * string has to be formatted for every symbol */
+static ut64 filter_hash(const char *s, const ut64 *vaddr) {
+	ut64 h = FNV_STEP (0xcbf29ce484222325ULL, vaddr? 'v': 'n');
+	int i;
+	if (vaddr) {
+		for (i = 0; i < 8; i++) {
+			h = FNV_STEP (h, *vaddr >> (i * 8));
+		}
+	}
+	while (*s) {
+		h = FNV_STEP (h, *s++);
+	}
+	return h;
+}
+
+/* counts one more symbol named like this and tells if the vaddr+name pair
+ * was already there, returns the number of previous symbols with the name */
+static int filter_dedup(HtUU *db, ut64 vaddr, const char *name, bool *dupped) {
+	bool found = false;
+	ut64 hash = filter_hash (name, NULL); // name hash - if dupped and not in unique hash must insert
+	ut64 vhash = filter_hash (name, &vaddr); // vaddr hash - unique
+	HtUUKv *kv = ht_uu_find_kv (db, hash, &found);
+	int count = 1;
+	if (kv) {
+		count = (int)++kv->value;
+	} else {
+		ht_uu_insert (db, hash, 1);
+	}
+	*dupped = !ht_uu_insert (db, vhash, 1);
+	return count;
+}
+
 // - name should be allocated on the heap
-R_API char *r_bin_filter_name(RBinFile *bf, Sdb *db, ut64 vaddr, char *name) {
+R_API char *r_bin_filter_name(RBinFile *bf, HtUU *db, ut64 vaddr, char *name) {
 	r_return_val_if_fail (db && name, NULL);
 
 	char *resname = name;
-	const char *uname = sdb_fmt ("%" PFMT64x ".%s", vaddr, resname);
-	ut32 vhash = sdb_hash (uname); // vaddr hash - unique
-	ut32 hash = sdb_hash (resname); // name hash - if dupped and not in unique hash must insert
-	int count = sdb_num_inc (db, sdb_fmt ("%x", hash), 1, 0);
-
-	if (sdb_exists (db, sdb_fmt ("%x", vhash))) {
+	bool dupped;
+	int count = filter_dedup (db, vaddr, resname, &dupped);
+	if (dupped) {
 		// TODO: symbol is dupped, so symbol can be removed!
 		return resname;
 	}
-	sdb_num_set (db, sdb_fmt ("%x", vhash), 1, 0);
 	if (vaddr) {
 		char *p = hashify (resname, vaddr);
 		if (p) {
@@ -62,15 +96,11 @@ R_API char *r_bin_filter_name(RBinFile *bf, Sdb *db, ut64 vaddr, char *name) {
 	return resname;
 }
 
-R_API void r_bin_filter_sym(RBinFile *bf, Sdb *db, ut64 vaddr, RBinSymbol *sym) {
-	if (!db || !sym || !sym->name) {
-		return;
-	}
+static void filter_sym(RBinFile *bf, HtUU *db, const char *lang, ut64 vaddr, RBinSymbol *sym) {
 	char *name = sym->name;
 	// if (!strncmp (sym->name, "imp.", 4)) {
 	// demangle symbol name depending on the language specs if any
-	if (bf && bf->o && bf->o->lang) {
-		const char *lang = r_bin_lang_tostring (bf->o->lang);
+	if (lang) {
 		char *dn = r_bin_demangle (bf, lang, sym->name, sym->vaddr);
 		if (dn && *dn) {
 			sym->dname = dn;
@@ -94,36 +124,49 @@ R_API void r_bin_filter_sym(RBinFile *bf, Sdb *db, ut64 vaddr, RBinSymbol *sym)
 		}
 	}
 
-	// XXX this is very slow, must be optimized
-	const char *uname = sdb_fmt ("%" PFMT64x ".%s", vaddr, name);
-	ut32 vhash = sdb_hash (uname); // vaddr hash - unique
-	ut32 hash = sdb_hash (name); // name hash - if dupped and not in unique hash must insert
-	int count = sdb_num_inc (db, sdb_fmt ("%x", hash), 1, 0);
-	if (sdb_exists (db, sdb_fmt ("%x", vhash))) {
+	bool dupped;
+	int count = filter_dedup (db, vaddr, name, &dupped);
+	if (dupped) {
 		// TODO: symbol is dupped, so symbol can be removed!
 		return;
 	}
-	sdb_num_set (db, sdb_fmt ("%x", vhash), 1, 0);
 	sym->dup_count = count - 1;
 }
 
+static const char *filter_lang(RBinFile *bf) {
+	return (bf && bf->o && bf->o->lang)? r_bin_lang_tostring (bf->o->lang): NULL;
+}
+
+R_API void r_bin_filter_sym(RBinFile *bf, HtUU *db, ut64 vaddr, RBinSymbol *sym) {
+	if (!db || !sym || !sym->name) {
+		return;
+	}
+	filter_sym (bf, db, filter_lang (bf), vaddr, sym);
+}
+
+/* every symbol adds at most a name key and a vaddr+name key, size the
+ * table for that upfront so the whole list is filtered without rehashing */
 R_API void r_bin_filter_symbols(RBinFile *bf, RList *list) {
-	Sdb *db = sdb_new0 ();
+	HtUU *db = ht_uu_new_size (r_list_length (list) * 2);
 	if (db) {
+		const char *lang = filter_lang (bf);
 		RListIter *iter;
 		RBinSymbol *sym;
 		r_list_foreach (list, iter, sym) {
 			if (sym && sym->name && *sym->name) {
-				r_bin_filter_sym (bf, db, sym->vaddr, sym);
+				filter_sym (bf, db, lang, sym->vaddr, sym);
 			}
 		}
-		sdb_free (db);
+		ht_uu_free (db);
 	}
 }
 
 R_API void r_bin_filter_sections(RBinFile *bf, RList *list) {
 	RBinSection *sec;
-	Sdb *db = sdb_new0 ();
+	HtUU *db = ht_uu_new_size (r_list_length (list) * 2);
+	if (!db) {
+		return;
+	}
 	RListIter *iter;
 	r_list_foreach (list, iter, sec) {
 		char *p = r_bin_filter_name (bf, db, sec->vaddr, sec->name);
@@ -131,7 +174,7 @@ R_API void r_bin_filter_sections(RBinFile *bf, RList *list) {
 			sec->name = p;
 		}
 	}
-	sdb_free (db);
+	ht_uu_free (db);
 }
 
 static bool false_positive(const char *str) {
@@ -38,6 +38,7 @@ static void object_delete_items(RBinObject *o) {
 	ut32 i = 0;
 	r_return_if_fail (o);
 	sdb_free (o->addr2klassmethod);
+	ht_pp_free (o->demangled);
 	r_list_free (o->entries);
 	r_list_free (o->fields);
 	r_list_free (o->imports);
@@ -243,7 +244,10 @@ R_IPI RBinObject *r_bin_object_new(RBinFile *binfile, RBinPlugin *plugin, ut64 b
 }
 
 static void filter_classes(RBinFile *bf, RList *list) {
-	Sdb *db = sdb_new0 ();
+	HtUU *db = ht_uu_new0 ();
+	if (!db) {
+		return;
+	}
 	RListIter *iter, *iter2;
 	RBinClass *cls;
 	RBinSymbol *sym;
@@ -271,7 +275,7 @@ static void filter_classes(RBinFile *bf, RList *list) {
 			eprintf ("Cannot alloc %d byte(s)\n", namepad_len);
 		}
 	}
-	sdb_free (db);
+	ht_uu_free (db);
 }
 
 static RBNode *list2rbtree(RList *relocs) {
@@ -358,7 +362,7 @@ R_API int r_bin_object_set_items(RBinFile *binfile, RBinObject *o) {
 			o->symbols->free = r_bin_symbol_free;
 			REBASE_PADDR (o, o->symbols, RBinSymbol);
 			if (bin->filter) {
-				r_bin_filter_symbols (binfile, o->symbols); // 5s
+				r_bin_filter_symbols (binfile, o->symbols);
 			}
 		}
 	}
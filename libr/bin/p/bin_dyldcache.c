@@ -62,28 +62,53 @@ typedef struct {
 	ut32 entries_size;
 } RDyldRebaseInfo1;
 
+#define DYLD_PAGE_CACHE_SIZE 64
+#define DYLD_IMAGE_CACHE_SIZE 8
+
+typedef struct {
+	ut64 offset; // file offset of the page, UT64_MAX when unused
+	int len;
+	ut8 *data;
+} RDyldRebasedPage;
+
 typedef struct _r_dyldcache {
 	ut8 magic[8];
 	RList *bins;
 	RBuffer *buf;
 	int (*original_io_read)(RIO *io, RIODesc *fd, ut8 *buf, int count);
+	st64 (*original_io_read_at)(RIO *io, RIODesc *fd, ut64 addr, ut8 *buf, ut64 count);
 	RDyldRebaseInfo *rebase_info;
 	cache_hdr_t *hdr;
 	cache_map_t *maps;
 	cache_accel_t *accel;
+	RDyldRebasedPage page_cache[DYLD_PAGE_CACHE_SIZE];
+	RList *parsed; // images holding a parsed mach0, most recently used first
 } RDyldCache;
 
 typedef struct _r_bin_image {
 	char *file;
 	ut64 header_at;
+	// parsed when a plugin callback needs them, only the last
+	// DYLD_IMAGE_CACHE_SIZE images used keep them
+	struct MACH0_(obj_t) *mach0;
+	struct section_t *sections;
 } RDyldBinImage;
 
+static void bin_image_unparse(RDyldBinImage *bin) {
+	R_FREE (bin->sections);
+	if (bin->mach0) {
+		MACH0_(mach0_free) (bin->mach0);
+		bin->mach0 = NULL;
+	}
+}
+
 static void free_bin(RDyldBinImage *bin) {
 	if (!bin) {
 		return;
 	}
 
 	R_FREE (bin->file);
+	bin_image_unparse (bin);
 	R_FREE (bin);
 }
 
@@ -141,6 +166,9 @@ static void r_dyldcache_free(RDyldCache *cache) {
 		return;
 	}
 
+	r_list_free (cache->parsed);
+	cache->parsed = NULL;
+
 	if (cache->bins) {
 		r_list_free (cache->bins);
 		cache->bins = NULL;
@@ -156,6 +184,10 @@ static void r_dyldcache_free(RDyldCache *cache) {
 		cache->rebase_info = NULL;
 	}
 
+	int i;
+	for (i = 0; i < DYLD_PAGE_CACHE_SIZE; i++) {
+		R_FREE (cache->page_cache[i].data);
+	}
 	R_FREE (cache->hdr);
 	R_FREE (cache->maps);
 	R_FREE (cache->accel);
@@ -215,11 +247,49 @@ static struct MACH0_(obj_t) *bin_to_mach0(RBinFile *bf, RDyldBinImage *bin) {
 	MACH0_(opts_set_default) (&opts, bf);
 	opts.header_at = bin->header_at;
 	struct MACH0_(obj_t) *mach0 = MACH0_(new_buf) (cache->buf, &opts);
+	if (!mach0) {
+		return NULL;
+	}
 	mach0->user = cache;
 	mach0->va2pa = &bin_obj_va2pa;
 	return mach0;
 }
 
+/* the returned mach0 and its sections stay valid until another
+ * DYLD_IMAGE_CACHE_SIZE images have been parsed */
+static struct MACH0_(obj_t) *bin_image_mach0(RBinFile *bf, RDyldBinImage *bin) {
+	RDyldCache *cache = (RDyldCache*) bf->o->bin_obj;
+	if (!cache->parsed && !(cache->parsed = r_list_new ())) {
+		return NULL;
+	}
+	if (bin->mach0) {
+		if (r_list_first (cache->parsed) != bin) {
+			r_list_delete_data (cache->parsed, bin);
+			r_list_prepend (cache->parsed, bin);
+		}
+		return bin->mach0;
+	}
+	bin->mach0 = bin_to_mach0 (bf, bin);
+	if (!bin->mach0 || !r_list_prepend (cache->parsed, bin)) {
+		bin_image_unparse (bin);
+		return NULL;
+	}
+	if (r_list_length (cache->parsed) > DYLD_IMAGE_CACHE_SIZE) {
+		bin_image_unparse (r_list_pop (cache->parsed));
+	}
+	return bin->mach0;
+}
+
+static struct section_t *bin_image_sections(RBinFile *bf, RDyldBinImage *bin) {
+	if (!bin->sections) {
+		struct MACH0_(obj_t) *mach0 = bin_image_mach0 (bf, bin);
+		if (mach0) {
+			bin->sections = MACH0_(get_sections) (mach0);
+		}
+	}
+	return bin->sections;
+}
+
 static int prot2perm(int x) {
 	int r = 0;
 	if (x & 1) {
@@ -635,8 +705,78 @@ static char *get_lib_name(RBuffer *cache_buf, cache_img_t *img) {
 	return strdup ("FAIL");
 }
 
-static int string_contains(const void *a, const void *b) {
-	return !strstr ((const char*) a, (const char*) b);
+/* looks up an install path in the cache's own dylib trie, which maps every
+ * image path (and alias) to its index without reading the image table */
+static int dylib_trie_lookup(RBuffer *cache_buf, cache_accel_t *accel, const char *path) {
+	if (!accel || !accel->dylibTrieOffset || !accel->dylibTrieSize) {
+		return -1;
+	}
+	ut8 *trie = malloc (accel->dylibTrieSize);
+	if (!trie) {
+		return -1;
+	}
+	if (r_buf_read_at (cache_buf, accel->dylibTrieOffset, trie, accel->dylibTrieSize) != accel->dylibTrieSize) {
+		free (trie);
+		return -1;
+	}
+	const ut8 *end = trie + accel->dylibTrieSize;
+	const ut8 *p = trie;
+	int res = -1;
+	while (p && p < end) {
+		ut64 terminal_size, index;
+		p = r_uleb128 (p, end - p, &terminal_size);
+		if (!p || terminal_size > end - p) {
+			break;
+		}
+		if (!*path) {
+			if (terminal_size && r_uleb128 (p, end - p, &index)) {
+				res = (int)index;
+			}
+			break;
+		}
+		const ut8 *child = p + terminal_size;
+		if (child >= end) {
+			break;
+		}
+		ut8 i, children = *child++;
+		p = NULL;
+		for (i = 0; i < children && child < end; i++) {
+			size_t len = r_str_nlen ((const char *)child, end - child);
+			const char *edge = (const char *)child;
+			ut64 next;
+			child = r_uleb128 (child + len + 1, end - child - len - 1, &next);
+			if (!child || next >= accel->dylibTrieSize) {
+				break;
+			}
+			if (len && !strncmp (path, edge, len)) {
+				path += len;
+				p = trie + next;
+				break;
+			}
+		}
+	}
+	free (trie);
+	return res;
+}
+
+static void mark_image_deps(RBuffer *cache_buf, cache_img_t *img, int *deps, ut16 *depArray, cache_imgxtr_t *extras, int i) {
+	char *lib_name = get_lib_name (cache_buf, &img[i]);
+	eprintf ("FILTER: %s\n", lib_name);
+	R_FREE (lib_name);
+	deps[i]++;
+
+	ut32 j;
+	for (j = extras[i].dependentsStartArrayIndex; depArray[j] != 0xffff; j++) {
+		bool upward = depArray[j] & 0x8000;
+		ut16 dep_index = depArray[j] & 0x7fff;
+		if (!upward) {
+			deps[dep_index]++;
+
+			char *dep_name = get_lib_name (cache_buf, &img[dep_index]);
+			eprintf ("-> %s\n", dep_name);
+			R_FREE (dep_name);
+		}
+	}
 }
 
 static RList *create_cache_bins(RBinFile *bf, RBuffer *cache_buf, cache_hdr_t *hdr, cache_map_t *maps, cache_accel_t *accel) {
@@ -704,27 +844,29 @@ static RList *create_cache_bins(RBinFile *bf, RBuffer *cache_buf, cache_hdr_t *h
 			return NULL;
 		}
 
-		for (i = 0; i < hdr->imagesCount; i++) {
+		// full install paths are resolved through the trie, anything else
+		// is matched as a substring of every image path like before
+		RListIter *it, *tmp;
+		char *target;
+		r_list_foreach_safe (target_lib_names, it, tmp, target) {
+			int idx = dylib_trie_lookup (cache_buf, accel, target);
+			if (idx >= 0 && idx < hdr->imagesCount) {
+				mark_image_deps (cache_buf, img, deps, depArray, extras, idx);
+				r_list_delete (target_lib_names, it);
+			}
+		}
+		for (i = 0; !r_list_empty (target_lib_names) && i < hdr->imagesCount; i++) {
 			char *lib_name = get_lib_name (cache_buf, &img[i]);
-			if (!r_list_find (target_lib_names, lib_name, string_contains)) {
-				R_FREE (lib_name);
-				continue;
+			bool match = false;
+			r_list_foreach (target_lib_names, it, target) {
+				if (strstr (lib_name, target)) {
+					match = true;
+					break;
+				}
 			}
-			eprintf ("FILTER: %s\n", lib_name);
 			R_FREE (lib_name);
-			deps[i]++;
-
-			ut32 j;
-			for (j = extras[i].dependentsStartArrayIndex; depArray[j] != 0xffff; j++) {
-				bool upward = depArray[j] & 0x8000;
-				ut16 dep_index = depArray[j] & 0x7fff;
-				if (!upward) {
-					deps[dep_index]++;
-
-					char *dep_name = get_lib_name (cache_buf, &img[dep_index]);
-					eprintf ("-> %s\n", dep_name);
-					R_FREE (dep_name);
-				}
+			if (match) {
+				mark_image_deps (cache_buf, img, deps, depArray, extras, i);
 			}
 		}
 
@@ -940,91 +1082,170 @@ static void rebase_bytes(RDyldRebaseInfo *rebase_info, ut8 *buf, ut64 offset, in
 	}
 }
 
-static int dyldcache_io_read(RIO *io, RIODesc *fd, ut8 *buf, int count) {
-	if (!io) {
-		return -1;
+/* reads from the original plugin, positionally when it can */
+static int original_read(RDyldCache *cache, RIO *io, RIODesc *fd, ut64 off, ut8 *buf, int count) {
+	if (cache->original_io_read_at) {
+		return (int)cache->original_io_read_at (io, fd, off, buf, count);
 	}
-	RCore *core = (RCore*) io->user;
+	ut64 original_off = io->off;
+	io->off = off;
+	int len = cache->original_io_read (io, fd, buf, count);
+	io->off = original_off;
+	return len;
+}
 
-	if (!core || !core->bin || !core->bin->binfiles) {
-		return -1;
+/* slide info is decoded once per page, rebased pages are kept in a small
+ * direct mapped cache so that reading the same pages again is a memcpy */
+static RDyldRebasedPage *rebased_page(RDyldCache *cache, RIO *io, RIODesc *fd, ut64 page_off) {
+	RDyldRebaseInfo *rebase_info = cache->rebase_info;
+	RDyldRebasedPage *page = &cache->page_cache[(page_off / rebase_info->page_size) % DYLD_PAGE_CACHE_SIZE];
+	if (page->data && page->offset == page_off) {
+		return page;
+	}
+	if (!page->data) {
+		page->data = malloc (rebase_info->page_size);
+		if (!page->data) {
+			return NULL;
+		}
 	}
+	int len = original_read (cache, io, fd, page_off, page->data, rebase_info->page_size);
+	if (len < 1) {
+		page->offset = UT64_MAX;
+		return NULL;
+	}
+	rebase_bytes (rebase_info, page->data, page_off, len, 0);
+	page->offset = page_off;
+	page->len = len;
+	return page;
+}
 
-	RDyldCache *cache = NULL;
+static RDyldCache *cache_for_desc(RIO *io, RIODesc *fd) {
+	RCore *core = (RCore*) io->user;
 	RListIter *iter;
 	RBinFile *bf;
+	if (!core || !core->bin || !core->bin->binfiles) {
+		return NULL;
+	}
 	r_list_foreach (core->bin->binfiles, iter, bf) {
-		if (bf->fd == fd->fd ) {
+		if (bf->fd == fd->fd && bf->o && bf->o->bin_obj) {
 			if (!strncmp ((char*) bf->o->bin_obj, "dyldcac", 7)) {
-				cache = bf->o->bin_obj;
-			} else {
-				cache = ((struct MACH0_(obj_t)*) bf->o->bin_obj)->user;
+				return bf->o->bin_obj;
 			}
-			break;
+			return ((struct MACH0_(obj_t)*) bf->o->bin_obj)->user;
 		}
 	}
-	if (!cache || !cache->original_io_read) {
-		return fd->plugin->read (io, fd, buf, count);
+	return NULL;
+}
+
+/* the plugin callbacks are shared by every desc, descs not backed by a
+ * cache go to the callbacks saved by any of the swizzling caches */
+static RDyldCache *any_swizzled_cache(RIO *io) {
+	RCore *core = (RCore*) io->user;
+	RListIter *iter;
+	RBinFile *bf;
+	if (!core || !core->bin || !core->bin->binfiles) {
+		return NULL;
 	}
+	r_list_foreach (core->bin->binfiles, iter, bf) {
+		if (bf->o && bf->o->plugin && bf->o->bin_obj && !strcmp (bf->o->plugin->name, "dyldcache")) {
+			RDyldCache *cache = bf->o->bin_obj;
+			if (cache->original_io_read) {
+				return cache;
+			}
+		}
+	}
+	return NULL;
+}
 
-	bool includes_data = io->off > cache->rebase_info->start_of_data ||
-		(io->off + count) > cache->rebase_info->start_of_data;
+static int dyldcache_read(RDyldCache *cache, RIO *io, RIODesc *fd, ut64 off, ut8 *buf, int count) {
+	bool includes_data = off > cache->rebase_info->start_of_data ||
+		(off + count) > cache->rebase_info->start_of_data;
 
 	int result = 0;
 
 	if (includes_data && count > 0) {
-		RDyldRebaseInfo *rebase_info = cache->rebase_info;
-
-		ut64 offset_in_data = io->off - rebase_info->start_of_data;
-		ut64 page_offset = offset_in_data % rebase_info->page_size;
-
-		ut64 internal_offset = io->off & ~(rebase_info->page_size - 1);
-		ut64 internal_end = io->off + count;
-		int rounded_count = internal_end - internal_offset;
-
-		ut8 *internal_buf = rebase_info->one_page_buf;
-		if (rounded_count > rebase_info->page_size) {
-			internal_buf = malloc (rounded_count);
-			if (!internal_buf) {
-				eprintf ("Cannot allocate memory for 'internal_buf'\n");
-				return -1;
+		ut32 page_size = cache->rebase_info->page_size;
+		ut64 at = off;
+		while (result < count) {
+			ut64 page_off = at & ~((ut64)page_size - 1);
+			RDyldRebasedPage *page = rebased_page (cache, io, fd, page_off);
+			if (!page || at - page_off >= page->len) {
+				break;
 			}
+			int n = R_MIN (count - result, page->len - (int)(at - page_off));
+			memcpy (buf + result, page->data + (at - page_off), n);
+			result += n;
+			at += n;
 		}
-
-		ut64 original_off = io->off;
-		io->off = internal_offset;
-
-		int internal_result = cache->original_io_read (io, fd, internal_buf, rounded_count);
-
-		io->off = original_off;
-
-		if (internal_result >= page_offset + count) {
-			rebase_bytes (cache->rebase_info, internal_buf, internal_offset, internal_result, page_offset);
-			result = R_MIN (count, internal_result);
-			memcpy (buf, internal_buf + page_offset, result);
-		} else {
+		if (!result) {
 			eprintf ("ERROR rebasing\n");
-			result = cache->original_io_read (io, fd, buf, count);
-		}
-
-		if (internal_buf != rebase_info->one_page_buf) {
-			R_FREE (internal_buf);
+			result = original_read (cache, io, fd, off, buf, count);
 		}
 	} else {
-		result = cache->original_io_read (io, fd, buf, count);
+		result = original_read (cache, io, fd, off, buf, count);
 	}
 
 	return result;
 }
 
+static int dyldcache_io_read(RIO *io, RIODesc *fd, ut8 *buf, int count) {
+	if (!io || !fd) {
+		return -1;
+	}
+	RDyldCache *cache = cache_for_desc (io, fd);
+	if (!cache || !cache->original_io_read) {
+		cache = any_swizzled_cache (io);
+		return cache? cache->original_io_read (io, fd, buf, count): -1;
+	}
+	return dyldcache_read (cache, io, fd, io->off, buf, count);
+}
+
+static st64 dyldcache_io_read_at(RIO *io, RIODesc *fd, ut64 addr, ut8 *buf, ut64 count) {
+	if (!io || !fd) {
+		return -1;
+	}
+	RDyldCache *cache = cache_for_desc (io, fd);
+	if (!cache || !cache->original_io_read_at) {
+		cache = any_swizzled_cache (io);
+		return (cache && cache->original_io_read_at)? cache->original_io_read_at (io, fd, addr, buf, count): -1;
+	}
+	st64 done = 0;
+	while (done < count) {
+		int chunk = (int)R_MIN (count - done, ST32_MAX);
+		int ret = dyldcache_read (cache, io, fd, addr + done, buf + done, chunk);
+		if (ret < 1) {
+			return done? done: ret;
+		}
+		done += ret;
+		if (ret < chunk) {
+			break;
+		}
+	}
+	return done;
+}
+
+/* the positional and the seek based reads both go through the rebasing */
 static void swizzle_io_read(RDyldCache *cache, RIO *io) {
 	if (!io || !io->desc || !io->desc->plugin) {
 		return;
 	}
 
 	RIOPlugin *plugin = io->desc->plugin;
+	if (plugin->read == &dyldcache_io_read) {
+		// another cache got here first, share the callbacks it saved
+		RDyldCache *other = any_swizzled_cache (io);
+		if (other) {
+			cache->original_io_read = other->original_io_read;
+			cache->original_io_read_at = other->original_io_read_at;
+		}
+		return;
+	}
 	cache->original_io_read = plugin->read;
+	cache->original_io_read_at = plugin->read_at;
 	plugin->read = &dyldcache_io_read;
+	if (plugin->read_at) {
+		plugin->read_at = &dyldcache_io_read_at;
+	}
 }
 
 static cache_hdr_t *read_cache_header(RBuffer *cache_buf) {
@@ -1213,7 +1434,7 @@ static ut64 baddr(RBinFile *bf) {
 }
 
 void symbols_from_bin(RList *ret, RBinFile *bf, RDyldBinImage *bin) {
-	struct MACH0_(obj_t) *mach0 = bin_to_mach0 (bf, bin);
+	struct MACH0_(obj_t) *mach0 = bin_image_mach0 (bf, bin);
 	if (!mach0) {
 		return;
 	}
@@ -1265,7 +1486,6 @@ void symbols_from_bin(RList *ret, RBinFile *bf, RDyldBinImage *bin) {
 		r_list_append (ret, sym);
 	}
 	free (symbols);
-	MACH0_(mach0_free) (mach0);
 }
 
 static void handle_data_sections(RBinSection *sect) {
@@ -1283,13 +1503,8 @@ static void handle_data_sections(RBinSection *sect) {
 }
 
 static void sections_from_bin(RList *ret, RBinFile *bf, RDyldBinImage *bin) {
-	struct MACH0_(obj_t) *mach0 = bin_to_mach0 (bf, bin);
-	if (!mach0) {
-		return;
-	}
-
-	struct section_t *sections = NULL;
-	if (!(sections = MACH0_(get_sections) (mach0))) {
+	struct section_t *sections = bin_image_sections (bf, bin);
+	if (!sections) {
 		return;
 	}
 
@@ -1320,8 +1535,6 @@ static void sections_from_bin(RList *ret, RBinFile *bf, RDyldBinImage *bin) {
 		ptr->perm = sections[i].perm;
 		r_list_append (ret, ptr);
 	}
-	free (sections);
-	MACH0_(mach0_free) (mach0);
 }
 
 static RList *sections(RBinFile *bf) {
@@ -1401,7 +1614,9 @@ static RList *symbols(RBinFile *bf) {
 
 	RIOPlugin *plugin = io->desc->plugin;
 	plugin->read = cache->original_io_read;
+	plugin->read_at = cache->original_io_read_at;
 	cache->original_io_read = NULL;
+	cache->original_io_read_at = NULL;
 } */
 
 static int destroy(RBinFile *bf) {
@@ -1428,14 +1643,13 @@ static RList *classes(RBinFile *bf) {
 	RBuffer *orig_buf = bf->buf;
 	ut32 num_of_unnamed_class = 0;
 	r_list_foreach (cache->bins, iter, bin) {
-		struct MACH0_(obj_t) *mach0 = bin_to_mach0 (bf, bin);
+		struct MACH0_(obj_t) *mach0 = bin_image_mach0 (bf, bin);
 		if (!mach0) {
 			goto beach;
 		}
 
-		struct section_t *sections = NULL;
-		if (!(sections = MACH0_(get_sections) (mach0))) {
-			MACH0_(mach0_free) (mach0);
+		struct section_t *sections = bin_image_sections (bf, bin);
+		if (!sections) {
 			goto beach;
 		}
 
@@ -1469,8 +1683,6 @@ static RList *classes(RBinFile *bf) {
 					!(klass->fields = r_list_new ())) {
 					R_FREE (klass);
 					R_FREE (pointers);
-					R_FREE (sections);
-					MACH0_(mach0_free) (mach0);
 					goto beach;
 				}
 
@@ -1489,8 +1701,6 @@ static RList *classes(RBinFile *bf) {
 					if (!klass->name) {
 						R_FREE (klass);
 						R_FREE (pointers);
-						R_FREE (sections);
-						MACH0_(mach0_free) (mach0);
 						goto beach;
 					}
 					num_of_unnamed_class++;
@@ -1500,9 +1710,6 @@ static RList *classes(RBinFile *bf) {
 
 			R_FREE (pointers);
 		}
-
-		R_FREE (sections);
-		MACH0_(mach0_free) (mach0);
 	}
 
 	return ret;
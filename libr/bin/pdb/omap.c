@@ -27,6 +27,8 @@ void parse_omap_stream(void *stream, R_STREAM_FILE *stream_file) {
 
 	omap_stream = (SOmapStream *) stream;
 	omap_stream->froms = 0;
+	omap_stream->entries = 0;
+	omap_stream->entries_count = 0;
 	omap_stream->omap_entries = r_list_new();
 	ptmp = data;
 	while (read_bytes < data_size) {
@@ -55,6 +57,8 @@ void free_omap_stream(void *stream) {
 		free (omap_entry);
 	}
 	r_list_free (omap_stream->omap_entries);
+	R_FREE (omap_stream->froms);
+	R_FREE (omap_stream->entries);
 }
 
 // inclusive indices
@@ -98,23 +102,29 @@ int omap_remap(void *stream, int address) {
 		return address;
 	}
 
-	len = r_list_length (omap_stream->omap_entries);
-
 	if (omap_stream->froms == 0) {
+		len = r_list_length (omap_stream->omap_entries);
 		omap_stream->froms = (unsigned int *) malloc (4 * len);
-		if (!omap_stream->froms) {
+		omap_stream->entries = (SOmapEntry **) malloc (sizeof (SOmapEntry *) * len);
+		if (!omap_stream->froms || !omap_stream->entries) {
+			R_FREE (omap_stream->froms);
+			R_FREE (omap_stream->entries);
 			return -1;
 		}
 		it = r_list_iterator (omap_stream->omap_entries);
 		while (r_list_iter_next (it)) {
 			omap_entry = (SOmapEntry *) r_list_iter_get (it);
 			omap_stream->froms[i] = omap_entry->from;
+			omap_stream->entries[i] = omap_entry;
 			i++;
 		}
+		omap_stream->entries_count = len;
 	}
-
-	// mb (len -1) ???
-	pos = binary_search (omap_stream->froms, address, 0, (len));
+	len = omap_stream->entries_count;
+	if (len < 1) {
+		return -1;
+	}
+	pos = binary_search (omap_stream->froms, address, 0, len - 1);
 
 	if (pos == -1) {
 		return -1;
@@ -123,7 +133,7 @@ int omap_remap(void *stream, int address) {
 	if (omap_stream->froms[pos] != address) {
 		pos -= 1;
 	}
-	omap_entry = (SOmapEntry *) r_list_get_n (omap_stream->omap_entries, pos);
+	omap_entry = (pos >= 0 && pos < len)? omap_stream->entries[pos]: NULL;
 	if (!omap_entry) {
 		return -1;
 	}
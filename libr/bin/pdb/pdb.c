@@ -319,6 +319,20 @@ static void find_indx_in_list(RList *l, int index, SStreamParseFunc **res) {
 	}
 }
 
+typedef struct {
+	STpiStream *tpi_stream;
+	R_STREAM_FILE stream_file;
+	bool ok;
+} STpiParseJob;
+
+// the type stream is the largest one and nothing else reads it while the
+// other streams are being parsed, so it gets a thread of its own
+static RThreadFunctionRet tpi_parse_th(RThread *th) {
+	STpiParseJob *job = th->user;
+	job->ok = parse_tpi_stream (job->tpi_stream, &job->stream_file);
+	return R_TH_STOP;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 static int pdb_read_root(R_PDB *pdb) {
 	int i = 0;
@@ -331,6 +345,9 @@ static int pdb_read_root(R_PDB *pdb) {
 	RListIter *it;
 	SPage *page = 0;
 	SStreamParseFunc *stream_parse_func = 0;
+	STpiParseJob tpi_job = {0};
+	RThread *tpi_th = NULL;
+	int ret = 1;
 
 	it = r_list_iterator (root_stream->streams_list);
 	while (r_list_iter_next (it)) {
@@ -362,9 +379,11 @@ static int pdb_read_root(R_PDB *pdb) {
 				return 0;
 			}
 			init_tpi_stream (tpi_stream);
-			if (!parse_tpi_stream (tpi_stream, &stream_file)) {
-				free (tpi_stream);
-				return 0;
+			tpi_job.tpi_stream = tpi_stream;
+			tpi_job.stream_file = stream_file;
+			tpi_th = r_th_new (tpi_parse_th, &tpi_job, 0);
+			if (!tpi_th) {
+				tpi_job.ok = parse_tpi_stream (tpi_stream, &tpi_job.stream_file);
 			}
 			r_list_append (pList, tpi_stream);
 			break;
@@ -372,7 +391,8 @@ static int pdb_read_root(R_PDB *pdb) {
 		{
 			SDbiStream *dbi_stream = R_NEW0 (SDbiStream);
 			if (!dbi_stream) {
-				return 0;
+				ret = 0;
+				break;
 			}
 			init_dbi_stream (dbi_stream);
 			parse_dbi_stream (dbi_stream, &stream_file);
@@ -390,7 +410,8 @@ static int pdb_read_root(R_PDB *pdb) {
 
 			pdb_stream = R_NEW0 (R_PDB_STREAM);
 			if (!pdb_stream) {
-				return 0;
+				ret = 0;
+				break;
 			}
 			init_r_pdb_stream (pdb_stream, pdb->buf, (int *) page->stream_pages,
 				root_stream->pdb_stream.pages_amount, i,
@@ -398,12 +419,23 @@ static int pdb_read_root(R_PDB *pdb) {
 			r_list_append (pList, pdb_stream);
 			break;
 		}
-		if (stream_file.error) {
-			return 0;
+		if (!ret || stream_file.error) {
+			ret = 0;
+			break;
 		}
 		i++;
 	}
-	return 1;
+	if (tpi_th) {
+		r_th_wait (tpi_th);
+		r_th_free (tpi_th);
+	}
+	if (tpi_stream && !tpi_job.ok) {
+		ret = 0;
+	}
+	if (tpi_job.stream_file.error) {
+		ret = 0;
+	}
+	return ret;
 }
 
 static bool pdb7_parse(R_PDB *pdb) {
@@ -1176,7 +1208,11 @@ R_API bool init_pdb_parser(R_PDB *pdb, const char *filename) {
 	if (!pdb->cb_printf) {
 		pdb->cb_printf = (PrintfCallback) printf;
 	}
-	pdb->buf = r_buf_new_slurp (filename);
+	// streams are read page by page, map the file instead of slurping it
+	pdb->buf = r_buf_mmap (filename, R_PERM_R);
+	if (!pdb->buf) {
+		pdb->buf = r_buf_new_slurp (filename);
+	}
 	if (!pdb->buf) {
 		eprintf ("File reading error/empty file\n");
 		goto error;
@@ -21,52 +21,54 @@ int init_r_stream_file(R_STREAM_FILE *stream_file, RBuffer *buf, int *pages, int
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-static void stream_file_read_pages(R_STREAM_FILE *stream_file, int start_indx, int end_indx, char *res) {
-	int i, page_offset;
+/// copies len bytes at stream offset pos straight from the backing buffer,
+/// with one read per run of pages that are consecutive in the file
+static void stream_file_read_at(R_STREAM_FILE *stream_file, int pos, int len, char *res) {
+	int page_size = stream_file->page_size;
+	int pn_start = pos / page_size;
+	int pn_end = (pos + len) / page_size;
 
-	if ((end_indx - start_indx) > stream_file->end) {
+	if ((pn_end + 1 - pn_start) > stream_file->end) {
 		stream_file->error = READ_PAGE_FAIL;
+		memset (res, 0, len);
 		return;
 	}
-	end_indx = R_MIN (end_indx, stream_file->pages_amount);
-
-	for (i = start_indx; i < end_indx; i++) {
-		page_offset = stream_file->pages[i] * stream_file->page_size;
-		if (page_offset < 1) {
-			return;
+	while (len > 0) {
+		int pn, off, chunk;
+		GET_PAGE (pn, off, pos, page_size);
+		if (pn >= stream_file->pages_amount || stream_file->pages[pn] < 1) {
+			break;
+		}
+		ut64 page_offset = (ut64)stream_file->pages[pn] * page_size;
+		chunk = page_size - off;
+		while (chunk < len && pn + 1 < stream_file->pages_amount
+				&& stream_file->pages[pn + 1] == stream_file->pages[pn] + 1) {
+			chunk += page_size;
+			pn++;
 		}
-		stream_file->buf->cur = page_offset;
-		r_buf_read_at (stream_file->buf, page_offset,
-			(ut8*)res, stream_file->page_size);
-		res += stream_file->page_size;
+		chunk = R_MIN (chunk, len);
+		r_buf_read_at (stream_file->buf, page_offset + off, (ut8 *)res, chunk);
+		res += chunk;
+		pos += chunk;
+		len -= chunk;
+	}
+	if (len > 0) {
+		memset (res, 0, len);
 	}
 }
 
 // size by default = -1
 ///////////////////////////////////////////////////////////////////////////////
 void stream_file_read(R_STREAM_FILE *stream_file, int size, char *res) {
-	int pn_start, off_start, pn_end, off_end;
 	if (size == -1) {
-		char *pdata = (char *) malloc(stream_file->pages_amount * stream_file->page_size);
-		if (pdata) {
-			GET_PAGE(pn_start, off_start, stream_file->pos, stream_file->page_size);
-			(void)off_end; // hack to remove unused warning
-			stream_file_read_pages (stream_file, 0, stream_file->pages_amount, pdata);
-			stream_file->pos = stream_file->end;
-			memcpy (res, pdata + off_start, stream_file->end - off_start);
-			free (pdata);
-		}
+		int pn_start, off_start;
+		GET_PAGE (pn_start, off_start, stream_file->pos, stream_file->page_size);
+		(void)pn_start; // hack to remove unused warning
+		stream_file_read_at (stream_file, off_start, stream_file->end - off_start, res);
+		stream_file->pos = stream_file->end;
 	} else {
-		GET_PAGE(pn_start, off_start, stream_file->pos, stream_file->page_size);
-		GET_PAGE(pn_end, off_end, stream_file->pos + size, stream_file->page_size);
-		(void)off_end; // hack to remove unused warning
-		char *pdata = (char *) calloc(stream_file->page_size * (pn_end + 1 - pn_start), 1);
-		if (pdata) {
-			stream_file_read_pages(stream_file, pn_start, pn_end + 1, pdata);
-			stream_file->pos += size;
-			memcpy(res, pdata + off_start, size);
-			free (pdata);
-		}
+		stream_file_read_at (stream_file, stream_file->pos, size, res);
+		stream_file->pos += size;
 	}
 }
 
@@ -4,6 +4,11 @@
 
 static unsigned int base_idx = 0;
 static RList *p_types_list;
+static RPVector p_types_index; // p_types_list by (tpi_idx - base_idx)
+
+static SType *get_stype(unsigned int idx) {
+	return idx < r_pvector_len (&p_types_index)? r_pvector_at (&p_types_index, idx): NULL;
+}
 
 static void print_base_type(EBASE_TYPES base_type, char **name) {
 	switch (base_type) {
@@ -236,7 +241,7 @@ static int get_array_element_type(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -252,7 +257,7 @@ static int get_array_index_type(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -268,7 +273,7 @@ static int get_bitfield_base_type(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -284,7 +289,7 @@ static int get_class_struct_derived(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -300,7 +305,7 @@ static int get_class_struct_vshape(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -316,7 +321,7 @@ static int get_mfunction_return_type(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -332,7 +337,7 @@ static int get_mfunction_class_type(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -348,7 +353,7 @@ static int get_mfunction_this_type(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -364,7 +369,7 @@ static int get_mfunction_arglist(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -380,7 +385,7 @@ static int get_modifier_modified_type(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -396,7 +401,7 @@ static int get_pointer_utype(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -412,7 +417,7 @@ static int get_procedure_return_type(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -428,7 +433,7 @@ static int get_procedure_arglist(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -444,7 +449,7 @@ static int get_member_index(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -460,7 +465,7 @@ static int get_nesttype_index(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -476,7 +481,7 @@ static int get_onemethod_index(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -491,7 +496,7 @@ static int get_method_mlist(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -506,7 +511,7 @@ static int get_enum_utype(void *type, void **ret_type) {
 		*ret_type = 0;
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = get_stype (curr_idx);
 	}
 
 	return curr_idx;
@@ -529,7 +534,7 @@ static void get_union_members(void *type, RList **l) {
 	} else {
 		SType *tmp = 0;
 		indx = lf_union->field_list - base_idx;
-		tmp = (SType *)r_list_get_n(p_types_list, indx);
+		tmp = get_stype (indx);
 		*l = ((SLF_FIELDLIST *) tmp->type_data.type_info)->substructs;
 	}
 }
@@ -545,7 +550,7 @@ static void get_struct_class_members(void *type, RList **l) {
 	} else {
 		SType *tmp = 0;
 		indx = lf->field_list - base_idx;
-		tmp = (SType *)r_list_get_n(p_types_list, indx);
+		tmp = get_stype (indx);
 		lf_fieldlist = (SLF_FIELDLIST *) tmp->type_data.type_info;
 		*l = lf_fieldlist->substructs;
 	}
@@ -561,7 +566,7 @@ static void get_enum_members(void *type, RList **l) {
 	} else {
 		SType *tmp = 0;
 		indx = lf->field_list - base_idx;
-		tmp = (SType *)r_list_get_n(p_types_list, indx);
+		tmp = get_stype (indx);
 		*l = ((SLF_FIELDLIST *) tmp->type_data.type_info)->substructs;
 	}
 }
@@ -988,6 +993,10 @@ static void free_tpi_stream(void *stream) {
 		}
 		R_FREE (type);
 	}
+	if (tpi_stream->types == p_types_list) {
+		r_pvector_clear (&p_types_index);
+		p_types_list = NULL;
+	}
 	r_list_free (tpi_stream->types);
 }
 
@@ -2353,6 +2362,8 @@ int parse_tpi_stream(void *parsed_pdb_stream, R_STREAM_FILE *stream) {
 	STpiStream *tpi_stream = (STpiStream *) parsed_pdb_stream;
 	tpi_stream->types = r_list_new();
 	p_types_list = tpi_stream->types;
+	r_pvector_clear (&p_types_index);
+	r_pvector_init (&p_types_index, NULL);
 
 	stream_file_read(stream, sizeof(STPIHeader), (char *)&tpi_stream->header);
 
@@ -2372,6 +2383,7 @@ int parse_tpi_stream(void *parsed_pdb_stream, R_STREAM_FILE *stream) {
 			return 0;
 		}
 		r_list_append(tpi_stream->types, type);
+		r_pvector_push (&p_types_index, type);
 	}
 	return 1;
 }
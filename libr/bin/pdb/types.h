@@ -1267,6 +1267,8 @@ typedef struct {
 typedef struct {
 	RList *omap_entries;
 	ut32 *froms;
+	SOmapEntry **entries; // omap_entries by position, built with froms
+	int entries_count;
 } SOmapStream;
 // end of omap structures
 
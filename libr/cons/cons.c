@@ -512,6 +512,7 @@ R_API RCons *r_cons_free() {
 		R_FREE (I.context->buffer);
 	}
 	R_FREE (I.break_word);
+	r_cons_visual_invalidate ();
 	cons_context_deinit (I.context);
 	R_FREE (I.context->lastOutput);
 	I.context->lastLength = 0;
@@ -776,6 +777,21 @@ static bool lastMatters() {
 		!I.context->grep.json && !I.is_html);
 }
 
+// true if the buffer only contains escape sequences, which do not damage the screen
+static bool visual_is_undrawn(const char *buf, int len) {
+	const char *end = buf + len;
+	while (buf < end) {
+		if (*buf != 0x1b || buf + 1 >= end || buf[1] != '[') {
+			return false;
+		}
+		for (buf += 2; buf < end && (*buf == ';' || IS_DIGIT (*buf)); buf++) {
+			;
+		}
+		buf++;
+	}
+	return true;
+}
+
 R_API void r_cons_flush(void) {
 	const char *tee = I.teefile;
 	if (I.noflush) {
@@ -848,6 +864,9 @@ R_API void r_cons_flush(void) {
 		}
 	}
 	r_cons_highlight (I.highlight);
+	if (I.frame && !visual_is_undrawn (I.context->buffer, I.context->buffer_len)) {
+		r_cons_visual_invalidate ();
+	}
 
 	// is_html must be a filter, not a write endpoint
 	if (r_cons_is_interactive () && !r_sandbox_enable (false)) {
@@ -932,27 +951,153 @@ static int real_strlen(const char *ptr, int len) {
 	return ansilen - diff;
 }
 
+// damage tracking only works when lines are written one after the other
+static bool visual_is_linear(const char *buf) {
+	for (; *buf; buf++) {
+		if (*buf == 0x1b && buf[1] == '[') {
+			for (buf += 2; *buf == ';' || IS_DIGIT (*buf); buf++) {
+				;
+			}
+			if (*buf != 'm') {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// keep the color attributes active after the given text
+static void visual_sgr_update(char *sgr, int sgr_size, const char *s, int len) {
+	const char *end = s + len;
+	for (; s + 1 < end; s++) {
+		if (*s != 0x1b || s[1] != '[') {
+			continue;
+		}
+		const char *e = s + 2;
+		while (e < end && (*e == ';' || IS_DIGIT (*e))) {
+			e++;
+		}
+		if (e >= end) {
+			break;
+		}
+		if (*e == 'm') {
+			int n = e - s + 1;
+			int sgrlen = strlen (sgr);
+			if (n == 3 || (n == 4 && s[2] == '0')) {
+				*sgr = 0;
+			} else if (sgrlen + n < sgr_size) {
+				memcpy (sgr + sgrlen, s, n);
+				sgr[sgrlen + n] = 0;
+			} else if (n < sgr_size) {
+				memcpy (sgr, s, n);
+				sgr[n] = 0;
+			}
+		}
+		s = e;
+	}
+}
+
+R_API void r_cons_visual_invalidate(void) {
+	int i;
+	if (I.frame) {
+		for (i = 0; i < I.frame_rows; i++) {
+			free (I.frame[i]);
+		}
+		R_FREE (I.frame);
+	}
+	I.frame_rows = 0;
+	I.frame_columns = 0;
+}
+
+// write only the lines that differ from the previous frame
+static void visual_present(char **frame, int rows) {
+	RStrBuf *out = r_strbuf_new ("");
+	bool full = !I.frame || I.frame_rows != rows || I.frame_columns != I.columns;
+	int i;
+	if (!out) {
+		return;
+	}
+	for (i = 0; i < rows; i++) {
+		if (!frame[i] || !*frame[i]) {
+			// covered by a broken line above
+			continue;
+		}
+		if (!full && I.frame[i] && !strcmp (frame[i], I.frame[i])) {
+			continue;
+		}
+		r_strbuf_appendf (out, "\x1b[%d;1H", i + 1);
+		r_strbuf_append (out, frame[i]);
+	}
+	if (r_strbuf_length (out) > 0) {
+		r_strbuf_append (out, Color_RESET);
+		r_cons_write (r_strbuf_get (out), r_strbuf_length (out));
+	}
+	r_strbuf_free (out);
+	r_cons_visual_invalidate ();
+	I.frame = frame;
+	I.frame_rows = rows;
+	I.frame_columns = I.columns;
+}
+
+static inline void visual_write(RStrBuf *line, const char *buf, int len) {
+	if (line) {
+		r_strbuf_append_n (line, buf, len);
+	} else {
+		r_cons_write (buf, len);
+	}
+}
+
 R_API void r_cons_visual_write(char *buffer) {
 	char white[1024];
+	char sgr[128] = {0};
 	int cols = I.columns;
 	int alen, plen, lines = I.rows;
 	bool break_lines = I.break_lines;
 	const char *endptr;
 	char *nl, *ptr = buffer, *pptr;
+	char **frame = NULL;
+	RStrBuf *line = NULL;
+	int row = 0;
 
 	if (I.null) {
 		return;
 	}
+	if (I.damage && lines > 0 && cols > 0) {
+		if (r_str_startswith (ptr, "\x1b[0;0H")) {
+			ptr += strlen ("\x1b[0;0H");
+		}
+		if (visual_is_linear (ptr)) {
+			frame = R_NEWS0 (char *, lines);
+			buffer = ptr;
+		}
+	}
+	if (!frame) {
+		if (I.damage) {
+			// Visual skips the clear with scr.damage, the full repaint must do it
+			const char *cls = Color_RESET R_CONS_CLEAR_SCREEN "\x1b[0;0H";
+			r_cons_write (cls, strlen (cls));
+		}
+		r_cons_visual_invalidate ();
+		ptr = buffer;
+	}
 	memset (&white, ' ', sizeof (white));
 	while ((nl = strchr (ptr, '\n'))) {
 		int len = ((int)(size_t)(nl-ptr))+1;
 		int lines_needed = 0;
+		int visible = 0;
 
 		*nl = 0;
 		alen = real_strlen (ptr, len);
 		*nl = '\n';
 		pptr = ptr > buffer ? ptr - 1 : ptr;
 		plen = ptr > buffer ? len : len - 1;
+		if (frame) {
+			// lines are positioned explicitly, skip the newline
+			pptr = ptr;
+			plen = len - 1;
+			line = r_strbuf_new (Color_RESET);
+			r_strbuf_append (line, sgr);
+		}
 
 		if (break_lines) {
 			lines_needed = alen / cols + (alen % cols == 0 ? 0 : 1);
@@ -964,29 +1109,48 @@ R_API void r_cons_visual_write(char *buffer) {
 			endptr++;
 			len = endptr - ptr;
 			plen = ptr > buffer ? len : len - 1;
+			if (frame) {
+				plen = len - 1;
+			}
 			if (lines > 0) {
-				r_cons_write (pptr, plen);
+				visual_write (line, pptr, plen);
 				if (len != olen) {
-					r_cons_write (Color_RESET, strlen (Color_RESET));
+					visual_write (line, Color_RESET, strlen (Color_RESET));
 				}
 			}
+			visible = cols;
 		} else {
 			if (lines > 0) {
 				int w = cols - (alen % cols == 0 ? cols : alen % cols);
-				r_cons_write (pptr, plen);
+				visual_write (line, pptr, plen);
+				visible = alen;
 				if (I.blankline && w > 0) {
 					if (w > sizeof (white) - 1) {
 						w = sizeof (white) - 1;
 					}
-					r_cons_write (white, w);
+					visual_write (line, white, w);
+					visible += w;
 				}
 			}
 			// TRICK to empty columns.. maybe buggy in w32
-			if (r_mem_mem ((const ut8*)ptr, len, (const ut8*)"\x1b[0;0H", 6)) {
+			if (!frame && r_mem_mem ((const ut8*)ptr, len, (const ut8*)"\x1b[0;0H", 6)) {
 				lines = I.rows;
 				r_cons_write (pptr, plen);
 			}
 		}
+		if (frame) {
+			if (lines > 0 && row < I.rows) {
+				visual_sgr_update (sgr, sizeof (sgr), pptr, plen);
+				if (!visible || visible % cols) {
+					r_strbuf_append (line, Color_RESET "\x1b[K");
+				}
+				frame[row] = r_strbuf_drain (line);
+			} else {
+				r_strbuf_free (line);
+			}
+			line = NULL;
+			row += break_lines? R_MAX (lines_needed, 1): 1;
+		}
 		if (break_lines) {
 			lines -= lines_needed;
 		} else {
@@ -994,6 +1158,14 @@ R_API void r_cons_visual_write(char *buffer) {
 		}
 		ptr = nl + 1;
 	}
+	if (frame) {
+		/* blank the rest of the screen */
+		for (; row < I.rows; row++) {
+			frame[row] = strdup (Color_RESET "\x1b[K");
+		}
+		visual_present (frame, I.rows);
+		return;
+	}
 	/* fill the rest of screen */
 	if (lines > 0) {
 		if (cols > sizeof (white)) {
@@ -1317,6 +1489,10 @@ R_API void r_cons_set_raw(bool is_raw) {
 #endif
 	fflush (stdout);
 	oldraw = is_raw;
+	if (!is_raw) {
+		// prompts may draw anywhere
+		r_cons_visual_invalidate ();
+	}
 }
 
 R_API void r_cons_invert(int set, int color) {
@@ -915,7 +915,7 @@ R_API RAnalOp* r_core_anal_op(RCore *core, ut64 addr, int mask) {
 	if (addr == UT64_MAX) {
 		return NULL;
 	}
-	RAnalOp *op = R_NEW0 (RAnalOp);
+	RAnalOp *op = r_anal_op_new (core->anal);
 	if (!op) {
 		return NULL;
 	}
@@ -946,7 +946,7 @@ R_API RAnalOp* r_core_anal_op(RCore *core, ut64 addr, int mask) {
 	r_asm_op_fini (&asmop);
 	return op;
 err_op:
-	free (op);
+	r_anal_op_free (op);
 	return NULL;
 }
 
@@ -1473,7 +1473,7 @@ R_API int r_core_anal_bb(RCore *core, RAnalFunction *fcn, ut64 addr, int head) {
 		return false;
 	}
 
-	bb = r_anal_bb_new ();
+	bb = r_anal_bb_new (core->anal);
 	if (!bb) {
 		return false;
 	}
@@ -3967,6 +3967,209 @@ R_API void r_core_anal_undefine(RCore *core, ut64 off) {
 	r_anal_fcn_del (core->anal, off);
 }
 
+typedef struct {
+	ut64 addr;
+	char *name;
+} DirtyFcn;
+
+static void dirty_fcn_free(void *p) {
+	DirtyFcn *d = p;
+	if (d) {
+		free (d->name);
+		free (d);
+	}
+}
+
+/* analyze again the functions marked as dirty by writes on their code,
+ * keeping their names, returns the number of functions analyzed */
+R_API int r_core_anal_dirty(RCore *core) {
+	r_return_val_if_fail (core, 0);
+	RAnalFunction *fcn;
+	RListIter *iter, *iter2;
+	DirtyFcn *d;
+	RList *todo = r_list_newf (dirty_fcn_free);
+	if (!todo) {
+		return 0;
+	}
+	r_list_foreach_safe (core->anal->fcns, iter, iter2, fcn) {
+		if (!fcn->is_dirty) {
+			continue;
+		}
+		if (!(d = R_NEW0 (DirtyFcn))) {
+			break;
+		}
+		d->addr = fcn->addr;
+		d->name = strdup (fcn->name);
+		r_list_append (todo, d);
+		r_anal_del_jmprefs (core->anal, fcn);
+		// only this function, r_anal_fcn_del would take all those containing addr
+		r_anal_fcn_tree_delete (core->anal, fcn);
+		r_list_delete (core->anal->fcns, iter);
+	}
+	const int depth = r_config_get_i (core->config, "anal.depth");
+	r_list_foreach (todo, iter, d) {
+		if (r_cons_is_breaked ()) {
+			break;
+		}
+		r_core_anal_fcn (core, d->addr, UT64_MAX, R_ANAL_REF_TYPE_NULL, depth);
+		fcn = r_anal_get_fcn_at (core->anal, d->addr, 0);
+		if (fcn && d->name && strcmp (fcn->name, d->name)) {
+			free (fcn->name);
+			fcn->name = d->name;
+			d->name = NULL;
+		}
+	}
+	int n = r_list_length (todo);
+	r_list_free (todo);
+	return n;
+}
+
+static void anal_cache_hash_str(RHash *ctx, const char *s) {
+	if (s && *s) {
+		r_hash_do_sha1 (ctx, (const ut8 *)s, strlen (s));
+	}
+}
+
+static bool anal_cache_keyvar(const char *name) {
+	if (!strncmp (name, "anal.", 5)) {
+		return strncmp (name, "anal.cache", 10);
+	}
+	// the symbols, relocs and strings seed the analysis
+	if (!strncmp (name, "bin.", 4)) {
+		return true;
+	}
+	return !strcmp (name, "asm.arch") || !strcmp (name, "asm.bits")
+		|| !strcmp (name, "asm.cpu") || !strcmp (name, "asm.os")
+		|| !strcmp (name, "cfg.bigendian");
+}
+
+/* the cache file is named after the hash of the analysis level, the
+ * options affecting the analysis and the layout and bytes of the maps */
+R_API char *r_core_anal_cache_path(RCore *core, const char *level) {
+	r_return_val_if_fail (core && level, NULL);
+	char hex[R_HASH_SIZE_SHA1 * 2 + 1];
+	const int bufsz = 0x10000;
+	RConfigNode *node;
+	RListIter *iter;
+	SdbListIter *it;
+	RIOMap *map;
+	if (r_config_get_i (core->config, "cfg.debug")) {
+		return NULL;
+	}
+	RHash *ctx = r_hash_new (false, R_HASH_SHA1);
+	ut8 *buf = malloc (bufsz);
+	if (!ctx || !buf) {
+		r_hash_free (ctx);
+		free (buf);
+		return NULL;
+	}
+	r_hash_do_begin (ctx, R_HASH_SHA1);
+	anal_cache_hash_str (ctx, sdb_fmt ("aa%s\n", level));
+	r_list_foreach (core->config->nodes, iter, node) {
+		if (anal_cache_keyvar (node->name)) {
+			anal_cache_hash_str (ctx, sdb_fmt ("%s=%s\n", node->name, node->value));
+		}
+	}
+	ls_foreach (core->io->maps, it, map) {
+		ut64 at, size = r_itv_size (map->itv);
+		anal_cache_hash_str (ctx, sdb_fmt ("0x%"PFMT64x" 0x%"PFMT64x" %d\n",
+			r_itv_begin (map->itv), size, map->perm));
+		for (at = 0; at < size; at += bufsz) {
+			int len = R_MIN (size - at, bufsz);
+			(void)r_io_read_at (core->io, r_itv_begin (map->itv) + at, buf, len);
+			r_hash_do_sha1 (ctx, buf, len);
+		}
+	}
+	r_hash_do_end (ctx, R_HASH_SHA1);
+	r_hex_bin2str (ctx->digest, R_HASH_SIZE_SHA1, hex);
+	r_hash_free (ctx);
+	free (buf);
+	char *dir = r_file_abspath (r_config_get (core->config, "dir.cache"));
+	char *path = dir? r_str_newf ("%s" R_SYS_DIR "%s.r2", dir, hex): NULL;
+	free (dir);
+	return path;
+}
+
+/* runs the script saved by r_core_anal_cache_save at the path computed by
+ * r_core_anal_cache_path, returns false if there is none */
+R_API bool r_core_anal_cache_load(RCore *core, const char *path) {
+	r_return_val_if_fail (core, false);
+	if (!path || !r_file_exists (path)) {
+		return false;
+	}
+	ut64 t = r_sys_now ();
+	const char *oldstr = r_print_rowlog (core->print, "Load the analysis from the cache (anal.cache)");
+	bool ret = r_core_cmd_file (core, path);
+	r_print_rowlog_done (core->print, oldstr);
+	if (ret) {
+		char *msg = r_str_newf ("Cache hit: %d functions in %"PFMT64d"ms",
+			r_list_length (core->anal->fcns), (r_sys_now () - t) / 1000);
+		oldstr = r_print_rowlog (core->print, msg);
+		r_print_rowlog_done (core->print, oldstr);
+		free (msg);
+	}
+	return ret;
+}
+
+/* stores the functions, hints and metadata as the commands of afl*, ah* and
+ * C* at the path computed by r_core_anal_cache_path before the analysis ran,
+ * it may change the bytes and the options hashed in the key. This is all
+ * that plain aa leaves behind besides the function flags */
+R_API bool r_core_anal_cache_save(RCore *core, const char *path) {
+	r_return_val_if_fail (core, false);
+	if (!path) {
+		return false;
+	}
+	char *dir = r_file_dirname (path);
+	if (!dir || !r_sys_mkdirp (dir)) {
+		eprintf ("Cannot create the anal.cache directory\n");
+		free (dir);
+		return false;
+	}
+	free (dir);
+	// write aside and rename, other sessions may be reading it
+	char *tmp = r_str_newf ("%s.%d", path, r_sys_getpid ());
+	int fd = r_sandbox_open (tmp, O_BINARY | O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd == -1) {
+		free (tmp);
+		return false;
+	}
+	char *msg = r_str_newf ("Cache miss: save %d functions to the cache (anal.cache)",
+		r_list_length (core->anal->fcns));
+	const char *oldstr = r_print_rowlog (core->print, msg);
+	RCons *cons = r_cons_singleton ();
+	char *ohl = cons->highlight? strdup (cons->highlight): NULL;
+	const bool interactive = cons->context->is_interactive;
+	const int fdold = cons->fdout;
+	r_cons_highlight (NULL);
+	r_cons_flush ();
+	cons->fdout = fd;
+	cons->context->is_interactive = false;
+	r_str_write (fd, "# r2 anal cache\n");
+	fcn_list_detail (core, core->anal->fcns);
+	r_core_cmd0 (core, "ah*");
+	r_core_cmd0 (core, "C*");
+	r_cons_flush ();
+	cons->fdout = fdold;
+	cons->context->is_interactive = interactive;
+	if (ohl) {
+		r_cons_highlight (ohl);
+		free (ohl);
+	}
+	close (fd);
+#if __WINDOWS__
+	r_file_rm (path);
+#endif
+	bool ret = !rename (tmp, path);
+	if (!ret) {
+		r_file_rm (tmp);
+	}
+	r_print_rowlog_done (core->print, oldstr);
+	free (msg);
+	free (tmp);
+	return ret;
+}
+
 /* Join function at addr2 into function at addr */
 // addr use to be core->offset
 R_API void r_core_anal_fcn_merge(RCore *core, ut64 addr, ut64 addr2) {
@@ -173,6 +173,7 @@ static void _print_strings(RCore *r, RList *list, int mode, int va) {
 	RListIter *last_processed = NULL;
 	RBinString *string;
 	RBinSection *section;
+	RFlagBatch *batch = NULL;
 	char *q;
 
 	bin->minstrlen = minstr;
@@ -187,6 +188,9 @@ static void _print_strings(RCore *r, RList *list, int mode, int va) {
 		r_flag_space_set (r->flags, R_FLAGS_FS_STRINGS);
 		r_cons_break_push (NULL, NULL);
 	}
+	if (IS_MODE_SET (mode)) {
+		batch = r_flag_batch_new (r->flags);
+	}
 	if (IS_MODE_NORMAL (mode)) {
 		r_cons_printf ("[Strings]\n");
 		r_cons_printf ("Num Paddr      Vaddr      Len Size Section  Type  String\n");
@@ -237,8 +241,12 @@ static void _print_strings(RCore *r, RList *list, int mode, int va) {
 				str = r_str_newf ("str.%s", f_name);
 				f_realname = r_str_newf ("\"%s\"", string->string);
 			}
-			RFlagItem *flag = r_flag_set (r->flags, str, addr, string->size);
-			r_flag_item_set_realname (flag, f_realname);
+			if (batch) {
+				r_flag_batch_add (batch, str, f_realname, addr, string->size);
+			} else {
+				RFlagItem *flag = r_flag_set (r->flags, str, addr, string->size);
+				r_flag_item_set_realname (flag, f_realname);
+			}
 			free (str);
 			free (f_name);
 			free (f_realname);
@@ -361,6 +369,10 @@ static void _print_strings(RCore *r, RList *list, int mode, int va) {
 		r_cons_printf ("]");
 	}
 	if (IS_MODE_SET (mode)) {
+		if (batch) {
+			r_flag_batch_commit (batch);
+			r_flag_batch_free (batch);
+		}
 		r_cons_break_pop ();
 	}
 }
@@ -464,13 +476,6 @@ static bool is_executable(RBinObject *obj) {
 	return false;
 }
 
-static void sdb_concat_by_path(Sdb *s, const char *path) {
-	Sdb *db = sdb_new (0, path, 0);
-	sdb_merge (s, db);
-	sdb_close (db);
-	sdb_free (db);
-}
-
 R_API void r_core_anal_type_init(RCore *core) {
 	r_return_if_fail (core && core->anal);
 	const char *dir_prefix = r_config_get (core->config, "dir.prefix");
@@ -478,48 +483,49 @@ R_API void r_core_anal_type_init(RCore *core) {
 	Sdb *types = core->anal->sdb_types;
 	// make sure they are empty this is initializing
 	sdb_reset (types);
+	r_type_cache_invalidate (types);
 	const char *anal_arch = r_config_get (core->config, "anal.arch");
 	const char *os = r_config_get (core->config, "asm.os");
 	// spaguetti ahead
 
 	const char *dbpath = sdb_fmt (R_JOIN_3_PATHS ("%s", R2_SDB_FCNSIGN, "types.sdb"), dir_prefix);
 	if (r_file_exists (dbpath)) {
-		sdb_concat_by_path (types, dbpath);
+		sdb_layer (types, dbpath);
 	}
 	dbpath = sdb_fmt (R_JOIN_3_PATHS ("%s", R2_SDB_FCNSIGN, "types-%s.sdb"),
 		dir_prefix, anal_arch);
 	if (r_file_exists (dbpath)) {
-		sdb_concat_by_path (types, dbpath);
+		sdb_layer (types, dbpath);
 	}
 	dbpath = sdb_fmt (R_JOIN_3_PATHS ("%s", R2_SDB_FCNSIGN, "types-%s.sdb"),
 		dir_prefix, os);
 	if (r_file_exists (dbpath)) {
-		sdb_concat_by_path (types, dbpath);
+		sdb_layer (types, dbpath);
 	}
 	dbpath = sdb_fmt (R_JOIN_3_PATHS ("%s", R2_SDB_FCNSIGN, "types-%d.sdb"),
 		dir_prefix, bits);
 	if (r_file_exists (dbpath)) {
-		sdb_concat_by_path (types, dbpath);
+		sdb_layer (types, dbpath);
 	}
 	dbpath = sdb_fmt (R_JOIN_3_PATHS ("%s", R2_SDB_FCNSIGN, "types-%s-%d.sdb"),
 		dir_prefix, os, bits);
 	if (r_file_exists (dbpath)) {
-		sdb_concat_by_path (types, dbpath);
+		sdb_layer (types, dbpath);
 	}
 	dbpath = sdb_fmt (R_JOIN_3_PATHS ("%s", R2_SDB_FCNSIGN, "types-%s-%d.sdb"),
 		dir_prefix, anal_arch, bits);
 	if (r_file_exists (dbpath)) {
-		sdb_concat_by_path (types, dbpath);
+		sdb_layer (types, dbpath);
 	}
 	dbpath = sdb_fmt (R_JOIN_3_PATHS ("%s", R2_SDB_FCNSIGN, "types-%s-%s.sdb"),
 		dir_prefix, anal_arch, os);
 	if (r_file_exists (dbpath)) {
-		sdb_concat_by_path (types, dbpath);
+		sdb_layer (types, dbpath);
 	}
 	dbpath = sdb_fmt (R_JOIN_3_PATHS ("%s", R2_SDB_FCNSIGN, "types-%s-%s-%d.sdb"),
 		dir_prefix, anal_arch, os, bits);
 	if (r_file_exists (dbpath)) {
-		sdb_concat_by_path (types, dbpath);
+		sdb_layer (types, dbpath);
 	}
 }
 
@@ -556,7 +562,7 @@ R_API void r_core_anal_cc_init(RCore *core) {
 
 	char *dbpath = sdb_fmt ("%s/"R2_SDB_FCNSIGN"/cc-%s-%d.sdb", dir_prefix, anal_arch, bits);
 	if (r_file_exists (dbpath)) {
-		sdb_concat_by_path (core->anal->sdb_cc, dbpath);
+		sdb_layer (core->anal->sdb_cc, dbpath);
 	}
 	//restore all freed CC or replace with new default cc
 	RListIter *it;
@@ -812,7 +818,7 @@ static int bin_info(RCore *r, int mode, ut64 laddr) {
 	const char *dir_prefix = r_config_get (r->config, "dir.prefix");
 	char *spath = sdb_fmt ("%s/"R2_SDB_FCNSIGN"/spec.sdb", dir_prefix);
 	if (r_file_exists (spath)) {
-		sdb_concat_by_path (r->anal->sdb_fmts, spath);
+		sdb_layer (r->anal->sdb_fmts, spath);
 	}
 	return true;
 }
@@ -1036,6 +1042,12 @@ static int bin_source(RCore *r, int mode) {
 		}
 		r_list_free (list);
 	}
+	if (binfile->addrline) {
+		void **it;
+		r_pvector_foreach (&binfile->addrline->files, it) {
+			r_list_append (final_list, *it);
+		}
+	}
 	r_cons_printf ("[Source file]\n");
 	RList *uniqlist = r_list_uniq (final_list, srclineCmp);
 	r_list_foreach (uniqlist, iter2, srcline) {
@@ -1286,7 +1298,7 @@ static char *get_reloc_name(RCore *r, RBinReloc *reloc, ut64 addr) {
 	return reloc_name;
 }
 
-static void set_bin_relocs(RCore *r, RBinReloc *reloc, ut64 addr, Sdb **db, char **sdb_module) {
+static void set_bin_relocs(RCore *r, RFlagBatch *batch, RBinReloc *reloc, ut64 addr, Sdb **db, char **sdb_module) {
 	int bin_demangle = r_config_get_i (r->config, "bin.demangle");
 	const char *lang = r_config_get (r->config, "bin.lang");
 	char *reloc_name, *demname = NULL;
@@ -1295,7 +1307,6 @@ static void set_bin_relocs(RCore *r, RBinReloc *reloc, ut64 addr, Sdb **db, char
 
 	if (reloc->import && reloc->import->name[0]) {
 		char str[R_FLAG_NAME_SIZE];
-		RFlagItem *fi;
 
 		if (is_pe && !is_sandbox && strstr (reloc->import->name, "Ordinal")) {
 			const char *TOKEN = ".dll_Ordinal_";
@@ -1357,20 +1368,19 @@ static void set_bin_relocs(RCore *r, RBinReloc *reloc, ut64 addr, Sdb **db, char
 			demname = r_bin_demangle (r->bin->cur, lang, str, addr);
 		}
 		r_name_filter (str, 0);
-		fi = r_flag_set (r->flags, str, addr, bin_reloc_size (reloc));
+		char *realname = NULL;
 		if (demname) {
-			char *realname;
 			if (r->bin->prefix) {
 				realname = sdb_fmt ("%s.reloc.%s", r->bin->prefix, demname);
 			} else {
 				realname = sdb_fmt ("reloc.%s", demname);
 			}
-			r_flag_item_set_realname (fi, realname);
 		}
+		r_flag_batch_add (batch, str, realname, addr, bin_reloc_size (reloc));
 	} else {
 		char *reloc_name = get_reloc_name (r, reloc, addr);
 		if (reloc_name) {
-			r_flag_set (r->flags, reloc_name, addr, bin_reloc_size (reloc));
+			r_flag_batch_add (batch, reloc_name, NULL, addr, bin_reloc_size (reloc));
 		} else {
 			// eprintf ("Cannot find a name for 0x%08"PFMT64x"\n", addr);
 		}
@@ -1432,6 +1442,7 @@ static int bin_relocs(RCore *r, int mode, int va) {
 	RBinReloc *reloc = NULL;
 	Sdb *db = NULL;
 	PJ *pj = NULL;
+	RFlagBatch *batch = NULL;
 	char *sdb_module = NULL;
 	int i = 0;
 
@@ -1456,6 +1467,7 @@ static int bin_relocs(RCore *r, int mode, int va) {
 		}
 	} else if (IS_MODE_SET (mode)) {
 		r_flag_space_set (r->flags, R_FLAGS_FS_RELOCS);
+		batch = r_flag_batch_new (r->flags);
 	}
 
 	r_rbtree_foreach (relocs, iter, reloc, RBinReloc, vrb) {
@@ -1465,8 +1477,8 @@ static int bin_relocs(RCore *r, int mode, int va) {
 			 * Skip section reloc because they will have their own flag.
 			 * Skip also file reloc because not useful for now.
 			 */
-		} else if (IS_MODE_SET (mode)) {
-			set_bin_relocs (r, reloc, addr, &db, &sdb_module);
+		} else if (IS_MODE_SET (mode) && batch) {
+			set_bin_relocs (r, batch, reloc, addr, &db, &sdb_module);
 			add_metadata (r, reloc, addr, mode);
 		} else if (IS_MODE_SIMPLE (mode)) {
 			r_cons_printf ("0x%08"PFMT64x"  %s\n", addr, reloc->import ? reloc->import->name : "");
@@ -1572,6 +1584,10 @@ static int bin_relocs(RCore *r, int mode, int va) {
 	if (pj) {
 		pj_free (pj);
 	}
+	if (batch) {
+		r_flag_batch_commit (batch);
+		r_flag_batch_free (batch);
+	}
 	R_FREE (sdb_module);
 	sdb_free (db);
 	db = NULL;
@@ -1953,6 +1969,13 @@ static int bin_symbols(RCore *r, int mode, ut64 laddr, int va, ut64 at, const ch
 
 	bool is_arm = info && info->arch && !strncmp (info->arch, "arm", 3);
 	const char *lang = bin_demangle ? r_config_get (r->config, "bin.lang") : NULL;
+	RFlagBatch *batch = NULL;
+	if (IS_MODE_SET (mode)) {
+		batch = r_flag_batch_new (r->flags);
+		if (!batch) {
+			return 0;
+		}
+	}
 
 	RList *symbols = r_bin_get_symbols (r->bin);
 	r_spaces_push (&r->anal->meta_spaces, "bin");
@@ -2023,6 +2046,8 @@ static int bin_symbols(RCore *r, int mode, ut64 laddr, int va, ut64 at, const ch
 			select_flag_space (r, symbol);
 			/* If that's a Classed symbol (method or so) */
 			if (sn.classname) {
+				// method flags look at what is already set
+				r_flag_batch_commit (batch);
 				RFlagItem *fi = r_flag_get (r->flags, sn.methflag);
 				if (r->bin->prefix) {
 					char *prname = r_str_newf ("%s.%s", r->bin->prefix, sn.methflag);
@@ -2050,10 +2075,7 @@ static int bin_symbols(RCore *r, int mode, ut64 laddr, int va, ut64 at, const ch
 				char *fnp = (r->bin->prefix) ?
 					r_str_newf ("%s.%s", r->bin->prefix, fn):
 					strdup (fn);
-				RFlagItem *fi = r_flag_set (r->flags, fnp, addr, symbol->size);
-				if (fi) {
-					r_flag_item_set_realname (fi, n);
-				} else {
+				if (!fnp || !*fnp || !r_flag_batch_add (batch, fnp, n, addr, symbol->size)) {
 					if (fn) {
 						eprintf ("[Warning] Can't find flag (%s)\n", fn);
 					}
@@ -2181,6 +2203,10 @@ static int bin_symbols(RCore *r, int mode, ut64 laddr, int va, ut64 at, const ch
 		}
 	}
 
+	if (batch) {
+		r_flag_batch_commit (batch);
+		r_flag_batch_free (batch);
+	}
 	//handle thumb and arm for entry point since they are not present in symbols
 	if (is_arm) {
 		r_list_foreach (entries, iter, entry) {
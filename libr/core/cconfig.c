@@ -1769,6 +1769,13 @@ static int cb_ioff(void *user, void *data) {
 	return true;
 }
 
+static int cb_rapcache(void *user, void *data) {
+	RCore *core = (RCore *) user;
+	RConfigNode *node = (RConfigNode *) data;
+	core->io->rapcache = node->i_value;
+	return true;
+}
+
 static int cb_io_oxff(void *user, void *data) {
 	RCore *core = (RCore *) user;
 	RConfigNode *node = (RConfigNode *) data;
@@ -1836,6 +1843,13 @@ static int cb_breaklines(void *user, void *data) {
 	return true;
 }
 
+static int cb_scrdamage(void *user, void *data) {
+	RConfigNode *node = (RConfigNode *) data;
+	r_cons_singleton ()->damage = node->i_value;
+	r_cons_visual_invalidate ();
+	return true;
+}
+
 static int cb_scr_gadgets(void *user, void *data) {
 	RCore *core = (RCore*) user;
 	RConfigNode *node = (RConfigNode *) data;
@@ -2637,6 +2651,9 @@ R_API int r_core_config_init(RCore *core) {
 	SETPREF ("anal.calls", "false", "Make basic af analysis walk into calls");
 	SETPREF ("anal.autoname", "false", "Speculatively set a name for the functions, may result in some false positives");
 	SETPREF ("anal.hasnext", "false", "Continue analysis after each function");
+	SETPREF ("anal.dirty", "true", "Mark the functions whose code is written as dirty (see aaw)");
+	SETPREF ("anal.dirty.auto", "false", "Analyze the dirty functions again right after each write");
+	SETPREF ("anal.cache", "false", "Reuse the result of aa from dir.cache when the bytes and options did not change");
 	SETPREF ("anal.esil", "false", "Use the new ESIL code analysis");
 	SETCB ("anal.strings", "false", &cb_analstrings, "Identify and register strings during analysis (aar only)");
 	SETPREF ("anal.types.spec", "gcc",  "Set profile for specifying format chars used in type analysis");
@@ -2990,6 +3007,7 @@ R_API int r_core_config_init(RCore *core) {
 	SETPREF ("dir.projects", R_JOIN_2_PATHS ("~", R2_HOME_PROJECTS), "Default path for projects");
 #endif
 	SETCB ("dir.zigns", R_JOIN_2_PATHS ("~", R2_HOME_ZIGNS), &cb_dirzigns, "Default path for zignatures (see zo command)");
+	SETPREF ("dir.cache", R_JOIN_3_PATHS ("~", R2_HOME_CACHEDIR, "anal"), "Path to store the analysis cache (see anal.cache)");
 	SETPREF ("stack.reg", "SP", "Which register to use as stack pointer in the visual debug");
 	SETPREF ("stack.bytes", "true", "Show bytes instead of words in stack");
 	SETPREF ("stack.anotated", "false", "Show anotated hexdump in visual debug");
@@ -3232,6 +3250,7 @@ R_API int r_core_config_init(RCore *core) {
 	// DEPRECATED: USES hex.cols now SETI ("scr.colpos", 80, "Column position of cmd.cprompt in visual");
 	SETCB ("scr.breakword", "", &cb_scrbreakword, "Emulate console break (^C) when a word is printed (useful for pD)");
 	SETCB ("scr.breaklines", "false", &cb_breaklines, "Break lines in Visual instead of truncating them");
+	SETCB ("scr.damage", "false", &cb_scrdamage, "Only redraw the lines that changed in Visual, panels and the visual graph (faster over slow links)");
 	SETCB("scr.gadgets", "false", &cb_scr_gadgets, "Run pg in prompt, visual and panels");
 	SETICB ("scr.columns", 0, &cb_scrcolumns, "Force console column count (width)");
 	SETPREF ("scr.dumpcols", "false", "Prefer pC commands before p ones");
@@ -3324,6 +3343,7 @@ R_API int r_core_config_init(RCore *core) {
 	SETCB ("io.va", "true", &cb_iova, "Use virtual address layout");
 	SETCB ("io.pava", "false", &cb_io_pava, "Use EXPERIMENTAL paddr -> vaddr address mode");
 	SETCB ("io.autofd", "true", &cb_ioautofd, "Change fd when opening a new file");
+	SETCB ("rap.cache", "false", &cb_rapcache, "Cache the reads of rap:// sessions, only safe when the remote data does not change");
 
 	/* file */
 	SETPREF ("file.desc", "", "User defined file description (used by projects)");
@@ -3342,6 +3362,7 @@ R_API int r_core_config_init(RCore *core) {
 
 	/* rap */
 	SETPREF ("rap.loop", "true", "Run rap as a forever-listening daemon (=:9090)");
+	SETPREF ("rap.lz4", "true", "Compress read replies with lz4 for rap v2 clients");
 
 	/* nkeys */
 	SETPREF ("key.s", "", "override step into action");
@@ -3362,6 +3383,8 @@ R_API int r_core_config_init(RCore *core) {
 	SETI ("zoom.from", 0, "Zoom start address");
 	SETI ("zoom.maxsz", 512, "Zoom max size of block");
 	SETI ("zoom.to", 0, "Zoom end address");
+	SETPREF ("zoom.pyramid", "false", "Answer p=e, p=0, p=p and pz from cached block statistics (ignored with cfg.debug)");
+	SETPREF ("zoom.cache", "false", "Keep the block statistics in ~/.cache/radare2/zoom");
 	n = NODECB ("zoom.in", "io.map", &cb_searchin);
 	SETDESC (n, "Specify  boundaries for zoom");
 	SETOPTIONS (n, "raw", "block",
@@ -463,9 +463,38 @@ R_API int r_core_bin_rebase(RCore *core, ut64 baddr) {
 		return 0;
 	}
 	RBinFile *bf = core->bin->cur;
-	bf->o->baddr = baddr;
+	if (!bf->o) {
+		return 0;
+	}
+	ut64 obaddr = r_bin_get_baddr (core->bin);
+	st64 delta = baddr - obaddr;
+	if (!delta) {
+		return 1;
+	}
+	// bin items are stored relative to the object base, moving them is
+	// just a new baddr_shift. What was already derived from them is moved
+	// in a single pass over the object's address range
+	ut64 from = UT64_MAX, to = 0;
+	RBinSection *s;
+	RListIter *iter;
+	r_list_foreach (r_bin_get_sections (core->bin), iter, s) {
+		ut64 va = r_bin_a2b (core->bin, s->vaddr);
+		ut64 sz = s->vsize? s->vsize: s->size;
+		if (va == UT64_MAX || !sz) {
+			continue;
+		}
+		from = R_MIN (from, va);
+		to = R_MAX (to, va + sz);
+	}
+	r_bin_set_baddr (core->bin, baddr);
 	bf->o->loadaddr = baddr;
-	r_bin_object_set_items (bf, bf->o);
+	if (from < to) {
+		r_flag_rebase (core->flags, from, to, delta);
+		r_anal_fcn_rebase (core->anal, from, to, delta);
+		r_anal_xrefs_rebase (core->anal, from, to, delta);
+		r_meta_rebase (core->anal, from, to, delta);
+		r_anal_hint_rebase (core->anal, from, to, delta);
+	}
 	return 1;
 }
 
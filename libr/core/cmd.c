@@ -1472,7 +1472,8 @@ static int cmd_tasks(void *data, const char *input) {
 		helpCmdTasks (core);
 		break;
 	case ' ': // "&"
-	case 't': { // "&t"
+	case 't': // "&t"
+	case 'r': { // "&r"
 		if (r_sandbox_enable (0)) {
 			eprintf ("This command is disabled in sandbox mode\n");
 			return 0;
@@ -1482,6 +1483,7 @@ static int cmd_tasks(void *data, const char *input) {
 			break;
 		}
 		task->transient = input[0] == 't';
+		task->readonly = input[0] == 'r';
 		r_core_task_enqueue (core, task);
 		break;
 	}
@@ -47,6 +47,7 @@ static const char *help_msg_aa[] = {
 	"aaF", " [sym*]", "set anal.in=block for all the spaces between flags matching glob",
 	"aaFa", " [sym*]", "same as aaF but uses af/a2f instead of af+/afb+ (slower but more accurate)",
 	"aai", "[j]", "show info of all analysis parameters",
+	"aaim", "", "show allocation counts of the analysis object pools",
 	"aan", "", "autoname functions that either start with fcn.* or sym.func.*",
 	"aang", "", "find function and symbol names from golang binaries",
 	"aao", "", "analyze all objc references",
@@ -57,6 +58,7 @@ static const char *help_msg_aa[] = {
 	"aaT", " [len]", "analyze code after trap-sleds",
 	"aau", " [len]", "list mem areas (larger than len bytes) not covered by functions",
 	"aav", " [sat]", "find values referencing a specific section or map",
+	"aaw", "[l]", "analyze again the functions written since analysis (aawl to list them)",
 	NULL
 };
 
@@ -7417,6 +7419,21 @@ static int compute_calls(RCore *core) {
 	return cov;
 }
 
+static void r_core_anal_pool_info(RCore *core) {
+	const char *names[R_ANAL_POOL_LAST] = { "ops", "blocks", "refs" };
+	int i;
+	r_cons_printf ("pool      nodesz   allocs  release     live     peak\n");
+	for (i = 0; i < R_ANAL_POOL_LAST; i++) {
+		RMemoryPool *pool = core->anal->pools[i];
+		if (!pool) {
+			continue;
+		}
+		r_cons_printf ("%-8s %7d %8"PFMT64d" %8"PFMT64d" %8"PFMT64d" %8"PFMT64d"%s\n",
+			names[i], pool->nodesize, pool->nalloc, pool->nrelease,
+			pool->live, pool->peak, pool->nopool? " (malloc)": "");
+	}
+}
+
 static void r_core_anal_info (RCore *core, const char *input) {
 	int fcns = r_list_length (core->anal->fcns);
 	int strs = r_flag_count (core->flags, "str.*");
@@ -7763,8 +7780,27 @@ static int cmd_anal_all(RCore *core, const char *input) {
 	case 'u': // "aau" - print areas not covered by functions
 		r_core_anal_nofunclist (core, input + 1);
 		break;
+	case 'w': // "aaw"
+		if (input[1] == 'l') { // "aawl"
+			RAnalFunction *fcn;
+			RListIter *iter;
+			r_list_foreach (core->anal->fcns, iter, fcn) {
+				if (fcn->is_dirty) {
+					r_cons_printf ("0x%08"PFMT64x" %s\n", fcn->addr, fcn->name);
+				}
+			}
+		} else {
+			r_cons_break_push (NULL, NULL);
+			r_core_anal_dirty (core);
+			r_cons_break_pop ();
+		}
+		break;
 	case 'i': // "aai"
-		r_core_anal_info (core, input + 1);
+		if (input[1] == 'm') { // "aaim"
+			r_core_anal_pool_info (core);
+		} else {
+			r_core_anal_info (core, input + 1);
+		}
 		break;
 	case 's': // "aas"
 		r_core_cmd0 (core, "af @@= `isq~[0]`");
@@ -7800,6 +7836,7 @@ static int cmd_anal_all(RCore *core, const char *input) {
 			r_cons_println ("Usage: See aa? for more help");
 		} else {
 			char *dh_orig = NULL;
+			char *cache_path = NULL;
 			if (!strncmp (input, "aaaaa", 5)) {
 				eprintf ("An r2 developer is coming to your place to manually analyze this program. Please wait for it\n");
 				if (r_cons_is_interactive ()) {
@@ -7808,6 +7845,15 @@ static int cmd_anal_all(RCore *core, const char *input) {
 				goto jacuzzi;
 			}
 			ut64 curseek = core->offset;
+			// key the cache before the analysis changes the options and bytes,
+			// aaa also runs commands whose results are not stored in it
+			if (!*input && r_config_get_i (core->config, "anal.cache")) {
+				cache_path = r_core_anal_cache_path (core, input);
+			}
+			if (cache_path && r_core_anal_cache_load (core, cache_path)) {
+				r_cons_break_push (NULL, NULL);
+				goto jacuzzi;
+			}
 			oldstr = r_print_rowlog (core->print, "Analyze all flags starting with sym. and entry0 (aa)");
 			r_cons_break_push (NULL, NULL);
 			r_cons_break_timeout (r_config_get_i (core->config, "anal.timeout"));
@@ -7930,10 +7976,14 @@ static int cmd_anal_all(RCore *core, const char *input) {
 				}
 			}
 			r_core_seek (core, curseek, 1);
+			if (cache_path) {
+				r_core_anal_cache_save (core, cache_path);
+			}
 		jacuzzi:
 			flag_every_function (core);
 			r_cons_break_pop ();
 			R_FREE (dh_orig);
+			free (cache_path);
 		}
 		break;
 	case 't': { // "aat"
@@ -147,6 +147,9 @@ static int remove_meta_offset(RCore *core, ut64 offset) {
 		eprintf ("Failed to convert %"PFMT64x" to a key", offset);
 		return -1;
 	}
+	if (core->bin->cur->addrline) {
+		r_bin_addrline_del (core->bin->cur->addrline, offset);
+	}
 	return sdb_unset (core->bin->cur->sdb_addrinfo, aoffsetptr, 0);
 }
 
@@ -182,10 +185,25 @@ static int remove_meta_fileline(RCore *core, const char *file_line) {
 	return sdb_unset (core->bin->cur->sdb_addrinfo, file_line, 0);
 }
 
+static ut64 addrline_find(RCore *core, const char *file_line) {
+	RBinAddrLineStore *al = core->bin->cur->addrline;
+	const char *sep = strchr (file_line, '|');
+	if (!al || !sep) {
+		return UT64_MAX;
+	}
+	char *file = r_str_ndup (file_line, sep - file_line);
+	ut64 addr = file? r_bin_addrline_find (al, file, atoi (sep + 1)): UT64_MAX;
+	free (file);
+	return addr;
+}
+
 static int print_meta_fileline(RCore *core, const char *file_line) {
 	char *meta_info = sdb_get (core->bin->cur->sdb_addrinfo, file_line, 0);
+	ut64 addr = meta_info? UT64_MAX: addrline_find (core, file_line);
 	if (meta_info) {
 		r_cons_printf ("Meta info %s\n", meta_info);
+	} else if (addr != UT64_MAX) {
+		r_cons_printf ("Meta info 0x%"PFMT64x"\n", addr);
 	} else {
 		r_cons_printf ("No meta info for %s found\n", file_line);
 	}
@@ -211,6 +229,13 @@ static int print_addrinfo (void *user, const char *k, const char *v) {
 	return true;
 }
 
+static bool print_addrline(void *user, const RBinAddrLine *row, const char *file) {
+	if (row->addr) {
+		r_cons_printf ("CL %s:%u 0x%"PFMT64x"\n", file, row->line, row->addr);
+	}
+	return true;
+}
+
 static int cmd_meta_add_fileline(Sdb *s, char *fileline, ut64 offset) {
 	char aoffset[64];
 	char *aoffsetptr = sdb_itoa (offset, aoffset, 16);
@@ -251,10 +276,16 @@ static int cmd_meta_lineinfo(RCore *core, const char *input) {
 	}
 
 	if (all) {
+		RBinFile *bf = core->bin->cur;
 		if (remove) {
-			sdb_reset (core->bin->cur->sdb_addrinfo);
+			sdb_reset (bf->sdb_addrinfo);
+			r_bin_addrline_free (bf->addrline);
+			bf->addrline = NULL;
 		} else {
-			sdb_foreach (core->bin->cur->sdb_addrinfo, print_addrinfo, NULL);
+			sdb_foreach (bf->sdb_addrinfo, print_addrinfo, NULL);
+			if (bf->addrline) {
+				r_bin_addrline_foreach (bf->addrline, print_addrline, NULL);
+			}
 		}
 		return 0;
 	}
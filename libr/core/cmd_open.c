@@ -373,7 +373,10 @@ static void cmd_open_bin(RCore *core, const char *input) {
 	}
 	case 'r': // "obr"
 		r_core_bin_rebase (core, r_num_math (core->num, input + 3));
+		// flags of symbols, relocs and main may live outside the sections
 		r_core_cmd0 (core, ".is*");
+		r_core_cmd0 (core, ".ir*");
+		r_core_cmd0 (core, ".iM*");
 		break;
 	case 'f':
 		if (input[2] == ' ') {
@@ -843,8 +846,8 @@ static bool reopen_in_malloc_cb(void *user, void *data, ut32 id) {
 		return false;
 	}
 
-	r_io_desc_read_at (desc, 0LL, buf, (int)size);	//that cast o_O
-	r_io_desc_write_at (ndesc, 0LL, buf, (int)size);
+	r_io_desc_read_at (desc, 0LL, buf, size);
+	r_io_desc_write_at (ndesc, 0LL, buf, size);
 	free (buf);
 	r_io_desc_exchange (io, desc->fd, ndesc->fd);
 
@@ -894,11 +897,10 @@ R_API void r_core_file_reopen_debug(RCore *core, const char *args) {
 	ut64 new_baddr = r_debug_get_baddr (core->dbg, newfile);
 	ut64 old_baddr = r_config_get_i (core->config, "bin.baddr");
 	if (old_baddr != new_baddr) {
-		r_bin_set_baddr (core->bin, new_baddr);
 		r_config_set_i (core->config, "bin.baddr", new_baddr);
+		// moves the analysis along, the flags of symbols, relocs,
+		// strings and main may live outside the sections
 		r_core_bin_rebase (core, new_baddr);
-		// r_core_bin_load (core, newfile, new_baddr);
-		// reload symbols with new baddr
 		r_core_cmd0 (core, ".is*");
 		r_core_cmd0 (core, ".ir*");
 		r_core_cmd0 (core, ".iz*");
@@ -66,6 +66,7 @@ static const char *help_msg_amper[] = {
 	"Usage:", "&[-|<cmd>]", "Manage tasks (WARNING: Experimental. Use with caution!)",
 	"&", " <cmd>", "run <cmd> in a new background task",
 	"&t", " <cmd>", "run <cmd> in a new transient background task (auto-delete when it is finished)",
+	"&r", " <cmd>", "run <cmd> in parallel on a snapshot of the session, changes it makes are discarded",
 	"&", "", "list all tasks",
 	"&j", "", "list all tasks (in JSON)",
 	"&=", " 3", "show output of task 3",
@@ -1807,6 +1808,12 @@ static bool count_pzf(RFlagItem *fi, void *u) {
 	return true;
 }
 
+// answers from the block stats pyramid without reading, -1 when it can't
+static int printzoomstat(void *user, int mode, ut64 addr, ut8 *bufz, ut64 size) {
+	st64 n = r_core_zoom_stat ((RCore *)user, mode, addr, size);
+	return (n < 0)? -1: (mode == 'e')? (ut8)n: (int)n;
+}
+
 static int printzoomcallback(void *user, int mode, ut64 addr, ut8 *bufz, ut64 size) {
 	RCore *core = (RCore *) user;
 	int j, ret = 0;
@@ -2905,14 +2912,17 @@ static inline void matchBar(ut8 *ptr, int i) {
 }
 
 static ut8 *analBars(RCore *core, int type, int nblocks, int blocksize, int skipblocks, ut64 from) {
+	// ops starting at the end of a block may span into the next one
+	const int pad = 32;
+	RAnalOp ops[64];
 	ut8 *p;
-	int j, i = 0;
+	int j, k, n, i = 0;
 	ut8 *ptr = calloc (1, nblocks);
 	if (!ptr) {
 		eprintf ("Error: failed to malloc memory");
 		return NULL;
 	}
-	p = malloc (blocksize);
+	p = malloc (blocksize + pad);
 	if (!p) {
 		R_FREE (ptr);
 		eprintf ("Error: failed to malloc memory");
@@ -2923,27 +2933,32 @@ static ut8 *analBars(RCore *core, int type, int nblocks, int blocksize, int skip
 			break;
 		}
 		ut64 off = from + (i + skipblocks) * blocksize;
-		for (j = 0; j < blocksize ; j++) {
-			RAnalOp *op = r_core_anal_op (core, off + j, R_ANAL_OP_MASK_BASIC);
-			if (op) {
-				if (op->size < 1) {
-					// do nothing
-					if (type == 'i') {
-						matchBar (ptr, i);
-					}
-				} else {
-					if (checkAnalType (op, type)) {
+		if (!r_io_read_at (core->io, off, p, blocksize)) {
+			if (type == 'i') {
+				ptr[i] = 0xff;
+			}
+			continue;
+		}
+		(void)r_io_read_at (core->io, off + blocksize, p + blocksize, pad);
+		for (j = 0; j < blocksize;) {
+			n = r_anal_op_batch (core->anal, ops, R_ARRAY_SIZE (ops), off + j,
+				p + j, blocksize + pad - j, R_ANAL_OP_MASK_BASIC);
+			if (n < 1) {
+				break;
+			}
+			for (k = 0; k < n; k++) {
+				RAnalOp *op = &ops[k];
+				if (j < blocksize) {
+					if (op->size < 1) {
+						if (type == 'i') {
+							matchBar (ptr, i);
+						}
+					} else if (checkAnalType (op, type)) {
 						matchBar (ptr, i);
 					}
+					j += R_MAX (op->size, 1);
 				}
-				if (op->size > 0) {
-					j += op->size - 1;
-				}
-				r_anal_op_free (op);
-			} else {
-				if (type == 'i') {
-					matchBar (ptr, i);
-				}
+				r_anal_op_fini (op);
 			}
 		}
 	}
@@ -2951,6 +2966,17 @@ static ut8 *analBars(RCore *core, int type, int nblocks, int blocksize, int skip
 	return ptr;
 }
 
+// fills a p= bar from the block stats pyramid, false if it must be computed
+static bool zoom_bar(RCore *core, int mode, ut64 off, ut64 blocksize, ut8 *bar) {
+	// p= counts 0xff bytes under 'f', the pyramid keeps them under 'F'
+	st64 n = r_core_zoom_stat (core, (mode == 'f')? 'F': mode, off, blocksize);
+	if (n < 0) {
+		return false;
+	}
+	*bar = (mode == 'e')? (ut8)n: (ut8)(256 * n / blocksize);
+	return true;
+}
+
 static void cmd_print_bars(RCore *core, const char *input) {
 	bool print_bars = false;
 	ut8 *ptr = NULL;
@@ -3061,6 +3087,9 @@ static void cmd_print_bars(RCore *core, const char *input) {
 				int len = 0;
 				for (i = 0; i < nblocks; i++) {
 					ut64 off = from + blocksize * (i + skipblocks);
+					if (zoom_bar (core, submode, off, blocksize, &ptr[i])) {
+						continue;
+					}
 					r_io_read_at (core->io, off, p, blocksize);
 					for (j = k = 0; j < blocksize; j++) {
 						switch (submode) {
@@ -3117,6 +3146,9 @@ static void cmd_print_bars(RCore *core, const char *input) {
 			}
 			for (i = 0; i < nblocks; i++) {
 				ut64 off = from + (blocksize * (i + skipblocks));
+				if (zoom_bar (core, 'e', off, blocksize, &ptr[i])) {
+					continue;
+				}
 				r_io_read_at (core->io, off, p, blocksize);
 				ptr[i] = (ut8) (255 * r_hash_entropy_fraction (p, blocksize));
 			}
@@ -3230,6 +3262,9 @@ static void cmd_print_bars(RCore *core, const char *input) {
 		}
 		for (i = 0; i < nblocks; i++) {
 			ut64 off = from + (blocksize * (i + skipblocks));
+			if (zoom_bar (core, 'e', off, blocksize, &ptr[i])) {
+				continue;
+			}
 			r_io_read_at (core->io, off, p, blocksize);
 			ptr[i] = (ut8) (255 * r_hash_entropy_fraction (p, blocksize));
 		}
@@ -3258,6 +3293,9 @@ static void cmd_print_bars(RCore *core, const char *input) {
 		int len = 0;
 		for (i = 0; i < nblocks; i++) {
 			ut64 off = from + blocksize * (i + skipblocks);
+			if (zoom_bar (core, mode, off, blocksize, &ptr[i])) {
+				continue;
+			}
 			r_io_read_at (core->io, off, p, blocksize);
 			for (j = k = 0; j < blocksize; j++) {
 				switch (mode) {
@@ -6247,7 +6285,7 @@ static int cmd_print(void *data, const char *input) {
 				}
 			}
 			if (do_zoom && l > 0) {
-				r_print_zoom (core->print, core, printzoomcallback,
+				r_print_zoom_ex (core->print, core, printzoomcallback, printzoomstat,
 					from, to, l, (int) maxsize);
 			}
 
@@ -1531,6 +1531,7 @@ static int cmd_type(void *data, const char *input) {
 			r_core_cmd_help (core, help_msg_t_minus);
 		} else if (input[1] == '*') {
 			sdb_reset (TDB);
+			r_type_cache_invalidate (TDB);
 			r_parse_reset ();
 		} else {
 			const char *name = input + 1;
@@ -46,7 +46,7 @@ static const char *help_msg_zf[] = {
 	"Usage:", "zf[dsz] filename ", "# Manage FLIRT signatures",
 	"zfd ", "filename", "open FLIRT file and dump",
 	"zfs ", "filename", "open FLIRT file and scan",
-	"zfs ", "/path/**.sig", "recursively search for FLIRT files and scan them (see dir.depth)",
+	"zfs ", "/path/**.sig", "recursively search for FLIRT files and scan them all at once (see dir.depth)",
 	"zfz ", "filename", "open FLIRT file and get sig commands (zfz flirt_file > zignatures.sig)",
 	NULL
 };
@@ -569,12 +569,9 @@ static int cmdFlirt(void *data, const char *input) {
 			return false;
 		}
 		int depth = r_config_get_i (core->config, "dir.depth");
-		char *file;
-		RListIter *iter;
 		RList *files = r_file_globsearch (input + 2, depth);
-		r_list_foreach (files, iter, file) {
-			r_sign_flirt_scan (core->anal, file);
-		}
+		r_list_sort (files, (RListComparator)strcmp);
+		r_sign_flirt_scan_files (core->anal, files);
 		r_list_free (files);
 		break;
 	case 'z':
@@ -6,6 +6,7 @@
 #include <r_util.h>
 #if __UNIX__
 #include <signal.h>
+#include <errno.h>
 #endif
 #include "i/private.h"
 
@@ -297,6 +298,13 @@ static void core_post_write_callback(void *user, ut64 maddr, ut8 *bytes, int cnt
 	RBinSection *sec;
 	ut64 vaddr;
 
+	r_core_zoom_invalidate (core, maddr, cnt);
+	if (r_config_get_i (core->config, "anal.dirty")) {
+		if (r_anal_fcn_invalidate (core->anal, maddr, cnt) > 0
+				&& r_config_get_i (core->config, "anal.dirty.auto")) {
+			r_core_anal_dirty (core);
+		}
+	}
 	if (!r_config_get_i (core->config, "asm.cmt.patch")) {
 		return;
 	}
@@ -314,7 +322,8 @@ static void core_post_write_callback(void *user, ut64 maddr, ut8 *bytes, int cnt
 		return;
 	}
 
-	if ((sec = r_bin_get_section_at (r_bin_cur_object (core->bin), maddr, false))) {
+	// the address is already virtual unless io works on physical ones
+	if (!core->io->va && (sec = r_bin_get_section_at (r_bin_cur_object (core->bin), maddr, false))) {
 		vaddr = maddr + sec->vaddr - sec->paddr;
 	} else {
 		vaddr = maddr;
@@ -2589,6 +2598,7 @@ R_API RCore *r_core_fini(RCore *c) {
 	//update_sdb (c);
 	// avoid double free
 	r_list_free (c->ropchain);
+	r_core_zoom_reset (c);
 	r_core_free_autocomplete (c);
 	r_event_free (c->ev);
 	R_FREE (c->cmdlog);
@@ -2793,6 +2803,82 @@ static void set_prompt (RCore *r) {
 	R_FREE (prompt);
 }
 
+#if __UNIX__
+static bool r2pipe_read_all(int fd, ut8 *buf, ut32 len) {
+	while (len > 0) {
+		int rv = read (fd, buf, len);
+		if (rv < 1) {
+			if (rv == -1 && errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		buf += rv;
+		len -= rv;
+	}
+	return true;
+}
+
+/* serves framed r2pipe requests from stdin until it is closed, the
+ * replies carry the raw cons buffer so they can hold NUL bytes. Frames
+ * go to a dup of stdout while fd 1 points at /dev/null, so neither a
+ * flush nor a !cmd child can write raw bytes in between them */
+static int r2pipe_framed_loop(RCore *r) {
+	ut8 hdr[R2PIPE_FRAME_HDR];
+	int ret = 0;
+	char *cmd = NULL;
+	ut32 cmd_size = 0;
+	int out = dup (1);
+	int null = open ("/dev/null", O_WRONLY);
+	if (out == -1 || null == -1 || dup2 (null, 1) == -1) {
+		eprintf ("Cannot redirect stdout for the framed r2pipe\n");
+		if (out != -1) {
+			close (out);
+		}
+		if (null != -1) {
+			close (null);
+		}
+		return R_CORE_CMD_EXIT;
+	}
+	close (null);
+	write (out, R2PIPE_FRAMED_ACK, sizeof (R2PIPE_FRAMED_ACK));
+	while (r2pipe_read_all (0, hdr, sizeof (hdr))) {
+		ut32 len = r_read_be32 (hdr);
+		ut32 id = r_read_be32 (hdr + 4);
+		if (len >= cmd_size) {
+			char *c = (len < UT32_MAX)? realloc (cmd, len + 1): NULL;
+			if (!c) {
+				break;
+			}
+			cmd = c;
+			cmd_size = len + 1;
+		}
+		if (!r2pipe_read_all (0, (ut8 *)cmd, len)) {
+			break;
+		}
+		cmd[len] = 0;
+		RCons *cons = r_cons_singleton ();
+		int noflush = cons->noflush;
+		r_cons_push ();
+		// flushes inside the command keep adding to the reply
+		cons->noflush = true;
+		ret = r_core_cmd (r, cmd, 0);
+		cons->noflush = noflush;
+		r_cons_filter ();
+		const char *buf = r_cons_get_buffer ();
+		bool ok = r2pipe_frame_write (out, id, buf, buf? r_cons_get_buffer_len (): 0);
+		r_cons_pop ();
+		if (!ok || ret == R_CORE_CMD_EXIT) {
+			break;
+		}
+	}
+	free (cmd);
+	dup2 (out, 1);
+	close (out);
+	return R_CORE_CMD_EXIT;
+}
+#endif
+
 R_API int r_core_prompt(RCore *r, int sync) {
 	char line[4096];
 
@@ -2805,6 +2891,12 @@ R_API int r_core_prompt(RCore *r, int sync) {
 	if (ret == -1) {
 		return false; // FD READ ERROR
 	}
+#if __UNIX__
+	// r2 -0 talking to an r2pipe client that wants framed replies
+	if (r->cons->line && r->cons->line->zerosep && !strcmp (line, R2PIPE_FRAMED_HELLO)) {
+		return r2pipe_framed_loop (r);
+	}
+#endif
 	r->num->value = rnv;
 	if (sync) {
 		return r_core_prompt_exec (r);
@@ -2920,7 +3012,7 @@ R_API char *r_core_op_str(RCore *core, ut64 addr) {
 
 R_API RAnalOp *r_core_op_anal(RCore *core, ut64 addr) {
 	ut8 buf[64];
-	RAnalOp *op = R_NEW (RAnalOp);
+	RAnalOp *op = r_anal_op_new (core->anal);
 	r_io_read_at (core->io, addr, buf, sizeof (buf));
 	r_anal_op (core->anal, op, addr, buf, sizeof (buf), R_ANAL_OP_MASK_ALL);
 	return op;
@@ -2936,9 +3028,42 @@ static void rap_break (void *u) {
 
 // TODO: PLEASE move into core/io/rap? */
 // TODO: use static buffer instead of mallocs all the time. it's network!
+static bool rap_serve_pread(RCore *core, RSocket *c, ut8 **rbuf, int caps) {
+	ut8 req[RAP_PREAD_SIZE];
+	if (!r_socket_rap_read (c, req + 1, sizeof (req) - 1)) {
+		return false;
+	}
+	ut64 len = R_MIN (r_read_be64 (req + 13), RAP_WINDOW);
+	if (!*rbuf && !(*rbuf = malloc (RAP_WINDOW))) {
+		return false;
+	}
+	r_io_read_at (core->io, r_read_be64 (req + 5), *rbuf, (int)len);
+	return r_socket_rap_pread_reply (c, r_read_be32 (req + 1), *rbuf, len, caps);
+}
+
+static bool rap_serve_pwrite(RCore *core, RSocket *c, ut8 **rbuf) {
+	ut8 req[RAP_PREAD_SIZE];
+	if (!r_socket_rap_read (c, req + 1, sizeof (req) - 1)) {
+		return false;
+	}
+	ut64 len = r_read_be64 (req + 13);
+	if (len > RAP_WINDOW) {
+		eprintf ("rap: invalid pwrite length\n");
+		return false;
+	}
+	if (!*rbuf && !(*rbuf = malloc (RAP_WINDOW))) {
+		return false;
+	}
+	if (!r_socket_rap_read (c, *rbuf, len)) {
+		return false;
+	}
+	bool ok = r_core_write_at (core, r_read_be64 (req + 5), *rbuf, (int)len);
+	return r_socket_rap_pwrite_reply (c, r_read_be32 (req + 1), ok? len: 0);
+}
+
 R_API bool r_core_serve(RCore *core, RIODesc *file) {
-	ut8 cmd, flg, *ptr = NULL, buf[1024];
-	int i, pipefd = -1;
+	ut8 cmd, flg, *ptr = NULL, *rbuf = NULL, buf[1024];
+	int i, caps = 0, pipefd = -1;
 	ut64 x;
 
 	RIORap *rior = (RIORap *)file->data;
@@ -2965,8 +3090,13 @@ reaccept:
 			goto out_of_function;
 		}
 		eprintf ("rap: client connected\n");
+		caps = 0;
 		for (;!r_cons_is_breaked ();) {
-			if (!r_socket_read (c, &cmd, 1)) {
+			int ready = r_socket_ready (c, 0, 250 * 1000);
+			if (!ready) {
+				continue;
+			}
+			if (ready < 0 || r_socket_read (c, &cmd, 1) != 1) {
 				eprintf ("rap: connection closed\n");
 				if (r_config_get_i (core->config, "rap.loop")) {
 					eprintf ("rap: waiting for new connection\n");
@@ -3059,9 +3189,13 @@ reaccept:
 					if ((cmd = malloc (i + 1))) {
 						r_socket_read_block (c, (ut8*)cmd, i);
 						cmd[i] = '\0';
-						eprintf ("len: %d cmd:'%s'\n", i, cmd);
-						fflush (stdout);
-						cmd_output = r_core_cmd_str (core, cmd);
+						cmd_output = r_socket_rap_hello (cmd, RAP_CAP_PREAD
+							| (r_config_get_i (core->config, "rap.lz4")? RAP_CAP_LZ4: 0), &caps);
+						if (!cmd_output) {
+							eprintf ("len: %d cmd:'%s'\n", i, cmd);
+							fflush (stdout);
+							cmd_output = r_core_cmd_str (core, cmd);
+						}
 						free (cmd);
 					} else {
 						eprintf ("rap: cannot malloc\n");
@@ -3128,6 +3262,20 @@ reaccept:
 				r_socket_flush (c);
 				R_FREE (ptr);
 				break;
+			case RMT_PREAD:
+				if (!rap_serve_pread (core, c, &rbuf, caps)) {
+					eprintf ("rap: pread failed\n");
+					r_socket_close (c);
+					goto out_of_function;
+				}
+				break;
+			case RMT_PWRITE:
+				if (!rap_serve_pwrite (core, c, &rbuf)) {
+					eprintf ("rap: pwrite failed\n");
+					r_socket_close (c);
+					goto out_of_function;
+				}
+				break;
 			case RMT_SEEK:
 				r_socket_read_block (c, buf, 9);
 				x = r_read_at_be64 (buf, 1);
@@ -3173,6 +3321,7 @@ reaccept:
 	}
 out_of_function:
 	r_cons_break_pop ();
+	free (rbuf);
 	return false;
 }
 
@@ -0,0 +1,446 @@
+/* radare - LGPL - Copyright 2019 - pancake */
+
+#include <r_core.h>
+#include <sys/stat.h>
+#include <math.h>
+
+/* block statistics pyramid used by p=e, p=0, p=F, p=p and pz.
+ *
+ * The address space is split in 1MB chunks, each one holding the byte
+ * histogram of the chunk and the zero/0xff/printable counts and entropy
+ * of its 4K pages. Coarser levels (16MB, 256MB, ...) cache the sum of
+ * the histograms of their 16 children, so any range is answered from
+ * the pyramid and only its unaligned edges are read from io. Chunks are
+ * computed on demand and dropped when io writes over them. With
+ * zoom.cache the chunks are kept in ~/.cache/radare2/zoom. */
+
+#define ZOOM_PAGE 4096
+#define ZOOM_CHUNK (1024 * 1024)
+#define ZOOM_PAGES (ZOOM_CHUNK / ZOOM_PAGE)
+#define ZOOM_FANOUT 4 // bits, each level is 16 times coarser
+#define ZOOM_LEVELS 5 // 1MB .. 64GB
+#define ZOOM_MAGIC "R2ZOOM01"
+
+typedef struct {
+	ut16 zeros;
+	ut16 ffs;
+	ut16 printable;
+	ut8 entropy;
+} RCoreZoomPage;
+
+typedef struct {
+	ut64 hist[256];
+	RCoreZoomPage pages[ZOOM_PAGES];
+} RCoreZoomChunk;
+
+struct r_core_zoom_t {
+	int fd;
+	bool va;
+	ut64 size;
+	ut32 layout; // hash of the io maps the addresses depend on
+	bool dirty; // chunks computed since loaded
+	bool tainted; // written over, do not persist
+	HtUP *levels[ZOOM_LEVELS]; // RCoreZoomChunk at level 0, ut64[256] above
+};
+
+static ut64 zoom_unit(int level) {
+	return (ut64)ZOOM_CHUNK << (level * ZOOM_FANOUT);
+}
+
+static ut32 zoom_layout(RCore *core) {
+	SdbListIter *iter;
+	RIOMap *map;
+	ut32 h = core->io->va;
+	if (!core->io->va) {
+		return h;
+	}
+	ls_foreach (core->io->maps, iter, map) {
+		ut64 v[4] = { map->itv.addr, map->itv.size, map->delta, map->fd };
+		int i;
+		for (i = 0; i < 4; i++) {
+			h = (h ^ (ut32)v[i] ^ (ut32)(v[i] >> 32)) * 0x01000193;
+		}
+	}
+	return h;
+}
+
+static char *zoom_cache_path(RCore *core, RCoreZoom *z, ut64 *mtime) {
+	RIODesc *desc = r_io_desc_get (core->io, z->fd);
+	struct stat st;
+	if (!desc || !desc->name || stat (desc->name, &st) || !S_ISREG (st.st_mode)) {
+		return NULL;
+	}
+	char *abspath = r_file_abspath (desc->name);
+	char *dir = r_str_home (R_JOIN_2_PATHS (R2_HOME_CACHEDIR, "zoom"));
+	char *res = NULL;
+	if (abspath && dir) {
+		char *key = r_str_newf ("%s:%08x", abspath, z->layout);
+		if (key) {
+			res = r_str_newf ("%s" R_SYS_DIR "%08x.idx", dir, r_str_hash (key));
+			free (key);
+		}
+	}
+	free (abspath);
+	free (dir);
+	*mtime = (ut64)st.st_mtime;
+	return res;
+}
+
+static void zoom_load(RCore *core, RCoreZoom *z) {
+	ut64 mtime = 0;
+	char *path = zoom_cache_path (core, z, &mtime);
+	FILE *fd = path? r_sandbox_fopen (path, "rb"): NULL;
+	free (path);
+	if (!fd) {
+		return;
+	}
+	char magic[8];
+	ut64 hdr[3];
+	ut64 i, idx;
+	bool ok = fread (magic, sizeof (magic), 1, fd) == 1
+		&& !memcmp (magic, ZOOM_MAGIC, sizeof (magic))
+		&& fread (hdr, sizeof (hdr), 1, fd) == 1
+		&& hdr[0] == z->size && hdr[1] == mtime;
+	for (i = 0; ok && i < hdr[2]; i++) {
+		RCoreZoomChunk *c = R_NEW (RCoreZoomChunk);
+		ok = c && fread (&idx, sizeof (idx), 1, fd) == 1
+			&& fread (c, sizeof (RCoreZoomChunk), 1, fd) == 1
+			&& ht_up_insert (z->levels[0], idx, c);
+		if (!ok) {
+			free (c);
+		}
+	}
+	fclose (fd);
+}
+
+static bool save_chunk(void *user, const ut64 k, const void *v) {
+	FILE *fd = user;
+	return fwrite (&k, sizeof (k), 1, fd) == 1
+		&& fwrite (v, sizeof (RCoreZoomChunk), 1, fd) == 1;
+}
+
+static void zoom_save(RCore *core, RCoreZoom *z) {
+	ut64 mtime = 0;
+	char *path = zoom_cache_path (core, z, &mtime);
+	if (!path) {
+		return;
+	}
+	char *dir = r_file_dirname (path);
+	r_sys_mkdirp (dir);
+	free (dir);
+	FILE *fd = r_sandbox_fopen (path, "wb");
+	if (fd) {
+		ut64 hdr[3] = { z->size, mtime, z->levels[0]->count };
+		fwrite (ZOOM_MAGIC, 8, 1, fd);
+		fwrite (hdr, sizeof (hdr), 1, fd);
+		ht_up_foreach (z->levels[0], save_chunk, fd);
+		fclose (fd);
+	}
+	free (path);
+}
+
+static void zoom_kv_free(HtUPKv *kv) {
+	free (kv->value);
+}
+
+static RCoreZoom *zoom_new(RCore *core) {
+	RCoreZoom *z = R_NEW0 (RCoreZoom);
+	int i;
+	if (!z) {
+		return NULL;
+	}
+	z->fd = core->file? core->file->fd: -1;
+	z->va = core->io->va;
+	z->size = r_io_fd_size (core->io, z->fd);
+	z->layout = zoom_layout (core);
+	for (i = 0; i < ZOOM_LEVELS; i++) {
+		z->levels[i] = ht_up_new (NULL, zoom_kv_free, NULL);
+		if (!z->levels[i]) {
+			r_core_zoom_free (core, z);
+			return NULL;
+		}
+	}
+	if (r_config_get_i (core->config, "zoom.cache")) {
+		zoom_load (core, z);
+	}
+	return z;
+}
+
+R_API void r_core_zoom_free(RCore *core, RCoreZoom *z) {
+	int i;
+	if (!z) {
+		return;
+	}
+	if (z->dirty && !z->tainted && r_config_get_i (core->config, "zoom.cache")) {
+		zoom_save (core, z);
+	}
+	for (i = 0; i < ZOOM_LEVELS; i++) {
+		ht_up_free (z->levels[i]);
+	}
+	free (z);
+}
+
+// returns the pyramid for the current address space, NULL when disabled.
+// a debuggee changes its memory without going through io writes, so the
+// pyramid is never trusted while debugging
+static RCoreZoom *zoom_get(RCore *core) {
+	if (!r_config_get_i (core->config, "zoom.pyramid") || r_config_get_i (core->config, "cfg.debug")) {
+		return NULL;
+	}
+	bool va = core->io->va;
+	RCoreZoom *z = core->zoom[va];
+	if (z) {
+		int fd = core->file? core->file->fd: -1;
+		if (z->fd != fd || z->size != r_io_fd_size (core->io, fd) || z->layout != zoom_layout (core)) {
+			r_core_zoom_free (core, z);
+			z = NULL;
+		}
+	}
+	if (!z) {
+		z = core->zoom[va] = zoom_new (core);
+	}
+	return z;
+}
+
+static void zoom_count(const ut8 *buf, ut64 len, ut64 *hist) {
+	ut64 i;
+	for (i = 0; i < len; i++) {
+		hist[buf[i]]++;
+	}
+}
+
+static ut64 hist_count(int mode, const ut64 *hist) {
+	ut64 n = 0;
+	int i;
+	switch (mode) {
+	case '0':
+		return hist[0];
+	case 'F':
+		return hist[0xff];
+	case 'p':
+		for (i = 0; i < 256; i++) {
+			if (IS_PRINTABLE (i)) {
+				n += hist[i];
+			}
+		}
+		break;
+	}
+	return n;
+}
+
+static ut8 hist_entropy(const ut64 *hist, ut64 size) {
+	double h = r_hash_entropy_count (hist, size);
+	return (ut8) (255 * (size? h / log2 ((double) R_MIN (size, 256)): 0));
+}
+
+static bool zoom_read_hist(RCore *core, ut64 addr, ut64 len, ut64 *hist) {
+	if (!len) {
+		return true;
+	}
+	ut64 n = R_MIN (len, ZOOM_CHUNK);
+	ut8 *buf = malloc (n);
+	if (!buf) {
+		return false;
+	}
+	while (len > 0) {
+		n = R_MIN (len, ZOOM_CHUNK);
+		r_io_read_at (core->io, addr, buf, n);
+		zoom_count (buf, n, hist);
+		addr += n;
+		len -= n;
+	}
+	free (buf);
+	return true;
+}
+
+static RCoreZoomChunk *zoom_chunk(RCore *core, RCoreZoom *z, ut64 idx) {
+	RCoreZoomChunk *c = ht_up_find (z->levels[0], idx, NULL);
+	if (c) {
+		return c;
+	}
+	ut8 *buf = malloc (ZOOM_CHUNK);
+	c = R_NEW0 (RCoreZoomChunk);
+	if (!buf || !c) {
+		free (buf);
+		free (c);
+		return NULL;
+	}
+	int i, j;
+	r_io_read_at (core->io, idx * ZOOM_CHUNK, buf, ZOOM_CHUNK);
+	for (i = 0; i < ZOOM_PAGES; i++) {
+		ut64 hist[256] = {0};
+		RCoreZoomPage *page = &c->pages[i];
+		zoom_count (buf + i * ZOOM_PAGE, ZOOM_PAGE, hist);
+		page->zeros = hist[0];
+		page->ffs = hist[0xff];
+		page->printable = hist_count ('p', hist);
+		page->entropy = hist_entropy (hist, ZOOM_PAGE);
+		for (j = 0; j < 256; j++) {
+			c->hist[j] += hist[j];
+		}
+	}
+	free (buf);
+	ht_up_insert (z->levels[0], idx, c);
+	z->dirty = true;
+	return c;
+}
+
+static const ut64 *zoom_hist(RCore *core, RCoreZoom *z, int level, ut64 idx) {
+	if (!level) {
+		RCoreZoomChunk *c = zoom_chunk (core, z, idx);
+		return c? c->hist: NULL;
+	}
+	ut64 *hist = ht_up_find (z->levels[level], idx, NULL);
+	if (hist) {
+		return hist;
+	}
+	hist = calloc (256, sizeof (ut64));
+	if (!hist) {
+		return NULL;
+	}
+	int i, j;
+	for (i = 0; i < (1 << ZOOM_FANOUT); i++) {
+		const ut64 *child = zoom_hist (core, z, level - 1, (idx << ZOOM_FANOUT) + i);
+		if (!child) {
+			free (hist);
+			return NULL;
+		}
+		for (j = 0; j < 256; j++) {
+			hist[j] += child[j];
+		}
+	}
+	ht_up_insert (z->levels[level], idx, hist);
+	return hist;
+}
+
+// adds the histogram of the chunk aligned range [from, to) using the coarsest units
+static bool zoom_hist_range(RCore *core, RCoreZoom *z, ut64 from, ut64 to, ut64 *hist) {
+	ut64 x = from;
+	while (x < to) {
+		int j, level = ZOOM_LEVELS - 1;
+		for (; level > 0; level--) {
+			ut64 unit = zoom_unit (level);
+			if (!(x % unit) && x + unit > x && x + unit <= to) {
+				break;
+			}
+		}
+		const ut64 *h = zoom_hist (core, z, level, x / zoom_unit (level));
+		if (!h) {
+			return false;
+		}
+		for (j = 0; j < 256; j++) {
+			hist[j] += h[j];
+		}
+		x += zoom_unit (level);
+	}
+	return true;
+}
+
+// counts with page records where whole pages are covered, reading the rest
+static bool zoom_count_pages(RCore *core, RCoreZoom *z, int mode, ut64 from, ut64 to, ut64 *n) {
+	ut64 hist[256] = {0};
+	ut64 pfrom = R_ROUND (from, ZOOM_PAGE);
+	ut64 pto = to - (to % ZOOM_PAGE);
+	if (pfrom < from || pfrom >= pto) {
+		if (!zoom_read_hist (core, from, to - from, hist)) {
+			return false;
+		}
+		*n += hist_count (mode, hist);
+		return true;
+	}
+	if (!zoom_read_hist (core, from, pfrom - from, hist)
+	    || !zoom_read_hist (core, pto, to - pto, hist)) {
+		return false;
+	}
+	*n += hist_count (mode, hist);
+	ut64 x;
+	for (x = pfrom; x < pto; x += ZOOM_PAGE) {
+		RCoreZoomChunk *c = zoom_chunk (core, z, x / ZOOM_CHUNK);
+		if (!c) {
+			return false;
+		}
+		RCoreZoomPage *page = &c->pages[(x % ZOOM_CHUNK) / ZOOM_PAGE];
+		*n += (mode == '0')? page->zeros: (mode == 'F')? page->ffs: page->printable;
+	}
+	return true;
+}
+
+/* returns the entropy ('e', 0-255) or the number of zero ('0'), 0xff ('F')
+ * or printable ('p') bytes in [addr, addr + size), or -1 when the pyramid
+ * is disabled or cannot answer */
+R_API st64 r_core_zoom_stat(RCore *core, int mode, ut64 addr, ut64 size) {
+	r_return_val_if_fail (core, -1);
+	if (!size || !mode || !strchr ("e0Fp", mode)) {
+		return -1;
+	}
+	RCoreZoom *z = zoom_get (core);
+	if (!z) {
+		return -1;
+	}
+	ut64 to = (addr + size < addr)? UT64_MAX: addr + size;
+	ut64 cfrom = R_ROUND (addr, ZOOM_CHUNK);
+	ut64 cto = to - (to % ZOOM_CHUNK);
+	bool aligned = cfrom >= addr && cfrom < cto;
+	ut64 hist[256] = {0};
+	if (mode == 'e') {
+		if (size == ZOOM_PAGE && !(addr % ZOOM_PAGE)) {
+			RCoreZoomChunk *c = zoom_chunk (core, z, addr / ZOOM_CHUNK);
+			return c? c->pages[(addr % ZOOM_CHUNK) / ZOOM_PAGE].entropy: -1;
+		}
+		if (!aligned) {
+			return -1;
+		}
+		if (!zoom_read_hist (core, addr, cfrom - addr, hist)
+		    || !zoom_read_hist (core, cto, to - cto, hist)
+		    || !zoom_hist_range (core, z, cfrom, cto, hist)) {
+			return -1;
+		}
+		return hist_entropy (hist, to - addr);
+	}
+	ut64 n = 0;
+	if (!aligned) {
+		return zoom_count_pages (core, z, mode, addr, to, &n)? n: -1;
+	}
+	if (!zoom_count_pages (core, z, mode, addr, cfrom, &n)
+	    || !zoom_count_pages (core, z, mode, cto, to, &n)
+	    || !zoom_hist_range (core, z, cfrom, cto, hist)) {
+		return -1;
+	}
+	return n + hist_count (mode, hist);
+}
+
+static void zoom_invalidate(RCoreZoom *z, ut64 addr, ut64 len) {
+	ut64 last = (addr + len - 1 < addr)? UT64_MAX: addr + len - 1;
+	ut64 idx;
+	int i;
+	for (i = 0; i < ZOOM_LEVELS; i++) {
+		ut64 unit = zoom_unit (i);
+		for (idx = addr / unit; idx <= last / unit; idx++) {
+			ht_up_delete (z->levels[i], idx);
+		}
+	}
+	z->tainted = true;
+}
+
+// drops the statistics of the written range
+R_API void r_core_zoom_invalidate(RCore *core, ut64 addr, ut64 len) {
+	bool va = core->io->va;
+	if (!len) {
+		return;
+	}
+	if (core->zoom[va]) {
+		zoom_invalidate (core->zoom[va], addr, len);
+	}
+	// the other address space is not worth translating
+	if (core->zoom[!va]) {
+		core->zoom[!va]->tainted = true;
+		r_core_zoom_free (core, core->zoom[!va]);
+		core->zoom[!va] = NULL;
+	}
+}
+
+R_API void r_core_zoom_reset(RCore *core) {
+	r_core_zoom_free (core, core->zoom[0]);
+	r_core_zoom_free (core, core->zoom[1]);
+	core->zoom[0] = core->zoom[1] = NULL;
+}
@@ -3320,7 +3320,12 @@ static int agraph_print(RAGraph *g, int is_interactive, RCore *core, RAnalFuncti
 	}
 
 	if (is_interactive) {
-		r_cons_clear00 ();
+		if (r_cons_singleton ()->damage) {
+			// r_cons_visual_flush only repaints the lines that changed
+			r_cons_gotoxy (0, 0);
+		} else {
+			r_cons_clear00 ();
+		}
 	} else {
 		/* TODO: limit to screen size when the output is not redirected to file */
 		update_graph_sizes (g);
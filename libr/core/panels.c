@@ -2569,7 +2569,11 @@ R_API void r_core_panels_refresh(RCore *core) {
 	if (core->scr_gadgets) {
 		r_core_cmd0 (core, "pg");
 	}
-	r_cons_flush ();
+	if (core->cons->damage) {
+		r_cons_visual_flush ();
+	} else {
+		r_cons_flush ();
+	}
 }
 
 static void doPanelsRefresh(RCore *core) {
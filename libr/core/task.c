@@ -1,6 +1,11 @@
 /* radare - LGPL - Copyright 2014-2019 - pancake, thestr4ng3r */
 
 #include <r_core.h>
+#if __UNIX__
+#include <errno.h>
+#include <poll.h>
+#include <sys/wait.h>
+#endif
 
 #if HAVE_PTHREAD
 #define TASK_SIGSET_T sigset_t
@@ -54,7 +59,8 @@ R_API void r_core_task_print (RCore *core, RCoreTask *task, int mode) {
 			r_cons_print ("done");
 			break;
 		}
-		r_cons_printf ("\",\"transient\":%s,\"cmd\":", task->transient ? "true" : "false");
+		r_cons_printf ("\",\"transient\":%s,\"readonly\":%s,\"cmd\":",
+			task->transient ? "true" : "false", task->readonly ? "true" : "false");
 		if (task->cmd) {
 			r_cons_printf ("\"%s\"}", task->cmd);
 		} else {
@@ -69,7 +75,7 @@ R_API void r_core_task_print (RCore *core, RCoreTask *task, int mode) {
 		}
 		r_cons_printf ("%3d %3s %12s  %s\n",
 					   task->id,
-					   task->transient ? "(t)" : "",
+					   task->transient ? "(t)" : task->readonly ? "(r)" : "",
 					   r_core_task_status (task),
 					   info ? info : "");
 		}
@@ -353,6 +359,97 @@ static void task_end(RCoreTask *t) {
 	r_core_task_schedule (t, R_CORE_TASK_STATE_DONE);
 }
 
+#if __UNIX__
+/* Read-only tasks run in a forked copy of the process. The child sees
+ * analysis, flags and io exactly as they were when the task was
+ * dispatched and shares nothing writable with the parent, so it needs no
+ * locking and runs in parallel with every other task, while the parent
+ * thread sleeps on the pipe and lets the scheduler run the rest. */
+static bool task_desc_forkable(void *user, void *data, ut32 id) {
+	RIODesc *desc = (RIODesc *)data;
+	bool *ok = (bool *)user;
+	// sockets, ptrace and friends cannot be shared with a child
+	if (!desc->plugin || !desc->plugin->name
+			|| (strcmp (desc->plugin->name, "default") && strcmp (desc->plugin->name, "mmap"))) {
+		*ok = false;
+		return false;
+	}
+	return true;
+}
+
+static bool task_can_fork(RCore *core) {
+	// a child is not the tracer and cannot touch the debuggee
+	if (r_config_get_i (core->config, "cfg.debug")) {
+		return false;
+	}
+	bool ok = true;
+	if (core->io && core->io->files) {
+		r_id_storage_foreach (core->io->files, task_desc_forkable, &ok);
+	}
+	return ok;
+}
+
+static char *task_run_snapshot(RCoreTask *task) {
+	RCore *core = task->core;
+	int fds[2];
+	if (pipe (fds) == -1) {
+		return r_core_cmd_str (core, task->cmd);
+	}
+	TASK_SIGSET_T old_sigset;
+	// nobody can hold the tasks lock in the child
+	tasks_lock_enter (core, &old_sigset);
+	int pid = r_sys_fork ();
+	if (!pid) {
+		// this is the only thread left, there is no one to schedule
+		close (fds[0]);
+		core->tasks_queue = r_list_new ();
+		core->oneshot_queue = r_list_newf (free);
+		core->oneshots_enqueued = 0;
+		core->tasks_running = 1;
+		tasks_lock_leave (core, &old_sigset);
+		char *res = r_core_cmd_str (core, task->cmd);
+		size_t len = res? strlen (res): 0, off = 0;
+		while (off < len) {
+			ssize_t n = write (fds[1], res + off, len - off);
+			if (n < 1) {
+				break;
+			}
+			off += n;
+		}
+		_exit (0);
+	}
+	tasks_lock_leave (core, &old_sigset);
+	close (fds[1]);
+	if (pid == -1) {
+		close (fds[0]);
+		return r_core_cmd_str (core, task->cmd);
+	}
+	RStrBuf *sb = r_strbuf_new (NULL);
+	r_core_task_sleep_begin (task);
+	for (;;) {
+		struct pollfd pfd = { fds[0], POLLIN, 0 };
+		int ret = poll (&pfd, 1, 100);
+		if (task->cons_context && task->cons_context->breaked) {
+			kill (pid, SIGKILL);
+			break;
+		}
+		if (ret == 0 || (ret < 0 && errno == EINTR)) {
+			continue;
+		}
+		char buf[4096];
+		ssize_t n = ret > 0? read (fds[0], buf, sizeof (buf)): -1;
+		if (n < 1) {
+			break;
+		}
+		r_strbuf_append_n (sb, buf, n);
+	}
+	close (fds[0]);
+	waitpid (pid, NULL, 0);
+	r_core_task_sleep_end (task);
+	return r_strbuf_drain (sb);
+}
+#endif
+
 static RThreadFunctionRet task_run(RCoreTask *task) {
 	RCore *core = task->core;
 
@@ -367,7 +464,13 @@ static RThreadFunctionRet task_run(RCoreTask *task) {
 	if (task == task->core->main_task) {
 		r_core_cmd (core, task->cmd, task->cmd_log);
 		res_str = NULL;
-	} else {
+	}
+#if __UNIX__
+	else if (task->readonly && task_can_fork (core)) {
+		res_str = task_run_snapshot (task);
+	}
+#endif
+	else {
 		res_str = r_core_cmd_str (core, task->cmd);
 	}
 
@@ -3622,7 +3622,7 @@ static void visual_refresh(RCore *core) {
 
 	int w = visual_responsive (core);
 
-	if (autoblocksize) {
+	if (autoblocksize || core->cons->damage) {
 		r_cons_gotoxy (0, 0);
 	} else {
 		r_cons_clear ();
@@ -734,6 +734,165 @@ err:
 	return NULL;
 }
 
+typedef struct {
+	ut64 off;
+	ut32 size;
+	int name; // index in the batch strpool, already filtered
+	int realname; // index in the batch strpool or -1
+	const char *n; // name resolved at commit time, when the pool stops growing
+	RSpace *space;
+	int seq;
+} RFlagBatchItem;
+
+struct r_flag_batch_t {
+	RFlag *f;
+	RStrpool *names;
+	RFlagBatchItem *items;
+	int count;
+	int size;
+};
+
+R_API RFlagBatch *r_flag_batch_new(RFlag *f) {
+	r_return_val_if_fail (f, NULL);
+	RFlagBatch *b = R_NEW0 (RFlagBatch);
+	if (!b) {
+		return NULL;
+	}
+	b->f = f;
+	b->names = r_strpool_new (0);
+	if (!b->names) {
+		free (b);
+		return NULL;
+	}
+	return b;
+}
+
+R_API void r_flag_batch_free(RFlagBatch *b) {
+	if (b) {
+		r_strpool_free (b->names);
+		free (b->items);
+		free (b);
+	}
+}
+
+/* queue a flag to be set by r_flag_batch_commit in the current flag space,
+ * same as calling r_flag_set and r_flag_item_set_realname */
+R_API bool r_flag_batch_add(RFlagBatch *b, const char *name, const char *realname, ut64 off, ut32 size) {
+	r_return_val_if_fail (b && name && *name, false);
+	if (b->count >= b->size) {
+		int size = b->size? b->size * 2: 1024;
+		RFlagBatchItem *items = realloc (b->items, size * sizeof (RFlagBatchItem));
+		if (!items) {
+			return false;
+		}
+		b->items = items;
+		b->size = size;
+	}
+	RFlagBatchItem *bi = &b->items[b->count];
+	bi->name = r_strpool_append (b->names, name);
+	if (bi->name < 0) {
+		return false;
+	}
+	// filter in place, the name can only get shorter
+	char *n = r_strpool_get (b->names, bi->name);
+	r_str_trim (n);
+	r_name_filter (n, 0);
+	bi->realname = realname? r_strpool_append (b->names, realname): -1;
+	bi->off = off;
+	bi->size = size;
+	bi->space = r_flag_space_cur (b->f);
+	bi->seq = b->count++;
+	return true;
+}
+
+static int batch_cmp_name(const void *a, const void *b) {
+	const RFlagBatchItem *ia = a, *ib = b;
+	int r = strcmp (ia->n, ib->n);
+	return r? r: ia->seq - ib->seq;
+}
+
+static int batch_cmp_off(const void *a, const void *b) {
+	const RFlagBatchItem *ia = a, *ib = b;
+	if (ia->off != ib->off) {
+		return ia->off < ib->off? -1: 1;
+	}
+	return ia->seq - ib->seq;
+}
+
+/* set all the queued flags and empty the batch. Names are deduplicated
+ * keeping the last one queued and the items are inserted sorted by
+ * offset, so each offset is looked up once. Returns the number of
+ * flags set. */
+R_API int r_flag_batch_commit(RFlagBatch *b) {
+	r_return_val_if_fail (b, 0);
+	RFlag *f = b->f;
+	RFlagsAtOffset *at = NULL;
+	int i, n = 0, set = 0;
+	if (!b->count) {
+		return 0;
+	}
+	for (i = 0; i < b->count; i++) {
+		b->items[i].n = b->names->str + b->items[i].name;
+	}
+	qsort (b->items, b->count, sizeof (RFlagBatchItem), batch_cmp_name);
+	for (i = 0; i < b->count; i++) {
+		if (i + 1 < b->count && !strcmp (b->items[i].n, b->items[i + 1].n)) {
+			// overwritten by a later item, which keeps the last realname
+			if (b->items[i + 1].realname < 0) {
+				b->items[i + 1].realname = b->items[i].realname;
+			}
+			continue;
+		}
+		b->items[n++] = b->items[i];
+	}
+	qsort (b->items, n, sizeof (RFlagBatchItem), batch_cmp_off);
+	for (i = 0; i < n; i++) {
+		RFlagBatchItem *bi = &b->items[i];
+		const char *name = bi->n;
+		const char *realname = (bi->realname < 0)? NULL: b->names->str + bi->realname;
+		ut64 off = bi->off + f->base;
+		RFlagItem *item = ht_pp_find (f->ht_name, name, NULL);
+		if (item) {
+			// same as r_flag_set on an existing flag
+			if (item->offset != off) {
+				item->space = bi->space;
+				update_flag_item_offset (f, item, off, true);
+				at = NULL; // the offset list may be gone
+			}
+			item->size = bi->size;
+		} else {
+			item = R_NEW0 (RFlagItem);
+			if (!item) {
+				break;
+			}
+			item->name = strdup (name);
+			if (!item->name || !ht_pp_insert (f->ht_name, item->name, item)) {
+				free (item->name);
+				free (item);
+				continue;
+			}
+			item->realname = item->name;
+			item->space = bi->space;
+			item->size = bi->size;
+			item->offset = off;
+			if (!at || at->off != off) {
+				at = flags_at_offset (f, off);
+				if (!at) {
+					break;
+				}
+			}
+			r_list_append (at->flags, item);
+		}
+		if (realname) {
+			r_flag_item_set_realname (item, realname);
+		}
+		set++;
+	}
+	b->count = 0;
+	r_strpool_empty (b->names);
+	return set;
+}
+
 /* add/replace/remove the alias of a flag item */
 R_API void r_flag_item_set_alias(RFlagItem *item, const char *alias) {
 	r_return_if_fail (item);
@@ -865,6 +1024,34 @@ R_API int r_flag_relocate(RFlag *f, ut64 off, ut64 off_mask, ut64 to) {
 	return u.n;
 }
 
+static bool flag_collect_foreach(RFlagItem *fi, void *user) {
+	r_list_append ((RList *)user, fi);
+	return true;
+}
+
+/* move every flag in [from, to) by delta, used when a loaded object is
+ * rebased. Items are collected first because moving them changes by_off */
+R_API int r_flag_rebase(RFlag *f, ut64 from, ut64 to, st64 delta) {
+	r_return_val_if_fail (f, -1);
+	RListIter *iter;
+	RFlagItem *fi;
+	int n = 0;
+	if (!delta || from >= to) {
+		return 0;
+	}
+	RList *items = r_list_new ();
+	if (!items) {
+		return -1;
+	}
+	r_flag_foreach_range (f, from, to, flag_collect_foreach, items);
+	r_list_foreach (items, iter, fi) {
+		update_flag_item_offset (f, fi, fi->offset + delta, false);
+		n++;
+	}
+	r_list_free (items);
+	return n;
+}
+
 R_API bool r_flag_move(RFlag *f, ut64 at, ut64 to) {
 	r_return_val_if_fail (f, false);
 	RFlagItem *item = r_flag_get_i (f, at);
@@ -9,15 +9,13 @@
 #include <math.h>
 #include "r_types.h"
 
-R_API double r_hash_entropy(const ut8 *data, ut64 size) {
-	if (!data || !size) {
+// entropy of size bytes given the number of occurrences of each byte value
+R_API double r_hash_entropy_count(const ut64 *count, ut64 size) {
+	if (!count || !size) {
 		return 0;
 	}
-	ut64 i, count[256] = {0};
+	int i;
 	double h = 0;
-	for (i = 0; i < size; i++) {
-		count[data[i]]++;
-	}
 	for (i = 0; i < 256; i++) {
 		if (count[i]) {
 			double p = (double) count[i] / size;
@@ -26,6 +24,17 @@ R_API double r_hash_entropy(const ut8 *data, ut64 size) {
 	}
 	return h;
 }
+
+R_API double r_hash_entropy(const ut8 *data, ut64 size) {
+	if (!data || !size) {
+		return 0;
+	}
+	ut64 i, count[256] = {0};
+	for (i = 0; i < size; i++) {
+		count[data[i]]++;
+	}
+	return r_hash_entropy_count (count, size);
+}
 R_API double r_hash_entropy_fraction(const ut8 *data, ut64 size) {
 	return size ? r_hash_entropy (data, size) / \
 		log2 ((double) R_MIN (size, 256)) : 0;
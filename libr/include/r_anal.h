@@ -288,6 +288,7 @@ typedef struct r_anal_function_t {
 	bool folded;
 	bool is_pure;
 	bool has_changed; // true if function may have changed since last anaysis TODO: set this attribute where necessary
+	bool is_dirty; // bytes under its basic blocks were written after it was analyzed
 	RAnalType *args; // list of arguments
 	ut8 *fingerprint; // TODO: make is fuzzy and smarter
 	RAnalDiff *diff;
@@ -622,6 +623,14 @@ typedef enum {
 	R_ANAL_CPP_ABI_MSVC
 } RAnalCPPABI;
 
+/* objects recycled across an analysis session, see r_anal_pool_alloc */
+typedef enum {
+	R_ANAL_POOL_OP = 0,
+	R_ANAL_POOL_BB,
+	R_ANAL_POOL_REF,
+	R_ANAL_POOL_LAST
+} RAnalPoolType;
+
 typedef struct r_anal_hint_cb_t {
 	//add more cbs as needed
 	void (*on_bits) (struct r_anal_t *a, ut64 addr, int bits, bool set);
@@ -712,6 +721,9 @@ typedef struct r_anal_t {
 	int seggrn;
 	RFlagGetAtAddr flag_get;
 	REvent *ev;
+	RList *fcn_window; // bytes read while a function is being analyzed, shared by all its blocks
+	int fcn_window_refs;
+	RMemoryPool *pools[R_ANAL_POOL_LAST];
 } RAnal;
 
 typedef RAnalFunction *(* RAnalGetFcnIn)(RAnal *anal, ut64 addr, int type);
@@ -1186,6 +1198,7 @@ typedef RAnalBlock * (*RAnalBbFromBuffer)   (RAnal *a, ut64 addr, const ut8* buf
 typedef RAnalFunction * (*RAnalFnFromBuffer)(RAnal *a, ut64 addr, const ut8* buf, ut64 len);
 
 typedef int (*RAnalOpCallback)(RAnal *a, RAnalOp *op, ut64 addr, const ut8 *data, int len);
+typedef int (*RAnalOpBatchCallback)(RAnal *a, RAnalOp *ops, int nops, ut64 addr, const ut8 *data, int len);
 typedef int (*RAnalBbCallback)(RAnal *a, RAnalBlock *bb, ut64 addr, const ut8 *data, int len);
 typedef int (*RAnalFnCallback)(RAnal *a, RAnalFunction *fcn, ut64 addr, const ut8 *data, int len, int reftype);
 
@@ -1222,6 +1235,8 @@ typedef struct r_anal_plugin_t {
 
 	// legacy r_anal_functions
 	RAnalOpCallback op;
+	// optional, decodes consecutive ops setting up the disassembler once
+	RAnalOpBatchCallback op_batch;
 	RAnalBbCallback bb;
 	RAnalFnCallback fcn;
 
@@ -1326,6 +1341,8 @@ R_API void r_anal_set_user_ptr(RAnal *anal, void *user);
 R_API void r_anal_plugin_free (RAnalPlugin *p);
 R_API int r_anal_add(RAnal *anal, RAnalPlugin *foo);
 R_API int r_anal_archinfo(RAnal *anal, int query);
+R_API void *r_anal_pool_alloc(RAnal *anal, RAnalPoolType type);
+R_API void r_anal_pool_release(void *p);
 R_API bool r_anal_use(RAnal *anal, const char *name);
 R_API bool r_anal_set_reg_profile(RAnal *anal);
 R_API char *r_anal_get_reg_profile(RAnal *anal);
@@ -1344,7 +1361,7 @@ R_API bool r_anal_set_fcnsign(RAnal *anal, const char *name);
 R_API const char *r_anal_get_fcnsign(RAnal *anal, const char *sym);
 
 /* bb.c */
-R_API RAnalBlock *r_anal_bb_new(void);
+R_API RAnalBlock *r_anal_bb_new(RAnal *anal);
 R_API RList *r_anal_bb_list_new(void);
 R_API void r_anal_bb_free(RAnalBlock *bb);
 R_API int r_anal_bb(RAnal *anal, RAnalBlock *bb, ut64 addr, ut8 *buf, ut64 len, int head);
@@ -1360,7 +1377,7 @@ R_API RAnalBlock *r_anal_bb_get_jumpbb(RAnalFunction *fcn, RAnalBlock *bb);
 
 /* op.c */
 R_API const char *r_anal_stackop_tostring(int s);
-R_API RAnalOp *r_anal_op_new(void);
+R_API RAnalOp *r_anal_op_new(RAnal *anal);
 R_API void r_anal_op_free(void *op);
 R_API void r_anal_op_init(RAnalOp *op);
 R_API bool r_anal_op_fini(RAnalOp *op);
@@ -1369,6 +1386,8 @@ R_API bool r_anal_op_is_eob(RAnalOp *op);
 R_API RList *r_anal_op_list_new(void);
 R_API int r_anal_op(RAnal *anal, RAnalOp *op, ut64 addr,
 		const ut8 *data, int len, int mask);
+R_API int r_anal_op_batch(RAnal *anal, RAnalOp *ops, int nops, ut64 addr,
+		const ut8 *data, int len, int mask);
 R_API RAnalOp *r_anal_op_hexstr(RAnal *anal, ut64 addr,
 		const char *hexstr);
 R_API char *r_anal_op_to_string(RAnal *anal, RAnalOp *op);
@@ -1437,6 +1456,7 @@ R_API RAnalFunction *r_anal_get_fcn_in_bounds(RAnal *anal, ut64 addr, int type);
 R_API RAnalFunction *r_anal_fcn_find_name(RAnal *anal, const char *name);
 R_API RList *r_anal_fcn_list_new(void);
 R_API int r_anal_fcn_insert(RAnal *anal, RAnalFunction *fcn);
+R_API int r_anal_fcn_rebase(RAnal *anal, ut64 from, ut64 to, st64 delta);
 R_API void r_anal_fcn_free(void *fcn);
 R_API int r_anal_fcn(RAnal *anal, RAnalFunction *fcn, ut64 addr,
 		ut8 *buf, ut64 len, int reftype);
@@ -1444,6 +1464,7 @@ R_API int r_anal_fcn_add(RAnal *anal, ut64 addr, ut64 size,
 		const char *name, int type, RAnalDiff *diff);
 R_API int r_anal_fcn_del(RAnal *anal, ut64 addr);
 R_API int r_anal_fcn_del_locs(RAnal *anal, ut64 addr);
+R_API int r_anal_fcn_invalidate(RAnal *anal, ut64 addr, ut64 len);
 R_API bool r_anal_fcn_add_bb(RAnal *anal, RAnalFunction *fcn,
 		ut64 addr, ut64 size,
 		ut64 jump, ut64 fail, int type, RAnalDiff *diff);
@@ -1561,6 +1582,7 @@ R_API char *r_anal_fcn_format_sig(R_NONNULL RAnal *anal, R_NONNULL RAnalFunction
 
 /* project */
 R_API bool r_anal_xrefs_init (RAnal *anal);
+R_API int r_anal_xrefs_rebase(RAnal *anal, ut64 from, ut64 to, st64 delta);
 
 #define R_ANAL_THRESHOLDFCN 0.7F
 #define R_ANAL_THRESHOLDBB 0.7F
@@ -1655,6 +1677,7 @@ R_API RAnalMetaItem *r_meta_find(RAnal *m, ut64 off, int type, int where);
 R_API RAnalMetaItem *r_meta_find_any_except(RAnal *m, ut64 at, int type, int where);
 R_API RAnalMetaItem *r_meta_find_in(RAnal *m, ut64 off, int type, int where);
 R_API int r_meta_cleanup(RAnal *m, ut64 from, ut64 to);
+R_API int r_meta_rebase(RAnal *a, ut64 from, ut64 to, st64 delta);
 R_API const char *r_meta_type_to_string(int type);
 R_API RList *r_meta_enumerate(RAnal *a, int type);
 R_API int r_meta_list(RAnal *m, int type, int rad);
@@ -1670,8 +1693,10 @@ R_API void r_meta_print(RAnal *a, RAnalMetaItem *d, int rad, bool show_full);
 
 R_API void r_anal_build_range_on_hints (RAnal *a, ut64 addr, int bits);
 R_API void r_anal_merge_hint_ranges(RAnal *a);
+R_API void r_anal_hint_ranges_rebase(RAnal *a, ut64 from, ut64 to, st64 delta);
 //R_API void r_anal_hint_list (RAnal *anal, int mode);
 R_API void r_anal_hint_del (RAnal *anal, ut64 addr, int size);
+R_API int r_anal_hint_rebase(RAnal *anal, ut64 from, ut64 to, st64 delta);
 R_API void r_anal_hint_clear (RAnal *a);
 R_API RAnalHint *r_anal_hint_from_string(RAnal *a, ut64 addr, const char *str);
 R_API RAnalHint *r_anal_hint_at (RAnal *a, ut64 from);
@@ -7,6 +7,7 @@
 #include <r_list.h>
 #include <r_bin_dwarf.h>
 #include <r_pdb.h>
+#include <sdb/ht_uu.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -247,9 +248,26 @@ typedef struct r_bin_object_t {
 	int lang;
 	Sdb *kv;
 	Sdb *addr2klassmethod;
+	HtPP *demangled; // memoized r_bin_demangle results, NULL when it failed
 	void *bin_obj; // internal pointer used by formats
 } RBinObject;
 
+typedef struct r_bin_addrline_t {
+	ut64 addr;
+	ut32 file; // index in RBinAddrLineStore.files
+	ut32 line;
+} RBinAddrLine;
+
+typedef struct r_bin_addrline_store_t {
+	RVector rows; // RBinAddrLine, sorted by address on the first query
+	RPVector files; // interned file names
+	HtPP *file_ids; // file name -> index in files
+	RVector *by_line; // rows sorted by file and line, built on demand
+	bool sorted;
+} RBinAddrLineStore;
+
+typedef bool (*RBinAddrLineCallback)(void *user, const RBinAddrLine *row, const char *file);
+
 // XXX: RbinFile may hold more than one RBinObject
 /// XX curplugin == o->plugin
 typedef struct r_bin_file_t {
@@ -275,6 +293,8 @@ typedef struct r_bin_file_t {
 	Sdb *sdb;
 	Sdb *sdb_info;
 	Sdb *sdb_addrinfo;
+	RBinAddrLineStore *addrline; // line table parsed from the debug info
+	RBinDwarfIndex *dwarf_index; // .debug_info units, decoded on demand
 	struct r_bin_t *rbin;
 } RBinFile;
 
@@ -726,6 +746,14 @@ R_API RBinSection *r_bin_get_section_at(RBinObject *o, ut64 off, int va);
 /* dbginfo.c */
 R_API int r_bin_addr2line(RBin *bin, ut64 addr, char *file, int len, int *line);
 R_API char *r_bin_addr2text(RBin *bin, ut64 addr, int origin);
+R_API RBinAddrLineStore *r_bin_addrline_new(void);
+R_API void r_bin_addrline_free(RBinAddrLineStore *s);
+R_API bool r_bin_addrline_add(RBinAddrLineStore *s, ut64 addr, const char *file, ut32 line);
+R_API const RBinAddrLine *r_bin_addrline_get(RBinAddrLineStore *s, ut64 addr);
+R_API const char *r_bin_addrline_file(RBinAddrLineStore *s, const RBinAddrLine *row);
+R_API ut64 r_bin_addrline_find(RBinAddrLineStore *s, const char *file, ut32 line);
+R_API bool r_bin_addrline_del(RBinAddrLineStore *s, ut64 addr);
+R_API void r_bin_addrline_foreach(RBinAddrLineStore *s, RBinAddrLineCallback cb, void *user);
 R_API char *r_bin_addr2fileline(RBin *bin, ut64 addr);
 /* bin_write.c */
 R_API bool r_bin_wr_addlib(RBin *bin, const char *lib);
@@ -735,6 +763,7 @@ R_API bool r_bin_wr_rpath_del(RBin *bin);
 R_API bool r_bin_wr_entry(RBin *bin, ut64 addr);
 R_API bool r_bin_wr_output(RBin *bin, const char *filename);
 R_API int r_bin_dwarf_parse_info(RBinDwarfDebugAbbrev *da, RBin *a, int mode);
+R_API RBinDwarfIndex *r_bin_dwarf_index_new(RBin *a);
 R_API RList *r_bin_dwarf_parse_line(RBin *a, int mode);
 R_API RList *r_bin_dwarf_parse_aranges(RBin *a, int mode);
 R_API RBinDwarfDebugAbbrev *r_bin_dwarf_parse_abbrev(RBin *a, int mode);
@@ -745,8 +774,8 @@ R_API RList *r_bin_get_mem(RBin *bin);
 R_API void r_bin_load_filter(RBin *bin, ut64 rules);
 R_API void r_bin_filter_symbols(RBinFile *bf, RList *list);
 R_API void r_bin_filter_sections(RBinFile *bf, RList *list);
-R_API char *r_bin_filter_name(RBinFile *bf, Sdb *db, ut64 addr, char *name);
-R_API void r_bin_filter_sym(RBinFile *bf, Sdb *db, ut64 vaddr, RBinSymbol *sym);
+R_API char *r_bin_filter_name(RBinFile *bf, HtUU *db, ut64 addr, char *name);
+R_API void r_bin_filter_sym(RBinFile *bf, HtUU *db, ut64 vaddr, RBinSymbol *sym);
 R_API bool r_bin_strpurge(RBin *bin, const char *str, ut64 addr);
 R_API bool r_bin_string_filter(RBin *bin, const char *str, ut64 addr);
 R_API bool r_bin_is_cxx(RBinFile *binfile);
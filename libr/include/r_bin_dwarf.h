@@ -685,6 +685,39 @@ typedef struct {
 	RBinDwarfAbbrevDecl *decls;
 } RBinDwarfDebugAbbrev;
 
+typedef struct {
+	ut64 from;
+	ut64 to;
+	ut64 info_offset;
+} RBinDwarfARange;
+
+typedef struct {
+	RBinDwarfCompUnitHdr hdr;
+	ut64 offset;		// unit header offset in .debug_info
+	size_t abbrev_idx;	// first abbrev decl of the unit
+	bool abbrev_found;
+	bool broken;		// DIE decoding stopped early
+	RBinDwarfCompUnit *cu;	// decoded DIEs, NULL until queried
+	ut64 used;		// lru tick
+} RBinDwarfUnit;
+
+#define R_BIN_DWARF_CU_CACHE	64
+#define R_BIN_DWARF_LOAD_THREADS	4
+
+typedef struct r_bin_dwarf_index_t {
+	ut8 *info;
+	size_t info_len;
+	ut8 *str;
+	size_t str_len;
+	RBinDwarfDebugAbbrev *da;
+	RVector units;		// RBinDwarfUnit sorted by offset
+	RVector aranges;	// RBinDwarfARange sorted by address
+	size_t cached;
+	size_t cache_max;	// 0 keeps every decoded unit
+	ut64 tick;
+	bool owned;
+} RBinDwarfIndex;
+
 #define		DWARF_FALSE	0
 #define		DWARF_TRUE	1
 
@@ -731,6 +764,12 @@ R_API int r_bin_dwarf_parse_info_raw(Sdb *s, RBinDwarfDebugAbbrev *da,
 		const ut8 *debug_str, size_t debug_str_len, int mode);
 
 R_API void r_bin_dwarf_free_debug_abbrev(RBinDwarfDebugAbbrev *da);
+R_API void r_bin_dwarf_index_free(RBinDwarfIndex *ix);
+R_API size_t r_bin_dwarf_index_count(RBinDwarfIndex *ix);
+R_API const RBinDwarfCompUnit *r_bin_dwarf_index_get(RBinDwarfIndex *ix, size_t n);
+R_API const RBinDwarfCompUnit *r_bin_dwarf_index_at(RBinDwarfIndex *ix, ut64 addr);
+R_API bool r_bin_dwarf_index_load(RBinDwarfIndex *ix, int threads);
+R_API const char *r_bin_dwarf_unit_str(const RBinDwarfCompUnit *cu, ut64 attr);
 #ifdef __cplusplus
 }
 #endif
@@ -483,6 +483,10 @@ typedef struct r_cons_t {
 	bool use_tts;
 	bool filter;
 	char* (*rgbstr)(char *str, size_t sz, ut64 addr);
+	bool damage; // only redraw the lines that changed between visual frames
+	char **frame; // lines presented in the last visual frame
+	int frame_rows;
+	int frame_columns;
 	// TODO: move into instance? + avoid unnecessary copies
 } RCons;
 
@@ -755,6 +759,7 @@ R_API void r_cons_2048(bool color);
 R_API void r_cons_memset(char ch, int len);
 R_API void r_cons_visual_flush(void);
 R_API void r_cons_visual_write(char *buffer);
+R_API void r_cons_visual_invalidate(void);
 R_API int r_cons_is_utf8(void);
 R_API void r_cons_cmd_help(const char * help[], bool use_color);
 R_API void r_cons_log_stub(const char *output, const char *funcname, const char *filename,
@@ -134,6 +134,8 @@ typedef struct r_core_file_t {
 	ut8 alive;
 } RCoreFile;
 
+typedef struct r_core_zoom_t RCoreZoom;
+
 typedef struct r_core_times_t {
 	ut64 loadlibs_init_time;
 	ut64 loadlibs_time;
@@ -316,6 +318,7 @@ typedef struct r_core_t {
 	bool scr_gadgets;
 	bool log_events; // core.c:cb_event_handler : log actions from events if cfg.log.events is set
 	RList *ropchain;
+	RCoreZoom *zoom[2]; // block stats pyramids for physical and virtual addresses
 } RCore;
 
 R_API int r_core_bind(RCore *core, RCoreBind *bnd);
@@ -512,6 +515,12 @@ R_API RAnalOp *r_core_op_anal(RCore *core, ut64 addr);
 R_API char *r_core_disassemble_instr(RCore *core, ut64 addr, int l);
 R_API char *r_core_disassemble_bytes(RCore *core, ut64 addr, int b);
 
+/* czoom.c */
+R_API st64 r_core_zoom_stat(RCore *core, int mode, ut64 addr, ut64 size);
+R_API void r_core_zoom_invalidate(RCore *core, ut64 addr, ut64 len);
+R_API void r_core_zoom_reset(RCore *core);
+R_API void r_core_zoom_free(RCore *core, RCoreZoom *z);
+
 /* carg.c */
 R_API RList *r_core_get_func_args(RCore *core, const char *func_name);
 R_API void r_core_print_func_args(RCore *core);
@@ -527,6 +536,10 @@ R_API void r_core_anal_fcn_merge (RCore *core, ut64 addr, ut64 addr2);
 R_API const char *r_core_anal_optype_colorfor(RCore *core, ut64 addr, bool verbose);
 R_API ut64 r_core_anal_address (RCore *core, ut64 addr);
 R_API void r_core_anal_undefine (RCore *core, ut64 off);
+R_API int r_core_anal_dirty (RCore *core);
+R_API char *r_core_anal_cache_path (RCore *core, const char *level);
+R_API bool r_core_anal_cache_load (RCore *core, const char *path);
+R_API bool r_core_anal_cache_save (RCore *core, const char *path);
 R_API void r_core_anal_hint_print (RAnal* a, ut64 addr, int mode);
 R_API void r_core_anal_hint_list (RAnal *a, int mode);
 R_API int r_core_anal_search(RCore *core, ut64 from, ut64 to, ut64 ref, int mode);
@@ -808,6 +821,7 @@ typedef struct r_core_task_t {
 	int id;
 	RTaskState state;
 	bool transient; // delete when finished
+	bool readonly; // runs on a snapshot of the core, in parallel with other tasks
 	int refcount;
 	RThreadSemaphore *running_sem;
 	void *user;
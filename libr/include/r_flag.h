@@ -47,6 +47,8 @@ typedef struct r_flag_item_t {
 	char *alias;    /* used to define a flag based on a math expression (e.g. foo + 3) */
 } RFlagItem;
 
+typedef struct r_flag_batch_t RFlagBatch;
+
 typedef struct r_flag_t {
 	RSpaces spaces;   /* handle flag spaces */
 	st64 base;         /* base address for all flag items */
@@ -115,6 +117,10 @@ R_API bool r_flag_unset_off(RFlag *f, ut64 addr);
 R_API void r_flag_unset_all (RFlag *f);
 R_API RFlagItem *r_flag_set(RFlag *fo, const char *name, ut64 addr, ut32 size);
 R_API RFlagItem *r_flag_set_next(RFlag *fo, const char *name, ut64 addr, ut32 size);
+R_API RFlagBatch *r_flag_batch_new(RFlag *f);
+R_API void r_flag_batch_free(RFlagBatch *b);
+R_API bool r_flag_batch_add(RFlagBatch *b, const char *name, const char *realname, ut64 off, ut32 size);
+R_API int r_flag_batch_commit(RFlagBatch *b);
 R_API void r_flag_item_set_alias(RFlagItem *item, const char *alias);
 R_API void r_flag_item_free (RFlagItem *item);
 R_API void r_flag_item_set_comment(RFlagItem *item, const char *comment);
@@ -123,6 +129,7 @@ R_API RFlagItem *r_flag_item_clone(RFlagItem *item);
 R_API int r_flag_unset_glob(RFlag *f, const char *name);
 R_API int r_flag_rename(RFlag *f, RFlagItem *item, const char *name);
 R_API int r_flag_relocate(RFlag *f, ut64 off, ut64 off_mask, ut64 to);
+R_API int r_flag_rebase(RFlag *f, ut64 from, ut64 to, st64 delta);
 R_API bool r_flag_move (RFlag *f, ut64 at, ut64 to);
 R_API const char *r_flag_color(RFlag *f, RFlagItem *it, const char *color);
 R_API int r_flag_count(RFlag *f, const char *glob);
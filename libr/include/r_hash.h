@@ -498,6 +498,7 @@ R_API utcrc r_hash_crc_preset (const ut8 *data, ut32 size, enum CRC_PRESETS pres
 /* analysis */
 R_API ut8  r_hash_hamdist(const ut8 *buf, int len);
 R_API double r_hash_entropy(const ut8 *data, ut64 len);
+R_API double r_hash_entropy_count(const ut64 *count, ut64 len);
 R_API double r_hash_entropy_fraction(const ut8 *data, ut64 len);
 R_API int r_hash_pcprint(const ut8 *buffer, ut64 len);
 
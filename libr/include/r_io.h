@@ -88,6 +88,7 @@ typedef struct r_io_t {
 	int cached;
 	bool cachemode; // write in cache all the read operations (EXPERIMENTAL)
 	int p_cache;
+	bool rapcache; // keep the reads of rap v2 sessions (rap.cache)
 	int debug;
 //#warning remove debug from RIO
 	RIDPool *map_ids;
@@ -139,6 +140,14 @@ typedef struct {
 	RSocket *fd;
 	RSocket *client;
 	int listener;
+	int caps;	// negotiated rap v2 capabilities
+	ut32 window;
+	ut32 tag;
+	ut64 off;	// local seek when caps has RAP_CAP_PREAD
+	ut64 size;
+	ut8 *cache;
+	ut64 *cache_addr;
+	ut32 *cache_len;
 } RIORap;
 
 #define RMT_MAX    4096
@@ -149,6 +158,8 @@ typedef struct {
 #define RMT_CLOSE  0x05
 #define RMT_SYSTEM 0x06
 #define RMT_CMD    0x07
+#define RMT_PREAD  0x08
+#define RMT_PWRITE 0x09
 #define RMT_REPLY  0x80
 
 typedef struct r_io_plugin_t {
@@ -170,6 +181,9 @@ typedef struct r_io_plugin_t {
 	int (*read)(RIO *io, RIODesc *fd, ut8 *buf, int count);
 	ut64 (*lseek)(RIO *io, RIODesc *fd, ut64 offset, int whence);
 	int (*write)(RIO *io, RIODesc *fd, const ut8 *buf, int count);
+	// optional positional io, must not depend on the seek state of the desc
+	st64 (*read_at)(RIO *io, RIODesc *fd, ut64 addr, ut8 *buf, ut64 count);
+	st64 (*write_at)(RIO *io, RIODesc *fd, ut64 addr, const ut8 *buf, ut64 count);
 	int (*close)(RIODesc *desc);
 	bool (*is_blockdevice)(RIODesc *desc);
 	bool (*is_chardevice)(RIODesc *desc);
@@ -351,8 +365,8 @@ R_API int r_io_plugin_list(RIO *io);
 R_API int r_io_plugin_list_json(RIO *io);
 R_API int r_io_plugin_read(RIODesc *desc, ut8 *buf, int len);
 R_API int r_io_plugin_write(RIODesc *desc, const ut8 *buf, int len);
-R_API int r_io_plugin_read_at(RIODesc *desc, ut64 addr, ut8 *buf, int len);
-R_API int r_io_plugin_write_at(RIODesc *desc, ut64 addr, const ut8 *buf, int len);
+R_API st64 r_io_plugin_read_at(RIODesc *desc, ut64 addr, ut8 *buf, ut64 len);
+R_API st64 r_io_plugin_write_at(RIODesc *desc, ut64 addr, const ut8 *buf, ut64 len);
 R_API RIOPlugin *r_io_plugin_resolve(RIO *io, const char *filename, bool many);
 R_API RIOPlugin *r_io_plugin_resolve_fd(RIO *io, int fd);
 R_API RIOPlugin *r_io_plugin_get_default(RIO *io, const char *filename, bool many);
@@ -401,8 +415,8 @@ R_API bool r_io_desc_is_dbg (RIODesc *desc);
 R_API int r_io_desc_get_pid (RIODesc *desc);
 R_API int r_io_desc_get_tid (RIODesc *desc);
 R_API bool r_io_desc_get_base (RIODesc *desc, ut64 *base);
-R_API int r_io_desc_read_at (RIODesc *desc, ut64 addr, ut8 *buf, int len);
-R_API int r_io_desc_write_at (RIODesc *desc, ut64 addr, const ut8 *buf, int len);
+R_API st64 r_io_desc_read_at (RIODesc *desc, ut64 addr, ut8 *buf, ut64 len);
+R_API st64 r_io_desc_write_at (RIODesc *desc, ut64 addr, const ut8 *buf, ut64 len);
 R_API bool r_io_desc_fini (RIO *io);
 
 /* io/cache.c */
@@ -44,6 +44,14 @@ R_LIB_VERSION_HEADER (r_socket);
 #define SD_SEND 1
 #define SD_BOTH 2
 #endif
+/* framed r2pipe: the client sends R2PIPE_FRAMED_HELLO as a plain command
+ * and switches only if the reply is R2PIPE_FRAMED_ACK, older servers just
+ * echo the hello back. Then each request is a be32 length, a be32 id and
+ * the command, and each reply a be32 length, the same id and the output */
+#define R2PIPE_FRAMED_HELLO "?e r2pipe.framed=0"
+#define R2PIPE_FRAMED_ACK "r2pipe.framed=1\n"
+#define R2PIPE_FRAME_HDR 8
+
 typedef struct {
 	int child;
 #if __WINDOWS__
@@ -53,6 +61,14 @@ typedef struct {
 	int output[2];
 #endif
 	RCoreBind coreb;
+	bool framed;
+	ut32 id; // id of the last framed request
+	ut8 *buf; // replies read in bulk but not consumed yet
+	int buf_len;
+	int buf_off;
+	int buf_size;
+	ut8 *wbuf; // reused to build the requests
+	int wbuf_size;
 } R2Pipe;
 
 typedef struct r_socket_t {
@@ -168,10 +184,31 @@ enum {
 	RAP_RMT_CLOSE = 5,
 	// system was deprecated in slot 6,
 	RAP_RMT_CMD = 7,
+	RAP_RMT_PREAD = 8,
+	RAP_RMT_PWRITE = 9,
 	RAP_RMT_REPLY = 0x80,
 	RAP_RMT_MAX = 4096
 };
 
+/* rap v2 is negotiated on top of v1: the client sends RAP_HELLO followed by
+ * its capabilities as a RAP_RMT_CMD, a v1 server just runs the command and
+ * echoes it back, a v2 one replies RAP_HELLO_REPLY "<caps>,<window>".
+ * After that PREAD/PWRITE can be used and pipelined:
+ *   PREAD   op tag[4] off[8] len[8]
+ *   reply   op|REPLY tag[4] flags[1] len[8] wlen[4] data[wlen]
+ *   PWRITE  op tag[4] off[8] len[8] data[len]
+ *   reply   op|REPLY tag[4] written[8]
+ * all values are big endian, len never exceeds the negotiated window and
+ * flags has RAP_CAP_LZ4 set when data is an lz4 block of len bytes */
+#define RAP_HELLO "?e rap.hello="
+#define RAP_HELLO_REPLY "rap.v2="
+#define RAP_CAP_PREAD 1
+#define RAP_CAP_LZ4 2
+#define RAP_WINDOW (1024 * 1024)
+#define RAP_PREAD_SIZE 21
+#define RAP_PREAD_REPLY_SIZE 18
+#define RAP_PWRITE_REPLY_SIZE 13
+
 typedef struct r_socket_rap_server_t {
 	RSocket *fd;
 	char *port;
@@ -184,6 +221,7 @@ typedef struct r_socket_rap_server_t {
 	rap_server_cmd cmd;
 	rap_server_close close;
 	void *user;	// Always first arg for callbacks
+	int caps;	// negotiated rap v2 capabilities
 } RSocketRapServer;
 
 R_API RSocketRapServer *r_socket_rap_server_new(int is_ssl, const char *port);
@@ -193,6 +231,16 @@ R_API int r_socket_rap_server_listen(RSocketRapServer *rap_s, const char *certfi
 R_API RSocket *r_socket_rap_server_accept(RSocketRapServer *rap_s);
 R_API bool r_socket_rap_server_continue(RSocketRapServer *rap_s);
 
+/* rap.c */
+R_API bool r_socket_rap_read(RSocket *s, ut8 *buf, ut64 len);
+R_API char *r_socket_rap_hello(const char *cmd, int caps, int *ocaps);
+R_API bool r_socket_rap_pread(RSocket *s, ut32 tag, const ut64 *off, const ut64 *len, int n);
+R_API bool r_socket_rap_pread_reply(RSocket *s, ut32 tag, const ut8 *buf, ut64 len, int caps);
+R_API st64 r_socket_rap_pread_recv(RSocket *s, ut32 tag, ut8 *buf, ut64 len);
+R_API bool r_socket_rap_pwrite(RSocket *s, ut32 tag, ut64 off, const ut8 *buf, ut64 len);
+R_API bool r_socket_rap_pwrite_reply(RSocket *s, ut32 tag, ut64 written);
+R_API st64 r_socket_rap_pwrite_recv(RSocket *s, ut32 tag);
+
 /* run.c */
 #define R_RUN_PROFILE_NARGS 512
 typedef struct r_run_profile_t {
@@ -264,6 +312,10 @@ R_API R2Pipe *r2pipe_open_corebind(RCoreBind *coreb);
 R_API R2Pipe *r2pipe_open(const char *cmd);
 R_API char *r2pipe_cmd(R2Pipe *r2pipe, const char *str);
 R_API char *r2pipe_cmdf(R2Pipe *r2pipe, const char *fmt, ...);
+R_API bool r2pipe_framed(R2Pipe *r2pipe);
+R_API ut32 r2pipe_send(R2Pipe *r2pipe, const char *cmd);
+R_API char *r2pipe_recv(R2Pipe *r2pipe, ut32 *id, int *len);
+R_API bool r2pipe_frame_write(int fd, ut32 id, const void *data, ut32 len);
 #endif
 
 #ifdef __cplusplus
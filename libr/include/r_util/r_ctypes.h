@@ -17,6 +17,9 @@ enum RTypeKind {
 	R_TYPE_UNION = 3,
 };
 
+R_API bool r_type_cache_init(Sdb *TDB);
+R_API void r_type_cache_fini(Sdb *TDB);
+R_API void r_type_cache_invalidate(Sdb *TDB);
 R_API int r_type_set(Sdb *TDB, ut64 at, const char *field, ut64 val);
 R_API void r_type_del(Sdb *TDB, const char *name);
 R_API int r_type_kind(Sdb *TDB, const char *name);
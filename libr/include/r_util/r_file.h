@@ -24,6 +24,9 @@ R_API const char *r_file_basename(const char *path);
 R_API char *r_file_dirname(const char *path);
 R_API char *r_file_abspath(const char *file);
 R_API ut8 *r_inflate(const ut8 *src, int srcLen, int *srcConsumed, int *dstLen);
+R_API int r_lz4_bound(int len);
+R_API int r_lz4_compress(const ut8 *src, int len, ut8 *dst, int dst_len);
+R_API int r_lz4_decompress(const ut8 *src, int len, ut8 *dst, int dst_len);
 R_API ut8 *r_file_gzslurp(const char *str, int *outlen, int origonfail);
 R_API char *r_stdin_slurp(int *sz);
 R_API char *r_file_slurp(const char *str, int *usz);
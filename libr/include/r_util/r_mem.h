@@ -25,6 +25,14 @@ typedef struct r_mem_pool_t {
 	int nodesize;
 	int poolsize;
 	int poolcount;
+	void *freelist;
+	bool nopool; // fallback to malloc/free, set with R2_NOPOOL=1
+	bool dropped; // freed by the release of the last live node
+	struct r_th_lock_t *lock; // alloc and release can be called from any thread
+	ut64 nalloc;
+	ut64 nrelease;
+	ut64 live;
+	ut64 peak;
 } RMemoryPool;
 
 R_API ut64 r_mem_get_num(const ut8 *b, int size);
@@ -34,6 +42,8 @@ R_API RMemoryPool* r_mem_pool_deinit(RMemoryPool *pool);
 R_API RMemoryPool *r_mem_pool_new(int nodesize, int poolsize, int poolcount);
 R_API RMemoryPool *r_mem_pool_free(RMemoryPool *pool);
 R_API void* r_mem_pool_alloc(RMemoryPool *pool);
+R_API void r_mem_pool_release(RMemoryPool *pool, void *p);
+R_API void r_mem_pool_drop(RMemoryPool *pool);
 R_API void *r_mem_dup(void *s, int l);
 R_API void *r_mem_alloc(int sz);
 R_API void r_mem_free(void *);
@@ -9,5 +9,6 @@
 #include "ht_inc.h"
 
 SDB_API HtName_(Ht)* Ht_(new0)(void);
+SDB_API HtName_(Ht)* Ht_(new_size)(ut32 initial_size);
 
 #endif
@@ -58,6 +58,7 @@ extern char *strdup (const char *);
 #define SDB_MAX_PATH 256
 #define SDB_NUM_BASE 16
 #define SDB_NUM_BUFSZ 64
+#define SDB_NUMKEY_BUFSZ 128
 
 #define SDB_OPTION_NONE 0
 #define SDB_OPTION_ALL 0xff
@@ -95,6 +96,7 @@ typedef struct sdb_t {
 	int ns_lock; // TODO: merge into options?
 	SdbList *ns;
 	SdbList *hooks;
+	SdbList *layers; // read-only cdb files below this one, newest first
 	SdbKv tmpkv;
 	ut32 depth;
 	bool timestamped;
@@ -117,6 +119,7 @@ SDB_API void sdb_config(Sdb *s, int options);
 SDB_API bool sdb_free(Sdb* s);
 SDB_API void sdb_file(Sdb* s, const char *dir);
 SDB_API bool sdb_merge(Sdb* d, Sdb *s);
+SDB_API bool sdb_layer(Sdb *s, const char *file);
 SDB_API int sdb_count(Sdb* s);
 SDB_API void sdb_reset(Sdb* s);
 SDB_API void sdb_setup(Sdb* s, int options);
@@ -139,11 +142,13 @@ SDB_API int sdb_query_file(Sdb *s, const char* file);
 SDB_API bool sdb_exists(Sdb*, const char *key);
 SDB_API bool sdb_remove(Sdb*, const char *key, ut32 cas);
 SDB_API int sdb_unset(Sdb*, const char *key, ut32 cas);
+SDB_API int sdb_unset_at(Sdb*, const char *prefix, ut64 n, ut32 cas);
 SDB_API int sdb_unset_like(Sdb *s, const char *k);
 SDB_API char** sdb_like(Sdb *s, const char *k, const char *v, SdbForeachCallback cb);
 
 // Gets a pointer to the value associated with `key`.
 SDB_API char *sdb_get(Sdb*, const char *key, ut32 *cas);
+SDB_API char *sdb_get_at(Sdb*, const char *prefix, ut64 n, ut32 *cas);
 
 // Gets a pointer to the value associated with `key` and returns in `vlen` the
 // length of the value string.
@@ -151,11 +156,13 @@ SDB_API char *sdb_get_len(Sdb*, const char *key, int *vlen, ut32 *cas);
 
 // Gets a const pointer to the value associated with `key`
 SDB_API const char *sdb_const_get(Sdb*, const char *key, ut32 *cas);
+SDB_API const char *sdb_const_get_at(Sdb*, const char *prefix, ut64 n, ut32 *cas);
 
 // Gets a const pointer to the value associated with `key` and returns in
 // `vlen` the length of the value string.
 SDB_API const char *sdb_const_get_len(Sdb* s, const char *key, int *vlen, ut32 *cas);
 SDB_API int sdb_set(Sdb*, const char *key, const char *data, ut32 cas);
+SDB_API int sdb_set_at(Sdb*, const char *prefix, ut64 n, const char *data, ut32 cas);
 SDB_API int sdb_set_owned(Sdb* s, const char *key, char *val, ut32 cas);
 SDB_API int sdb_concat(Sdb *s, const char *key, const char *value, ut32 cas);
 SDB_API int sdb_uncat(Sdb *s, const char *key, const char *value, ut32 cas);
@@ -168,6 +175,8 @@ SDB_API bool sdb_num_exists(Sdb*, const char *key);
 SDB_API int  sdb_num_base(const char *s);
 SDB_API ut64 sdb_num_get(Sdb* s, const char *key, ut32 *cas);
 SDB_API int  sdb_num_set(Sdb* s, const char *key, ut64 v, ut32 cas);
+SDB_API ut64 sdb_num_get_at(Sdb* s, const char *prefix, ut64 n, ut32 *cas);
+SDB_API int  sdb_num_set_at(Sdb* s, const char *prefix, ut64 n, ut64 v, ut32 cas);
 SDB_API int  sdb_num_add(Sdb *s, const char *key, ut64 v, ut32 cas);
 SDB_API ut64 sdb_num_inc(Sdb* s, const char *key, ut64 n, ut32 cas);
 SDB_API ut64 sdb_num_dec(Sdb* s, const char *key, ut64 n, ut32 cas);
@@ -199,6 +208,7 @@ SDB_API bool sdb_journal_unlink(Sdb *s);
 
 /* numeric */
 SDB_API char *sdb_itoa(ut64 n, char *s, int base);
+SDB_API char *sdb_numkey(char *buf, size_t size, const char *prefix, ut64 n, const char *suffix);
 SDB_API ut64  sdb_atoi(const char *s);
 SDB_API const char *sdb_itoca(ut64 n);
 
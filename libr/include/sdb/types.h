@@ -19,6 +19,16 @@
 #endif
 #endif
 
+#ifndef SDB_THREAD_LOCAL
+#if defined(_MSC_VER)
+#define SDB_THREAD_LOCAL __declspec(thread)
+#elif defined(__TINYC__)
+#define SDB_THREAD_LOCAL
+#else
+#define SDB_THREAD_LOCAL __thread
+#endif
+#endif
+
 #ifndef SDB_IPI
 #if defined(__GNUC__) && __GNUC__ >= 4
 // __attribute__((visibility("hidden")))
@@ -319,18 +319,83 @@ R_API bool r_io_desc_get_base (RIODesc *desc, ut64 *base) {
 	return desc->plugin->getbase (desc, base);
 }
 
-R_API int r_io_desc_read_at(RIODesc *desc, ut64 addr, ut8 *buf, int len) {
-	if (desc && buf && (r_io_desc_seek (desc, addr, R_IO_SEEK_SET) == addr)) {
-		return r_io_desc_read (desc, buf, len);
+// the seek and cache paths take int lengths, feed them in chunks
+#define DESC_CHUNK ST32_MAX
+
+static int desc_read_chunk(RIODesc *desc, ut64 addr, ut8 *buf, int len) {
+	if (!desc->plugin->read_at) {
+		if (r_io_desc_seek (desc, addr, R_IO_SEEK_SET) == addr) {
+			return r_io_desc_read (desc, buf, len);
+		}
+		return 0;
 	}
-	return 0;
+	if (desc->io->cachemode && r_io_cache_at (desc->io, addr)) {
+		return r_io_cache_read (desc->io, addr, buf, len);
+	}
+	int ret = (int)r_io_plugin_read_at (desc, addr, buf, len);
+	if (ret > 0 && desc->io->cachemode) {
+		r_io_cache_write (desc->io, addr, buf, len);
+	} else if (ret > 0 && (desc->io->p_cache & 1)) {
+		ret = r_io_desc_cache_read (desc, addr, buf, ret);
+	}
+	return ret;
 }
 
-R_API int r_io_desc_write_at(RIODesc *desc, ut64 addr, const ut8 *buf, int len) {
-	if (desc && buf && (r_io_desc_seek (desc, addr, R_IO_SEEK_SET) == addr)) {
-		return r_io_desc_write (desc, buf, len);
+R_API st64 r_io_desc_read_at(RIODesc *desc, ut64 addr, ut8 *buf, ut64 len) {
+	if (!desc || !buf || !desc->plugin || len < 1) {
+		return 0;
 	}
-	return 0;
+	if (desc->plugin->read_at && !(desc->perm & R_PERM_R)) {
+		return 0;
+	}
+	if (desc->plugin->read_at && !desc->io->cachemode && !(desc->io->p_cache & 1)) {
+		return r_io_plugin_read_at (desc, addr, buf, len);
+	}
+	ut64 done = 0;
+	while (done < len) {
+		int chunk = (int)R_MIN (len - done, DESC_CHUNK);
+		int ret = desc_read_chunk (desc, addr + done, buf + done, chunk);
+		if (ret < 1) {
+			return done? (st64)done: ret;
+		}
+		done += ret;
+		if (ret < chunk) {
+			break;
+		}
+	}
+	return (st64)done;
+}
+
+static int desc_write_chunk(RIODesc *desc, ut64 addr, const ut8 *buf, int len) {
+	if (!desc->plugin->write_at) {
+		if (r_io_desc_seek (desc, addr, R_IO_SEEK_SET) == addr) {
+			return r_io_desc_write (desc, buf, len);
+		}
+		return 0;
+	}
+	return r_io_desc_cache_write (desc, addr, buf, len);
+}
+
+R_API st64 r_io_desc_write_at(RIODesc *desc, ut64 addr, const ut8 *buf, ut64 len) {
+	if (!desc || !buf || !desc->plugin || len < 1) {
+		return 0;
+	}
+	if (desc->plugin->write_at && !(desc->io && (desc->io->p_cache & 2))) {
+		return r_io_plugin_write_at (desc, addr, buf, len);
+	}
+	ut64 done = 0;
+	while (done < len) {
+		int chunk = (int)R_MIN (len - done, DESC_CHUNK);
+		int ret = desc_write_chunk (desc, addr + done, buf + done, chunk);
+		if (ret < 1) {
+			return done? (st64)done: ret;
+		}
+		done += ret;
+		if (ret < chunk) {
+			break;
+		}
+	}
+	return (st64)done;
 }
 
 static bool desc_fini_cb(void* user, void* data, ut32 id) {
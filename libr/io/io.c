@@ -355,7 +355,7 @@ R_API int r_io_nread_at(RIO *io, ut64 addr, ut8 *buf, int len) {
 	return ret;
 }
 
-R_API bool r_io_write_at(RIO* io, ut64 addr, const ut8* buf, int len) {
+static bool io_write_at(RIO* io, ut64 addr, const ut8* buf, int len) {
 	int i;
 	bool ret = false;
 	ut8 *mybuf = (ut8*)buf;
@@ -380,6 +380,16 @@ R_API bool r_io_write_at(RIO* io, ut64 addr, const ut8* buf, int len) {
 	return ret;
 }
 
+/* the libraries write through the bind, which skips the post write hook:
+ * esil, breakpoints and snapshots are not edits of the user */
+R_API bool r_io_write_at(RIO* io, ut64 addr, const ut8* buf, int len) {
+	bool ret = io_write_at (io, addr, buf, len);
+	if (ret && io->cb_core_post_write) {
+		io->cb_core_post_write (io->user, addr, (ut8 *)buf, len);
+	}
+	return ret;
+}
+
 R_API bool r_io_read(RIO* io, ut8* buf, int len) {
 	if (io && r_io_read_at (io, io->off, buf, len)) {
 		io->off += len;
@@ -511,7 +521,7 @@ R_API void r_io_bind(RIO *io, RIOBind *bnd) {
 	bnd->open_at = r_io_open_at;
 	bnd->close = r_io_fd_close;
 	bnd->read_at = r_io_read_at;
-	bnd->write_at = r_io_write_at;
+	bnd->write_at = io_write_at;
 	bnd->system = r_io_system;
 	bnd->fd_open = r_io_fd_open;
 	bnd->fd_close = r_io_fd_close;
@@ -4,6 +4,7 @@
 #include <r_io.h>
 #include <r_lib.h>
 #include <stdio.h>
+#include <errno.h>
 
 typedef struct r_io_mmo_t {
 	char * filename;
@@ -368,6 +369,133 @@ static int __write(RIO *io, RIODesc *fd, const ut8 *buf, int len) {
 	return r_io_def_mmap_write(io, fd, buf, len);
 }
 
+#if __UNIX__
+// only do aligned reads in aligned offsets, same as r_io_def_mmap_read but without touching the fd offset
+static st64 r_io_def_pread_aligned(int fd, int aligned, ut64 addr, ut8 *buf, ut64 count) {
+	ut64 a_off = addr - (addr % aligned);
+	ut64 a_delta = addr - a_off;
+	ut64 a_count = count + a_delta;
+	ut64 i;
+	a_count += (aligned - (a_count % aligned)) % aligned;
+	ut8 *a_buf = malloc (a_count);
+	if (!a_buf) {
+		memset (buf, 0xff, count);
+		return -1;
+	}
+	memset (a_buf, 0xff, a_count);
+	for (i = 0; i < a_count; i += aligned) {
+		(void)pread (fd, a_buf + i, aligned, a_off + i);
+	}
+	memcpy (buf, a_buf + a_delta, count);
+	free (a_buf);
+	return count;
+}
+
+// read-modify-write of the whole blocks covering the range
+static st64 r_io_def_pwrite_aligned(int fd, int aligned, ut64 addr, const ut8 *buf, ut64 count) {
+	ut64 a_off = addr - (addr % aligned);
+	ut64 a_delta = addr - a_off;
+	ut64 a_count = count + a_delta;
+	ut64 i;
+	a_count += (aligned - (a_count % aligned)) % aligned;
+	ut8 *a_buf = malloc (a_count);
+	if (!a_buf) {
+		return -1;
+	}
+	r_io_def_pread_aligned (fd, aligned, a_off, a_buf, a_count);
+	memcpy (a_buf + a_delta, buf, count);
+	for (i = 0; i < a_count; i += aligned) {
+		if (pwrite (fd, a_buf + i, aligned, a_off + i) != aligned) {
+			free (a_buf);
+			return i > a_delta? R_MIN (i - a_delta, count): -1;
+		}
+	}
+	free (a_buf);
+	return count;
+}
+
+static st64 __read_at(RIO *io, RIODesc *fd, ut64 addr, ut8 *buf, ut64 count) {
+	if (!fd || !fd->data || !buf) {
+		return -1;
+	}
+	RIOMMapFileObj *mmo = fd->data;
+	if (addr == UT64_MAX) {
+		memset (buf, 0xff, count);
+		return count;
+	}
+	if (mmo->rawio) {
+		if (fd->obsz) {
+			return r_io_def_pread_aligned (mmo->fd, fd->obsz, addr, buf, count);
+		}
+		ut64 done = 0;
+		while (done < count) {
+			ssize_t ret = pread (mmo->fd, buf + done, (size_t)(count - done), addr + done);
+			if (ret < 1) {
+				if (ret < 0 && errno == EINTR) {
+					continue;
+				}
+				break;
+			}
+			done += ret;
+		}
+		return done? done: -1;
+	}
+	// read straight from the mapping, the RBuffer cursor is not involved
+	RBuffer *b = mmo->buf;
+	if (!b || b->empty || addr >= b->length) {
+		memset (buf, 0xff, count);
+		return 0;
+	}
+	ut64 avail = R_MIN (count, b->length - addr);
+	memcpy (buf, b->buf + addr, avail);
+	if (avail < count) {
+		memset (buf + avail, 0xff, count - avail);
+	}
+	return avail;
+}
+
+static st64 __write_at(RIO *io, RIODesc *fd, ut64 addr, const ut8 *buf, ut64 count) {
+	if (!fd || !fd->data || !buf) {
+		return -1;
+	}
+	RIOMMapFileObj *mmo = fd->data;
+	if (mmo->rawio && !fd->obsz) {
+		ut64 done = 0;
+		while (done < count) {
+			ssize_t ret = pwrite (mmo->fd, buf + done, (size_t)(count - done), addr + done);
+			if (ret < 1) {
+				if (ret < 0 && errno == EINTR) {
+					continue;
+				}
+				break;
+			}
+			done += ret;
+		}
+		return done? done: -1;
+	}
+	if (mmo->rawio) {
+		return r_io_def_pwrite_aligned (mmo->fd, fd->obsz, addr, buf, count);
+	}
+	if (!(mmo->perm & R_PERM_W) || count > ST32_MAX) {
+		return -1;
+	}
+	if (!mmo->buf || mmo->buf->empty || addr + count > mmo->buf->length) {
+		r_file_truncate (mmo->filename, addr + count);
+	}
+	st64 len = r_file_mmap_write (mmo->filename, addr, buf, (int)count);
+	if (len != count) {
+		len = pwrite (mmo->fd, buf, (size_t)count, addr);
+	}
+	// remapping restores the buffer cursor through io->off, keep it untouched
+	ut64 off = io->off;
+	if (!r_io_def_mmap_refresh_def_mmap_buf (mmo)) {
+		eprintf ("io_def_mmap: failed to refresh the def_mmap backed buffer.\n");
+	}
+	io->off = off;
+	return len;
+}
+#endif
+
 static ut64 __lseek(RIO *io, RIODesc *fd, ut64 offset, int whence) {
 	return r_io_def_mmap_lseek (io, fd, offset, whence);
 }
@@ -420,6 +548,8 @@ RIOPlugin r_io_plugin_default = {
 	.resize = __resize,
 	.system = __system,
 #if __UNIX__
+	.read_at = __read_at,
+	.write_at = __write_at,
 	.is_blockdevice = __is_blockdevice,
 #endif
 };
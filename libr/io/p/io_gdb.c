@@ -221,6 +221,8 @@ static char *__system(RIO *io, RIODesc *fd, const char *cmd) {
 			                     " to target interpreter\n"
 			 " =!detach [pid]    - detach from remote/detach specific pid\n"
 			 " =!inv.reg         - invalidate reg cache\n"
+			 " =!inv.mem         - invalidate memory cache\n"
+			 " =!memcache [0|1]  - get/set use of the memory cache\n"
 			 " =!pktsz           - get max packet size used\n"
 			 " =!pktsz bytes     - set max. packet size as 'bytes' bytes\n"
 			 " =!exec_file [pid] - get file which was executed for"
@@ -293,6 +295,20 @@ static char *__system(RIO *io, RIODesc *fd, const char *cmd) {
 		gdbr_invalidate_reg_cache ();
 		return NULL;
 	}
+	if (r_str_startswith (cmd, "inv.mem")) {
+		gdbr_invalidate_mem_cache (desc);
+		return NULL;
+	}
+	if (r_str_startswith (cmd, "memcache")) {
+		const char *ptr = r_str_trim_ro (cmd + 8);
+		if (!isdigit ((ut8)*ptr)) {
+			io->cb_printf ("%d\n", !desc->mem_cache.disabled);
+			return NULL;
+		}
+		desc->mem_cache.disabled = !atoi (ptr);
+		gdbr_invalidate_mem_cache (desc);
+		return NULL;
+	}
 	if (r_str_startswith (cmd, "exec_file")) {
 		const char *ptr = cmd + strlen ("exec_file");
 		char *file;
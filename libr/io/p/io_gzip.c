@@ -1,194 +1,838 @@
-/* radare - LGPL - Copyright 2008-2017 - pancake */
+/* radare - LGPL - Copyright 2008-2019 - pancake */
 
 #include "r_io.h"
 #include "r_lib.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+/*
+ * Random access to deflate streams (gzip, zlib or concatenated gzip members)
+ * without inflating the whole file in memory. On open the stream is inflated
+ * once to build an index of checkpoints (compressed offset, bit offset and the
+ * 32K window needed to resume inflating at a block boundary), the index is
+ * cached in ~/.cache/radare2/gzip so next opens of the same file are instant.
+ * Reads inflate only the pages they touch, from the closest checkpoint or by
+ * continuing the previous stream, and keep the result in a small LRU.
+ *
+ * lz4 frames are indexed by block instead, every block with independent
+ * blocks (the lz4 default) can be decompressed on its own.
+ */
+
+#define GZ_SPAN (4 * 1024 * 1024) // uncompressed distance between checkpoints
+#define GZ_WINSIZE 32768
+#define GZ_CHUNK 16384
+#define GZ_PAGESIZE (64 * 1024)
+#define GZ_NPAGES 64
+#define GZ_IDX_MAGIC "r2gzidx1"
+#define LZ4_MAGIC 0x184D2204
+#define LZ4_STORED 0x80000000 // block size flag for uncompressed blocks
 
 typedef struct {
-	ut8 *buf;
+	ut64 out; // uncompressed offset
+	ut64 in; // compressed offset of the first full byte to read
+	int bits; // bits to feed from the byte at in - 1, -1 if a member header starts at in
+	ut8 *window;
+} RIOGzipPoint;
+
+typedef struct {
+	ut64 in; // compressed offset of the block data
+	ut64 out;
+	ut32 csize; // with LZ4_STORED when the block is not compressed
 	ut32 size;
+} RIOGzipBlock;
+
+typedef struct {
+	ut64 addr;
+	ut64 stamp;
+	int size;
+	ut8 *data;
+} RIOGzipPage;
+
+typedef struct {
+	int fd;
+	ut64 csize; // compressed size
+	ut64 size; // uncompressed size
 	ut64 offset;
+	bool zlib; // zlib wrapper instead of gzip, only matters for the trailer size
+	RIOGzipPoint *points;
+	int npoints;
+	bool lz4;
+	RIOGzipBlock *blocks;
+	int nblocks;
+	int cur_block; // the one in block_data, -1 if none
+	ut8 *block_data;
+	ut8 *block_in;
+	ut32 block_max;
+	RIOGzipPage pages[GZ_NPAGES];
+	HtUP *dirty; // written pages, never evicted
+	ut64 clock;
+	// inflate state kept alive to serve sequential reads without restarting
+	z_stream strm;
+	bool live;
+	bool raw;
+	ut64 strm_in;
+	ut64 strm_out;
+	ut8 in[GZ_CHUNK];
+	ut8 scratch[GZ_CHUNK];
+	// stats
+	ut64 hits;
+	ut64 misses;
+	ut64 hit_usec;
+	ut64 miss_usec;
+	ut64 index_usec;
+	bool index_cached;
+	RThreadLock *lock;
 } RIOGzip;
 
-static inline ut32 _io_malloc_sz(RIODesc *desc) {
-	if (!desc) {
-		return 0;
+// every desc owns its fd and reads happen with the lock held
+static int gz_pread(RIOGzip *gz, ut8 *buf, int len, ut64 addr) {
+	if (lseek (gz->fd, addr, SEEK_SET) != addr) {
+		return -1;
 	}
-	RIOGzip *mal = (RIOGzip*)desc->data;
-	return mal? mal->size: 0;
+	return read (gz->fd, buf, len);
 }
 
-static inline void _io_malloc_set_sz(RIODesc *desc, ut32 sz) {
-	if (!desc) {
-		return;
-	}
-	RIOGzip *mal = (RIOGzip*)desc->data;
-	if (mal) {
-		mal->size = sz;
+static void gz_points_free(RIOGzip *gz) {
+	int i;
+	for (i = 0; i < gz->npoints; i++) {
+		free (gz->points[i].window);
 	}
+	R_FREE (gz->points);
+	gz->npoints = 0;
 }
 
-static inline ut8* _io_malloc_buf(RIODesc *desc) {
-	if (!desc) {
-		return NULL;
+static bool gz_add_point(RIOGzip *gz, ut64 in, ut64 out, int bits, const ut8 *window, int left) {
+	if (!(gz->npoints % 64)) {
+		RIOGzipPoint *p = realloc (gz->points, sizeof (RIOGzipPoint) * (gz->npoints + 64));
+		if (!p) {
+			return false;
+		}
+		gz->points = p;
+	}
+	RIOGzipPoint *p = &gz->points[gz->npoints];
+	p->in = in;
+	p->out = out;
+	p->bits = bits;
+	p->window = NULL;
+	if (bits >= 0) {
+		// window is circular, left is the amount of unused bytes at its end
+		p->window = malloc (GZ_WINSIZE);
+		if (!p->window) {
+			return false;
+		}
+		if (left) {
+			memcpy (p->window, window + GZ_WINSIZE - left, left);
+		}
+		if (left < GZ_WINSIZE) {
+			memcpy (p->window + left, window, GZ_WINSIZE - left);
+		}
 	}
-	RIOGzip *mal = (RIOGzip*)desc->data;
-	return mal->buf;
+	gz->npoints++;
+	return true;
 }
 
+static bool gz_build_index(RIOGzip *gz) {
+	z_stream strm = {0};
+	ut8 *window = calloc (1, GZ_WINSIZE);
+	ut64 totin = 0, totout = 0, last = 0;
+	bool ended = false;
+	int ret = Z_OK;
+	if (!window || inflateInit2 (&strm, MAX_WBITS + 32) != Z_OK) {
+		free (window);
+		return false;
+	}
+	gz_add_point (gz, 0, 0, -1, NULL, 0);
+	strm.avail_out = 0;
+	for (;;) {
+		int n = gz_pread (gz, gz->in, GZ_CHUNK, totin);
+		if (n < 1) {
+			break;
+		}
+		strm.next_in = gz->in;
+		strm.avail_in = n;
+		do {
+			if (!strm.avail_out) {
+				strm.avail_out = GZ_WINSIZE;
+				strm.next_out = window;
+			}
+			totin += strm.avail_in;
+			totout += strm.avail_out;
+			ret = inflate (&strm, Z_BLOCK);
+			totin -= strm.avail_in;
+			totout -= strm.avail_out;
+			if (ret == Z_NEED_DICT || ret == Z_MEM_ERROR || ret == Z_DATA_ERROR) {
+				// trailing garbage after a complete member is fine
+				if (!ended) {
+					eprintf ("gzip: inflate error at 0x%"PFMT64x"\n", totin);
+					goto fail;
+				}
+				goto done;
+			}
+			if (ret == Z_STREAM_END) {
+				ended = true;
+				if (totin >= gz->csize) {
+					goto done;
+				}
+				// another member follows
+				inflateReset (&strm);
+				gz_add_point (gz, totin, totout, -1, NULL, 0);
+				last = totout;
+				continue;
+			}
+			if ((strm.data_type & 128) && !(strm.data_type & 64) && totout - last >= GZ_SPAN) {
+				if (!gz_add_point (gz, totin, totout, strm.data_type & 7, window, strm.avail_out)) {
+					goto fail;
+				}
+				last = totout;
+			}
+		} while (strm.avail_in);
+	}
+	if (!ended) {
+		eprintf ("gzip: truncated stream, only 0x%"PFMT64x" bytes available\n", totout);
+	}
+done:
+	gz->size = totout;
+	inflateEnd (&strm);
+	free (window);
+	return true;
+fail:
+	inflateEnd (&strm);
+	free (window);
+	gz_points_free (gz);
+	return false;
+}
 
-static inline ut8* _io_malloc_set_buf(RIODesc *desc, ut8* buf) {
-	if (!desc) {
-		return NULL;
+static char *gz_index_path(const char *filename) {
+	char *abspath = r_file_abspath (filename);
+	char *dir = r_str_home (R_JOIN_2_PATHS (R2_HOME_CACHEDIR, "gzip"));
+	char *res = NULL;
+	if (abspath && dir) {
+		res = r_str_newf ("%s" R_SYS_DIR "%08x.idx", dir, r_str_hash (abspath));
 	}
-	RIOGzip *mal = (RIOGzip*)desc->data;
-	return mal->buf = buf;
+	free (abspath);
+	free (dir);
+	return res;
 }
 
-static inline ut64 _io_malloc_off(RIODesc *desc) {
-	if (!desc) {
-		return 0;
+static ut64 gz_mtime(int fd) {
+	struct stat st;
+	return fstat (fd, &st)? 0: (ut64)st.st_mtime;
+}
+
+static bool gz_index_load(RIOGzip *gz, const char *filename) {
+	char *path = gz_index_path (filename);
+	FILE *fd = path? r_sandbox_fopen (path, "rb"): NULL;
+	free (path);
+	if (!fd) {
+		return false;
+	}
+	char magic[8];
+	ut64 hdr[3];
+	ut32 npoints, i;
+	bool ok = fread (magic, sizeof (magic), 1, fd) == 1
+		&& !memcmp (magic, GZ_IDX_MAGIC, sizeof (magic))
+		&& fread (hdr, sizeof (hdr), 1, fd) == 1
+		&& hdr[0] == gz->csize && hdr[1] == gz_mtime (gz->fd)
+		&& fread (&npoints, sizeof (npoints), 1, fd) == 1;
+	for (i = 0; ok && i < npoints; i++) {
+		RIOGzipPoint p;
+		ut8 window[GZ_WINSIZE];
+		ok = fread (&p.out, sizeof (p.out), 1, fd) == 1
+			&& fread (&p.in, sizeof (p.in), 1, fd) == 1
+			&& fread (&p.bits, sizeof (p.bits), 1, fd) == 1
+			&& (p.bits < 0 || fread (window, GZ_WINSIZE, 1, fd) == 1)
+			&& gz_add_point (gz, p.in, p.out, p.bits, window, 0);
 	}
-	RIOGzip *mal = (RIOGzip*)desc->data;
-	return mal->offset;
+	fclose (fd);
+	if (!ok || !gz->npoints) {
+		gz_points_free (gz);
+		return false;
+	}
+	gz->size = hdr[2];
+	return true;
 }
 
-static inline void _io_malloc_set_off(RIODesc *desc, ut64 off) {
-	if (!desc) {
+static void gz_index_save(RIOGzip *gz, const char *filename) {
+	char *path = gz_index_path (filename);
+	if (!path) {
 		return;
 	}
-	RIOGzip *mal = (RIOGzip*)desc->data;
-	mal->offset = off;
+	char *dir = r_file_dirname (path);
+	r_sys_mkdirp (dir);
+	free (dir);
+	FILE *fd = r_sandbox_fopen (path, "wb");
+	if (fd) {
+		ut64 hdr[3] = { gz->csize, gz_mtime (gz->fd), gz->size };
+		ut32 npoints = gz->npoints;
+		int i;
+		fwrite (GZ_IDX_MAGIC, 8, 1, fd);
+		fwrite (hdr, sizeof (hdr), 1, fd);
+		fwrite (&npoints, sizeof (npoints), 1, fd);
+		for (i = 0; i < gz->npoints; i++) {
+			RIOGzipPoint *p = &gz->points[i];
+			fwrite (&p->out, sizeof (p->out), 1, fd);
+			fwrite (&p->in, sizeof (p->in), 1, fd);
+			fwrite (&p->bits, sizeof (p->bits), 1, fd);
+			if (p->bits >= 0) {
+				fwrite (p->window, GZ_WINSIZE, 1, fd);
+			}
+		}
+		fclose (fd);
+	}
+	free (path);
 }
 
-static int __write(RIO *io, RIODesc *fd, const ut8 *buf, int count) {
-	if (!fd || !buf || count < 0 || !fd->data) {
-		return -1;
+static void gz_stream_fini(RIOGzip *gz) {
+	if (gz->live) {
+		inflateEnd (&gz->strm);
+		gz->live = false;
 	}
-	if (_io_malloc_off (fd) > _io_malloc_sz (fd)) {
-		return -1;
+}
+
+// start a new inflate at a member header
+static bool gz_stream_member(RIOGzip *gz, ut64 in, ut64 out) {
+	gz_stream_fini (gz);
+	memset (&gz->strm, 0, sizeof (gz->strm));
+	if (inflateInit2 (&gz->strm, MAX_WBITS + 32) != Z_OK) {
+		return false;
+	}
+	gz->raw = false;
+	gz->live = true;
+	gz->strm_in = in;
+	gz->strm_out = out;
+	return true;
+}
+
+static bool gz_stream_seek(RIOGzip *gz, const RIOGzipPoint *p) {
+	if (p->bits < 0) {
+		return gz_stream_member (gz, p->in, p->out);
+	}
+	gz_stream_fini (gz);
+	memset (&gz->strm, 0, sizeof (gz->strm));
+	if (inflateInit2 (&gz->strm, -MAX_WBITS) != Z_OK) {
+		return false;
 	}
-	if (_io_malloc_off (fd) + count > _io_malloc_sz (fd)) {
-		count -= (_io_malloc_off (fd) + count -_io_malloc_sz (fd));
+	gz->raw = true;
+	gz->live = true;
+	gz->strm_in = p->in;
+	gz->strm_out = p->out;
+	if (p->bits) {
+		ut8 ch;
+		if (gz_pread (gz, &ch, 1, p->in - 1) != 1) {
+			gz_stream_fini (gz);
+			return false;
+		}
+		inflatePrime (&gz->strm, p->bits, ch >> (8 - p->bits));
 	}
-	if (count > 0) {
-		memcpy (_io_malloc_buf (fd) + _io_malloc_off (fd), buf, count);
-		_io_malloc_set_off (fd, _io_malloc_off (fd) + count);
-		return count;
+	inflateSetDictionary (&gz->strm, p->window, GZ_WINSIZE);
+	return true;
+}
+
+static const RIOGzipPoint *gz_point_at(RIOGzip *gz, ut64 addr) {
+	int lo = 0, hi = gz->npoints - 1;
+	while (lo < hi) {
+		int mid = (lo + hi + 1) / 2;
+		if (gz->points[mid].out <= addr) {
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
 	}
-	return -1;
+	return &gz->points[lo];
 }
 
-static bool __resize(RIO *io, RIODesc *fd, ut64 count) {
-	ut8 * new_buf = NULL;
-	if (!fd || !fd->data || count == 0) {
+// inflate [addr, addr + len) into dst, returns the amount of bytes produced
+static int gz_inflate_at(RIOGzip *gz, ut64 addr, ut8 *dst, int len) {
+	const RIOGzipPoint *p = gz_point_at (gz, addr);
+	// restart from the checkpoint unless the live stream is closer
+	if (!gz->live || gz->strm_out > addr || gz->strm_out < p->out) {
+		if (!gz_stream_seek (gz, p)) {
+			return 0;
+		}
+	}
+	z_stream *strm = &gz->strm;
+	while (gz->strm_out < addr + len) {
+		if (!strm->avail_in) {
+			int n = gz_pread (gz, gz->in, GZ_CHUNK, gz->strm_in);
+			if (n < 1) {
+				break;
+			}
+			strm->next_in = gz->in;
+			strm->avail_in = n;
+			gz->strm_in += n;
+		}
+		if (gz->strm_out < addr) {
+			strm->next_out = gz->scratch;
+			strm->avail_out = (uInt)R_MIN (addr - gz->strm_out, sizeof (gz->scratch));
+		} else {
+			strm->next_out = dst + (gz->strm_out - addr);
+			strm->avail_out = (uInt)(addr + len - gz->strm_out);
+		}
+		uInt avail = strm->avail_out;
+		int ret = inflate (strm, Z_NO_FLUSH);
+		gz->strm_out += avail - strm->avail_out;
+		if (ret == Z_STREAM_END) {
+			// skip the trailer when inflating raw data and go on with the next member
+			ut64 next = gz->strm_in - strm->avail_in;
+			if (gz->raw) {
+				next += gz->zlib? 4: 8;
+			}
+			if (next >= gz->csize || !gz_stream_member (gz, next, gz->strm_out)) {
+				gz_stream_fini (gz);
+				break;
+			}
+			strm = &gz->strm;
+		} else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+			gz_stream_fini (gz);
+			break;
+		}
+	}
+	return gz->strm_out > addr? (int)R_MIN (gz->strm_out - addr, len): 0;
+}
+
+static ut32 lz4_block_max(ut8 bd) {
+	switch ((bd >> 4) & 7) {
+	case 4: return 64 * 1024;
+	case 5: return 256 * 1024;
+	case 6: return 1024 * 1024;
+	case 7: return 4 * 1024 * 1024;
+	}
+	return 0;
+}
+
+static bool lz4_add_block(RIOGzip *gz, ut64 in, ut64 out, ut32 csize, ut32 size) {
+	if (!(gz->nblocks % 64)) {
+		RIOGzipBlock *b = realloc (gz->blocks, sizeof (RIOGzipBlock) * (gz->nblocks + 64));
+		if (!b) {
+			return false;
+		}
+		gz->blocks = b;
+	}
+	RIOGzipBlock *b = &gz->blocks[gz->nblocks++];
+	b->in = in;
+	b->out = out;
+	b->csize = csize;
+	b->size = size;
+	return true;
+}
+
+static bool lz4_grow(RIOGzip *gz, ut32 size) {
+	if (size <= gz->block_max) {
+		return true;
+	}
+	ut8 *data = realloc (gz->block_data, size);
+	if (data) {
+		gz->block_data = data;
+	}
+	ut8 *in = realloc (gz->block_in, size);
+	if (in) {
+		gz->block_in = in;
+	}
+	if (!data || !in) {
 		return false;
 	}
-	ut32 mallocsz = _io_malloc_sz (fd);
-	if (_io_malloc_off (fd) > mallocsz) {
+	gz->block_max = size;
+	gz->cur_block = -1;
+	return true;
+}
+
+// decompress block i into block_data
+static bool lz4_load_block(RIOGzip *gz, int i) {
+	RIOGzipBlock *b = &gz->blocks[i];
+	ut32 csize = b->csize & ~LZ4_STORED;
+	if (gz->cur_block == i) {
+		return true;
+	}
+	gz->cur_block = -1;
+	if (b->csize & LZ4_STORED) {
+		if (gz_pread (gz, gz->block_data, csize, b->in) != (int)csize) {
+			return false;
+		}
+	} else if (gz_pread (gz, gz->block_in, csize, b->in) != (int)csize
+			|| r_lz4_decompress (gz->block_in, csize, gz->block_data, gz->block_max) != b->size) {
 		return false;
 	}
-	new_buf = malloc (count);
-	if (!new_buf) {
+	gz->cur_block = i;
+	return true;
+}
+
+/* walks the blocks of every frame, the compressed ones are decompressed
+ * once because only the frame knows the size of the last block */
+static bool lz4_build_index(RIOGzip *gz) {
+	ut64 in = 0, out = 0;
+	ut8 hdr[15];
+	gz->cur_block = -1;
+	while (in + 4 <= gz->csize) {
+		if (gz_pread (gz, hdr, 4, in) != 4) {
+			break;
+		}
+		ut32 magic = r_read_le32 (hdr);
+		if ((magic & 0xfffffff0) == 0x184D2A50) {
+			// skippable frame
+			if (gz_pread (gz, hdr, 4, in + 4) != 4) {
+				break;
+			}
+			in += 8 + r_read_le32 (hdr);
+			continue;
+		}
+		if (magic != LZ4_MAGIC || gz_pread (gz, hdr, 2, in + 4) != 2) {
+			if (!gz->nblocks) {
+				eprintf ("lz4: bad frame magic\n");
+				return false;
+			}
+			break; // trailing garbage
+		}
+		ut8 flg = hdr[0];
+		if ((flg >> 6) != 1) {
+			eprintf ("lz4: unsupported frame version\n");
+			return false;
+		}
+		if (!(flg & 0x20)) {
+			eprintf ("lz4: frames with linked blocks (lz4 -BD) are not supported\n");
+			return false;
+		}
+		ut32 bmax = lz4_block_max (hdr[1]);
+		if (!bmax || !lz4_grow (gz, bmax)) {
+			return false;
+		}
+		in += 4 + 2 + ((flg & 8)? 8: 0) + ((flg & 1)? 4: 0) + 1;
+		for (;;) {
+			if (gz_pread (gz, hdr, 4, in) != 4) {
+				eprintf ("lz4: truncated stream, only 0x%"PFMT64x" bytes available\n", out);
+				gz->size = out;
+				return gz->nblocks > 0;
+			}
+			ut32 csize = r_read_le32 (hdr);
+			in += 4;
+			if (!csize) {
+				break; // end mark
+			}
+			ut32 size = csize & ~LZ4_STORED;
+			if (size > bmax || in + size > gz->csize) {
+				eprintf ("lz4: bad block at 0x%"PFMT64x"\n", in - 4);
+				return false;
+			}
+			if (!(csize & LZ4_STORED)) {
+				int n = (gz_pread (gz, gz->block_in, size, in) == (int)size)
+					? r_lz4_decompress (gz->block_in, size, gz->block_data, bmax): -1;
+				if (n < 0) {
+					eprintf ("lz4: cannot decompress the block at 0x%"PFMT64x"\n", in - 4);
+					return false;
+				}
+				size = n;
+			}
+			if (!lz4_add_block (gz, in, out, csize, size)) {
+				return false;
+			}
+			in += (csize & ~LZ4_STORED) + ((flg & 0x10)? 4: 0);
+			out += size;
+		}
+		in += (flg & 4)? 4: 0;
+	}
+	gz->size = out;
+	return gz->nblocks > 0;
+}
+
+static int lz4_block_at(RIOGzip *gz, ut64 addr) {
+	int lo = 0, hi = gz->nblocks - 1;
+	while (lo < hi) {
+		int mid = (lo + hi + 1) / 2;
+		if (gz->blocks[mid].out <= addr) {
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	return lo;
+}
+
+static int lz4_read_at(RIOGzip *gz, ut64 addr, ut8 *dst, int len) {
+	int i, done = 0;
+	for (i = lz4_block_at (gz, addr); i < gz->nblocks && done < len; i++) {
+		RIOGzipBlock *b = &gz->blocks[i];
+		ut64 at = addr + done;
+		if (at < b->out || at - b->out >= b->size) {
+			continue; // empty block
+		}
+		if (!lz4_load_block (gz, i)) {
+			break;
+		}
+		int n = (int)R_MIN (len - done, b->size - (at - b->out));
+		memcpy (dst + done, gz->block_data + (at - b->out), n);
+		done += n;
+	}
+	return done;
+}
+
+static RIOGzipPage *gz_page(RIOGzip *gz, ut64 addr) {
+	RIOGzipPage *page = ht_up_find (gz->dirty, addr, NULL);
+	if (page) {
+		return page;
+	}
+	RIOGzipPage *lru = &gz->pages[0];
+	ut64 t0 = r_sys_now ();
+	int i;
+	gz->clock++;
+	for (i = 0; i < GZ_NPAGES; i++) {
+		page = &gz->pages[i];
+		if (page->data && page->addr == addr) {
+			page->stamp = gz->clock;
+			gz->hits++;
+			gz->hit_usec += r_sys_now () - t0;
+			return page;
+		}
+		if (page->stamp < lru->stamp) {
+			lru = page;
+		}
+	}
+	if (!lru->data && !(lru->data = malloc (GZ_PAGESIZE))) {
+		return NULL;
+	}
+	lru->addr = addr;
+	lru->stamp = gz->clock;
+	int len = (int)R_MIN (GZ_PAGESIZE, gz->size - addr);
+	lru->size = gz->lz4
+		? lz4_read_at (gz, addr, lru->data, len)
+		: gz_inflate_at (gz, addr, lru->data, len);
+	gz->misses++;
+	gz->miss_usec += r_sys_now () - t0;
+	return lru;
+}
+
+static void gz_page_free(HtUPKv *kv) {
+	RIOGzipPage *page = kv->value;
+	free (page->data);
+	free (page);
+}
+
+static st64 gz_read_at(RIOGzip *gz, ut64 addr, ut8 *buf, ut64 count) {
+	ut64 done = 0;
+	memset (buf, 0xff, count);
+	if (addr >= gz->size) {
+		return 0;
+	}
+	count = R_MIN (count, gz->size - addr);
+	r_th_lock_enter (gz->lock);
+	while (done < count) {
+		ut64 at = addr + done;
+		ut64 base = at - (at % GZ_PAGESIZE);
+		RIOGzipPage *page = gz_page (gz, base);
+		if (!page || at - base >= page->size) {
+			break;
+		}
+		ut64 n = R_MIN (count - done, page->size - (at - base));
+		memcpy (buf + done, page->data + (at - base), n);
+		done += n;
+	}
+	r_th_lock_leave (gz->lock);
+	return done;
+}
+
+static st64 gz_write_at(RIOGzip *gz, ut64 addr, const ut8 *buf, ut64 count) {
+	ut64 done = 0;
+	if (addr >= gz->size) {
+		return -1;
+	}
+	count = R_MIN (count, gz->size - addr);
+	r_th_lock_enter (gz->lock);
+	while (done < count) {
+		ut64 at = addr + done;
+		ut64 base = at - (at % GZ_PAGESIZE);
+		RIOGzipPage *page = ht_up_find (gz->dirty, base, NULL);
+		if (!page) {
+			RIOGzipPage *clean = gz_page (gz, base);
+			if (!clean || !(page = R_NEW0 (RIOGzipPage))) {
+				break;
+			}
+			page->addr = base;
+			page->size = clean->size;
+			page->data = r_mem_dup (clean->data, clean->size);
+			ht_up_insert (gz->dirty, base, page);
+		}
+		if (at - base >= page->size) {
+			break;
+		}
+		ut64 n = R_MIN (count - done, page->size - (at - base));
+		memcpy (page->data + (at - base), buf + done, n);
+		done += n;
+	}
+	r_th_lock_leave (gz->lock);
+	return done? done: -1;
+}
+
+static void gz_free(RIOGzip *gz) {
+	int i;
+	gz_stream_fini (gz);
+	gz_points_free (gz);
+	free (gz->blocks);
+	free (gz->block_data);
+	free (gz->block_in);
+	for (i = 0; i < GZ_NPAGES; i++) {
+		free (gz->pages[i].data);
+	}
+	ht_up_free (gz->dirty);
+	r_th_lock_free (gz->lock);
+	if (gz->fd != -1) {
+		close (gz->fd);
+	}
+	free (gz);
+}
+
+static st64 __read_at(RIO *io, RIODesc *fd, ut64 addr, ut8 *buf, ut64 count) {
+	if (!fd || !fd->data || !buf) {
 		return -1;
 	}
-	memcpy (new_buf, _io_malloc_buf (fd), R_MIN (count, mallocsz));
-	if (count > mallocsz) {
-		memset (new_buf + mallocsz, 0, count - mallocsz);
+	return gz_read_at (fd->data, addr, buf, count);
+}
+
+static st64 __write_at(RIO *io, RIODesc *fd, ut64 addr, const ut8 *buf, ut64 count) {
+	if (!fd || !fd->data || !buf) {
+		return -1;
 	}
-	free (_io_malloc_buf (fd));
-	_io_malloc_set_buf (fd, new_buf);
-	_io_malloc_set_sz (fd, count);
-	return true;
+	return gz_write_at (fd->data, addr, buf, count);
 }
 
 static int __read(RIO *io, RIODesc *fd, ut8 *buf, int count) {
-	memset (buf, 0xff, count);
-	if (!fd || !fd->data) {
+	if (!fd || !fd->data || count < 0) {
 		return -1;
 	}
-	ut32 mallocsz = _io_malloc_sz (fd);
-	if (_io_malloc_off (fd) > mallocsz) {
+	RIOGzip *gz = fd->data;
+	int ret = (int)gz_read_at (gz, gz->offset, buf, count);
+	if (ret > 0) {
+		gz->offset += ret;
+	}
+	return ret;
+}
+
+static int __write(RIO *io, RIODesc *fd, const ut8 *buf, int count) {
+	if (!fd || !buf || count < 0 || !fd->data) {
 		return -1;
 	}
-	if (_io_malloc_off (fd) + count >= mallocsz) {
-		count = mallocsz - _io_malloc_off (fd);
+	RIOGzip *gz = fd->data;
+	int ret = (int)gz_write_at (gz, gz->offset, buf, count);
+	if (ret > 0) {
+		gz->offset += ret;
 	}
-	memcpy (buf, _io_malloc_buf (fd) + _io_malloc_off (fd), count);
-	return count;
+	return ret;
 }
 
 static int __close(RIODesc *fd) {
-	RIOGzip *riom;
 	if (!fd || !fd->data) {
 		return -1;
 	}
-	riom = fd->data;
-	R_FREE (riom->buf);
-	R_FREE (fd->data);
-	eprintf ("TODO: Writing changes into gzipped files is not yet supported\n");
+	RIOGzip *gz = fd->data;
+	if (gz->dirty->count) {
+		eprintf ("TODO: Writing changes into gzipped files is not yet supported\n");
+	}
+	gz_free (gz);
+	fd->data = NULL;
 	return 0;
 }
 
 static ut64 __lseek(RIO* io, RIODesc *fd, ut64 offset, int whence) {
-	ut64 r_offset = offset;
 	if (!fd || !fd->data) {
 		return offset;
 	}
-	ut32 mallocsz = _io_malloc_sz (fd);
+	RIOGzip *gz = fd->data;
 	switch (whence) {
 	case SEEK_SET:
-		r_offset = (offset <= mallocsz) ? offset : mallocsz;
+		gz->offset = R_MIN (offset, gz->size);
 		break;
 	case SEEK_CUR:
-		r_offset = (_io_malloc_off (fd) + offset <= mallocsz ) ? _io_malloc_off (fd) + offset : mallocsz;
+		gz->offset = R_MIN (gz->offset + offset, gz->size);
 		break;
 	case SEEK_END:
-		r_offset = _io_malloc_sz (fd);
+		gz->offset = gz->size;
 		break;
 	}
-	_io_malloc_set_off (fd, r_offset);
-	return r_offset;
+	return gz->offset;
+}
+
+static char *__system(RIO *io, RIODesc *fd, const char *cmd) {
+	RIOGzip *gz = fd? fd->data: NULL;
+	if (!gz) {
+		return NULL;
+	}
+	if (!strcmp (cmd, "stats")) {
+		io->cb_printf ("size      0x%"PFMT64x"\n", gz->size);
+		io->cb_printf ("csize     0x%"PFMT64x"\n", gz->csize);
+		if (gz->lz4) {
+			io->cb_printf ("blocks    %d\n", gz->nblocks);
+		} else {
+			io->cb_printf ("points    %d%s\n", gz->npoints, gz->index_cached? " (cached)": "");
+		}
+		io->cb_printf ("index     %"PFMT64d" us\n", gz->index_usec);
+		io->cb_printf ("hits      %"PFMT64d" (%"PFMT64d" us avg)\n", gz->hits,
+			gz->hits? gz->hit_usec / gz->hits: 0);
+		io->cb_printf ("misses    %"PFMT64d" (%"PFMT64d" us avg)\n", gz->misses,
+			gz->misses? gz->miss_usec / gz->misses: 0);
+		io->cb_printf ("dirty     %d\n", (int)gz->dirty->count);
+	} else {
+		eprintf ("Usage: =!stats   - show index and page cache stats\n");
+	}
+	return NULL;
 }
 
 static bool __plugin_open(RIO *io, const char *pathname, bool many) {
-	return (!strncmp (pathname, "gzip://", 7));
+	return (!strncmp (pathname, "gzip://", 7) || !strncmp (pathname, "lz4://", 6));
 }
 
 static RIODesc *__open(RIO *io, const char *pathname, int rw, int mode) {
-	if (__plugin_open (io, pathname, 0)) {
-		RIOGzip *mal = R_NEW0 (RIOGzip);
-		if (!mal) {
+	if (!__plugin_open (io, pathname, 0)) {
+		return NULL;
+	}
+	const char *filename = strstr (pathname, "://") + 3;
+	RIOGzip *gz = R_NEW0 (RIOGzip);
+	if (!gz) {
+		return NULL;
+	}
+	gz->fd = r_sandbox_open (filename, O_RDONLY, 0);
+	gz->dirty = ht_up_new (NULL, gz_page_free, NULL);
+	gz->lock = r_th_lock_new (false);
+	if (gz->fd == -1 || !gz->dirty || !gz->lock) {
+		eprintf ("Cannot open %s\n", filename);
+		gz_free (gz);
+		return NULL;
+	}
+	ut8 magic[4] = {0};
+	(void)gz_pread (gz, magic, sizeof (magic), 0);
+	gz->zlib = magic[0] != 0x1f || magic[1] != 0x8b;
+	gz->lz4 = r_read_le32 (magic) == LZ4_MAGIC;
+	gz->csize = r_file_size (filename);
+	ut64 t0 = r_sys_now ();
+	if (gz->lz4) {
+		if (!lz4_build_index (gz)) {
+			gz_free (gz);
 			return NULL;
 		}
-		int len;
-		ut8 *data = (ut8*)r_file_slurp (pathname+7, &len);	//memleak here?
-		int *size = (int*)&mal->size;
-		mal->buf = r_inflate (data, len, NULL, size);
-		if (mal->buf) {
-			return r_io_desc_new (io, &r_io_plugin_gzip, pathname, rw, mode, mal);
+	} else if (!(gz->index_cached = gz_index_load (gz, filename))) {
+		if (!gz_build_index (gz)) {
+			gz_free (gz);
+			return NULL;
 		}
-		free (data);
-		eprintf ("Cannot allocate (%s) %d byte(s)\n", pathname+9, mal->size);
-		free (mal);
+		gz_index_save (gz, filename);
 	}
-	return NULL;
+	gz->index_usec = r_sys_now () - t0;
+	return r_io_desc_new (io, &r_io_plugin_gzip, pathname, rw, mode, gz);
 }
 
 RIOPlugin r_io_plugin_gzip = {
 	.name = "gzip",
-	.desc = "Read/write gzipped files",
+	.desc = "Random access to gzipped and lz4 compressed files",
 	.license = "LGPL3",
-	.uris = "gzip://",
+	.uris = "gzip://,lz4://",
 	.open = __open,
 	.close = __close,
 	.read = __read,
 	.check = __plugin_open,
 	.lseek = __lseek,
 	.write = __write,
-	.resize = __resize,
+	.read_at = __read_at,
+	.write_at = __write_at,
+	.system = __system,
 };
 
 #ifndef CORELIB
@@ -120,6 +120,40 @@ static int __read(RIO *io, RIODesc *fd, ut8 *buf, int count) {
 	return count;
 }
 
+static st64 __read_at(RIO *io, RIODesc *fd, ut64 addr, ut8 *buf, ut64 count) {
+	memset (buf, 0xff, count);
+	if (!fd || !fd->data) {
+		return -1;
+	}
+	ut32 mallocsz = _io_malloc_sz (fd);
+	if (addr > mallocsz) {
+		return -1;
+	}
+	if (addr + count >= mallocsz) {
+		count = mallocsz - addr;
+	}
+	memcpy (buf, _io_malloc_buf (fd) + addr, count);
+	return count;
+}
+
+static st64 __write_at(RIO *io, RIODesc *fd, ut64 addr, const ut8 *buf, ut64 count) {
+	if (!fd || !buf || !fd->data) {
+		return -1;
+	}
+	ut32 mallocsz = _io_malloc_sz (fd);
+	if (addr > mallocsz) {
+		return -1;
+	}
+	if (addr + count > mallocsz) {
+		count = mallocsz - addr;
+	}
+	if (count > 0) {
+		memcpy (_io_malloc_buf (fd) + addr, buf, count);
+		return count;
+	}
+	return -1;
+}
+
 static int __close(RIODesc *fd) {
 	RIOMalloc *riom;
 	if (!fd || !fd->data) {
@@ -201,6 +235,8 @@ RIOPlugin r_io_plugin_malloc = {
 	.check = __check,
 	.lseek = __lseek,
 	.write = __write,
+	.read_at = __read_at,
+	.write_at = __write_at,
 	.resize = __resize,
 };
 
@@ -143,6 +143,50 @@ static int __write(RIO *io, RIODesc *fd, const ut8 *buf, int len) {
 	return ptrace_write_at (io, RIOPTRACE_PID (fd), buf, len, io->off);
 }
 
+static st64 __read_at(RIO *io, RIODesc *desc, ut64 addr, ut8 *buf, ut64 len) {
+	if (!desc || !desc->data) {
+		return -1;
+	}
+	memset (buf, '\xff', len);
+	ut64 done = 0;
+	while (done < len) {
+		int chunk = (int)R_MIN (len - done, ST32_MAX & ~3);
+		ut32 *aligned_buf = (ut32*)r_malloc_aligned (chunk, sizeof (ut32));
+		if (!aligned_buf) {
+			break;
+		}
+		int res = debug_os_read_at (io, RIOPTRACE_PID (desc), aligned_buf, chunk, addr + done);
+		if (res > 0) {
+			memcpy (buf + done, aligned_buf, res);
+			done += res;
+		}
+		r_free_aligned (aligned_buf);
+		if (res != chunk) {
+			break;
+		}
+	}
+	return done? done: -1;
+}
+
+static st64 __write_at(RIO *io, RIODesc *fd, ut64 addr, const ut8 *buf, ut64 len) {
+	if (!fd || !fd->data) {
+		return -1;
+	}
+	ut64 done = 0;
+	while (done < len) {
+		int chunk = (int)R_MIN (len - done, ST32_MAX & ~7);
+		int res = ptrace_write_at (io, RIOPTRACE_PID (fd), buf + done, chunk, addr + done);
+		if (res < 1) {
+			break;
+		}
+		done += res;
+		if (res != chunk) {
+			break;
+		}
+	}
+	return done? done: -1;
+}
+
 static void open_pidmem (RIOPtrace *iop) {
 #if USE_PROC_PID_MEM
 	char pidmem[32];
@@ -312,6 +356,8 @@ RIOPlugin r_io_plugin_ptrace = {
 	.lseek = __lseek,
 	.system = __system,
 	.write = __write,
+	.read_at = __read_at,
+	.write_at = __write_at,
 	.getpid = __getpid,
 	.gettid = __getpid,
 	.isdbg = true
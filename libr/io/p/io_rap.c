@@ -11,14 +11,239 @@
 #define RIORAP_IS_LISTEN(x) (((RIORap*)((x)->data))->listener)
 #define RIORAP_IS_VALID(x) ((x) && ((x)->data) && ((x)->plugin == &r_io_plugin_rap))
 
+/* with rap.cache, rap v2 reads go through a small direct mapped cache of
+ * RAP_BLOCK sized windows, filled page by page up to what was asked. It
+ * is off by default because nothing tells us when the remote data changes.
+ * Reads that miss it or are too big for it are split in window sized
+ * PREADs and up to RAP_INFLIGHT of them are sent in one batch. A short
+ * reply means the remote data ends there, the block remembers it with
+ * RAP_CACHE_EOF */
+#define RAP_BLOCK (64 * 1024)
+#define RAP_PAGE 4096
+#define RAP_CACHE_BLOCKS 64
+#define RAP_CACHE_MAXREAD (4 * RAP_BLOCK)
+#define RAP_CACHE_EOF 0x80000000
+#define RAP_INFLIGHT 32
+
+static void rap_cache_flush(RIORap *rap) {
+	if (rap->cache_addr) {
+		memset (rap->cache_addr, 0xff, RAP_CACHE_BLOCKS * sizeof (ut64));
+	}
+	rap->size = UT64_MAX;
+}
+
+static void rap_cache_free(RIORap *rap) {
+	R_FREE (rap->cache);
+	R_FREE (rap->cache_addr);
+	R_FREE (rap->cache_len);
+}
+
+/* reads the replies of the n PREADs still in flight from tag on, so the
+ * socket is clean for the v1 protocol */
+static void rap_drain(RIORap *rap, ut32 tag, const ut64 *len, int n) {
+	ut64 max = 0;
+	int i;
+	for (i = 0; i < n; i++) {
+		max = R_MAX (max, len[i]);
+	}
+	ut8 *tmp = max? malloc (max): NULL;
+	for (i = 0; tmp && i < n; i++) {
+		if (r_socket_rap_pread_recv (rap->client, tag + i, tmp, len[i]) < 0) {
+			break;
+		}
+	}
+	free (tmp);
+}
+
+/* reads up to len[i] bytes at off[i] into dst[i] and stores in got[i]
+ * how many came back */
+static bool rap_fetch(RIORap *rap, const ut64 *off, const ut64 *len, ut8 **dst, ut64 *got, int n) {
+	RSocket *s = rap->client;
+	int sent = 0, done = 0;
+	ut32 tag = rap->tag;
+	rap->tag += n;
+	while (done < n) {
+		if (sent < n && sent - done < RAP_INFLIGHT / 2) {
+			int batch = R_MIN (n - sent, RAP_INFLIGHT - (sent - done));
+			if (!r_socket_rap_pread (s, tag + sent, off + sent, len + sent, batch)) {
+				break;
+			}
+			sent += batch;
+		}
+		if (done == sent) {
+			break;
+		}
+		st64 r = r_socket_rap_pread_recv (s, tag + done, dst[done], len[done]);
+		done++;
+		if (r < 0) {
+			break;
+		}
+		got[done - 1] = r;
+	}
+	if (done == n) {
+		return true;
+	}
+	if (sent > done) {
+		rap_drain (rap, tag + done, len + done, sent - done);
+	}
+	eprintf ("rap: pread failed, falling back to v1\n");
+	rap->caps = 0;
+	rap_cache_flush (rap);
+	return false;
+}
+
+static int rap_pread_cached(RIORap *rap, ut64 addr, ut8 *buf, int count) {
+	ut64 off[RAP_CACHE_MAXREAD / RAP_BLOCK + 1], len[RAP_CACHE_MAXREAD / RAP_BLOCK + 1];
+	ut64 got[RAP_CACHE_MAXREAD / RAP_BLOCK + 1];
+	ut8 *dst[RAP_CACHE_MAXREAD / RAP_BLOCK + 1];
+	int slots[RAP_CACHE_MAXREAD / RAP_BLOCK + 1];
+	ut64 b, end = addr + count, first = addr / RAP_BLOCK, last = (end - 1) / RAP_BLOCK;
+	int i, n = 0;
+	if (!rap->cache) {
+		rap->cache = malloc (RAP_CACHE_BLOCKS * RAP_BLOCK);
+		rap->cache_addr = malloc (RAP_CACHE_BLOCKS * sizeof (ut64));
+		rap->cache_len = malloc (RAP_CACHE_BLOCKS * sizeof (ut32));
+		if (!rap->cache || !rap->cache_addr || !rap->cache_len) {
+			rap_cache_free (rap);
+			return -1;
+		}
+		rap_cache_flush (rap);
+	}
+	for (b = first; b <= last; b++) {
+		int slot = b % RAP_CACHE_BLOCKS;
+		ut64 base = b * RAP_BLOCK;
+		if (rap->cache_addr[slot] != base) {
+			rap->cache_addr[slot] = base;
+			rap->cache_len[slot] = 0;
+		}
+		if (rap->cache_len[slot] & RAP_CACHE_EOF) {
+			break;
+		}
+		ut64 have = rap->cache_len[slot];
+		ut64 want = end - base;
+		want = R_MIN (R_ROUND (want, RAP_PAGE), RAP_BLOCK);
+		if (have < want) {
+			off[n] = base + have;
+			len[n] = want - have;
+			dst[n] = rap->cache + slot * RAP_BLOCK + have;
+			slots[n] = slot;
+			n++;
+		}
+	}
+	if (n && !rap_fetch (rap, off, len, dst, got, n)) {
+		return -1;
+	}
+	for (i = 0; i < n; i++) {
+		rap->cache_len[slots[i]] += got[i];
+		if (got[i] < len[i]) {
+			rap->cache_len[slots[i]] |= RAP_CACHE_EOF;
+		}
+	}
+	int done = 0;
+	for (b = first; b <= last && done < count; b++) {
+		int slot = b % RAP_CACHE_BLOCKS;
+		ut64 have = rap->cache_len[slot] & ~RAP_CACHE_EOF;
+		ut64 delta = addr + done - b * RAP_BLOCK;
+		if (rap->cache_addr[slot] != b * RAP_BLOCK || delta >= have) {
+			break;
+		}
+		int chunk = R_MIN (count - done, have - delta);
+		memcpy (buf + done, rap->cache + slot * RAP_BLOCK + delta, chunk);
+		done += chunk;
+		if (have < RAP_BLOCK) {
+			break;
+		}
+	}
+	return done;
+}
+
+static int rap_pread(RIO *io, RIORap *rap, ut64 addr, ut8 *buf, int count) {
+	if (count < 1) {
+		return count;
+	}
+	if (!io->rapcache) {
+		// drop what was kept, it is stale when the cache comes back
+		rap_cache_free (rap);
+	} else if (count <= RAP_CACHE_MAXREAD && addr <= UT64_MAX - count) {
+		return rap_pread_cached (rap, addr, buf, count);
+	}
+	int i, n = (count + rap->window - 1) / rap->window;
+	ut64 *off = malloc (n * sizeof (ut64));
+	ut64 *len = malloc (n * sizeof (ut64));
+	ut64 *got = malloc (n * sizeof (ut64));
+	ut8 **dst = malloc (n * sizeof (ut8*));
+	int ret = -1;
+	if (off && len && got && dst) {
+		for (i = 0; i < n; i++) {
+			off[i] = addr + (ut64)i * rap->window;
+			len[i] = R_MIN (rap->window, count - i * rap->window);
+			dst[i] = buf + i * rap->window;
+		}
+		if (rap_fetch (rap, off, len, dst, got, n)) {
+			// bytes up to the first short reply
+			for (ret = 0, i = 0; i < n; i++) {
+				ret += got[i];
+				if (got[i] < len[i]) {
+					break;
+				}
+			}
+		}
+	}
+	free (off);
+	free (len);
+	free (got);
+	free (dst);
+	return ret;
+}
+
+static int rap_pwrite(RIORap *rap, ut64 addr, const ut8 *buf, int count) {
+	RSocket *s = rap->client;
+	int sent = 0, done = 0, ret = 0;
+	int n = (count + rap->window - 1) / rap->window;
+	ut32 tag = rap->tag;
+	rap->tag += n;
+	rap_cache_flush (rap);
+	while (done < n) {
+		while (sent < n && sent - done < RAP_INFLIGHT) {
+			int delta = sent * rap->window;
+			int len = R_MIN (rap->window, count - delta);
+			if (!r_socket_rap_pwrite (s, tag + sent, addr + delta, buf + delta, len)) {
+				return -1;
+			}
+			sent++;
+		}
+		r_socket_flush (s);
+		st64 w = r_socket_rap_pwrite_recv (s, tag + done);
+		if (w < 0) {
+			// read what is still in flight before v1 takes over
+			while (++done < sent && r_socket_rap_pwrite_recv (s, tag + done) >= 0) {
+				;
+			}
+			rap->caps = 0;
+			return -1;
+		}
+		ret += w;
+		done++;
+	}
+	return ret? ret: -1;
+}
+
 static int __rap_write(RIO *io, RIODesc *fd, const ut8 *buf, int count) {
 	RSocket *s = RIORAP_FD (fd);
+	RIORap *rap = fd->data;
 	ut8 *tmp;
 	int ret;
 
 	if (count < 1) {
 		return count;
 	}
+	if (rap->caps & RAP_CAP_PREAD) {
+		ret = rap_pwrite (rap, rap->off, buf, count);
+		if (ret > 0) {
+			rap->off += ret;
+		}
+		return ret;
+	}
 	// TOOD: if count > RMT_MAX iterate !
 	if (count > RMT_MAX) {
 		count = RMT_MAX;
@@ -33,7 +258,7 @@ static int __rap_write(RIO *io, RIODesc *fd, const ut8 *buf, int count) {
 
 	(void)r_socket_write (s, tmp, count + 5);
 	r_socket_flush (s);
-	if (r_socket_read (s, tmp, 5) != 5) { // TODO read_block?
+	if (!r_socket_rap_read (s, tmp, 5)) {
 		eprintf ("__rap_write: error\n");
 		ret = -1;
 	} else {
@@ -57,9 +282,17 @@ static bool __rap_accept(RIO *io, RIODesc *desc, int fd) {
 
 static int __rap_read(RIO *io, RIODesc *fd, ut8 *buf, int count) {
 	RSocket *s = RIORAP_FD (fd);
-	int ret, i = (int)count;
+	RIORap *rap = fd->data;
+	int i = (int)count;
 	ut8 tmp[5];
 
+	if (rap->caps & RAP_CAP_PREAD) {
+		int ret = rap_pread (io, rap, rap->off, buf, count);
+		if (ret > 0) {
+			rap->off += ret;
+		}
+		return ret;
+	}
 	// XXX. if count is > RMT_MAX, just perform multiple queries
 	if (count > RMT_MAX) {
 		count = RMT_MAX;
@@ -70,11 +303,10 @@ static int __rap_read(RIO *io, RIODesc *fd, ut8 *buf, int count) {
 	(void)r_socket_write (s, tmp, 5);
 	r_socket_flush (s);
 	// recv
-	ret = r_socket_read_block (s, tmp, 5);
-	if (ret != 5 || tmp[0] != (RMT_READ | RMT_REPLY)) {
+	if (!r_socket_rap_read (s, tmp, 5) || tmp[0] != (RMT_READ | RMT_REPLY)) {
 		eprintf ("__rap_read: Unexpected rap read reply "
-			"(%d=0x%02x) expected (%d=0x%02x)\n",
-			ret, tmp[0], 2, (RMT_READ | RMT_REPLY));
+			"(0x%02x) expected (0x%02x)\n",
+			tmp[0], (RMT_READ | RMT_REPLY));
 		return -1;
 	}
 	i = r_read_at_be32 (tmp, 1);
@@ -82,7 +314,7 @@ static int __rap_read(RIO *io, RIODesc *fd, ut8 *buf, int count) {
 		eprintf ("__rap_read: Unexpected data size %d\n", i);
 		return -1;
 	}
-	r_socket_read_block (s, buf, i);
+	r_socket_rap_read (s, buf, i);
 	return count;
 }
 
@@ -93,6 +325,7 @@ static int __rap_close(RIODesc *fd) {
 			RIORap *r = fd->data;
 			(void)r_socket_close (r->fd);
 			ret = r_socket_close (r->client);
+			rap_cache_free (r);
 			R_FREE (fd->data);
 		}
 	} else {
@@ -101,10 +334,8 @@ static int __rap_close(RIODesc *fd) {
 	return ret;
 }
 
-static ut64 __rap_lseek(RIO *io, RIODesc *fd, ut64 offset, int whence) {
-	RSocket *s = RIORAP_FD (fd);
+static ut64 rap_seek(RSocket *s, ut64 offset, int whence) {
 	ut8 tmp[10];
-	int ret;
 	// query
 	tmp[0] = RMT_SEEK;
 	tmp[1] = (ut8)whence;
@@ -113,8 +344,7 @@ static ut64 __rap_lseek(RIO *io, RIODesc *fd, ut64 offset, int whence) {
 	r_socket_flush (s);
 	// get reply
 	memset (tmp, 0, 9);
-	ret = r_socket_read_block (s, (ut8*)&tmp, 9);
-	if (ret != 9 || tmp[0] != (RMT_SEEK | RMT_REPLY)) {
+	if (!r_socket_rap_read (s, tmp, 9) || tmp[0] != (RMT_SEEK | RMT_REPLY)) {
 		// eprintf ("%d %d  - %02x %02x %02x %02x %02x %02x %02x\n",
 		// ret, whence, tmp[0], tmp[1], tmp[2], tmp[3], tmp[4], tmp[5], tmp[6]);
 		eprintf ("Unexpected lseek reply\n");
@@ -124,6 +354,148 @@ static ut64 __rap_lseek(RIO *io, RIODesc *fd, ut64 offset, int whence) {
 	return offset;
 }
 
+/* with rap v2 the offset travels with every PREAD, so seeking is local
+ * except for SEEK_END which needs the remote size */
+static ut64 __rap_lseek(RIO *io, RIODesc *fd, ut64 offset, int whence) {
+	RIORap *rap = fd->data;
+	if (!(rap->caps & RAP_CAP_PREAD)) {
+		return rap_seek (RIORAP_FD (fd), offset, whence);
+	}
+	switch (whence) {
+	case SEEK_SET:
+		rap->off = offset;
+		break;
+	case SEEK_CUR:
+		rap->off += offset;
+		break;
+	case SEEK_END:
+		if (rap->size == UT64_MAX) {
+			rap->size = rap_seek (rap->client, 0, SEEK_END);
+			if (rap->size == UT64_MAX) {
+				return UT64_MAX;
+			}
+		}
+		rap->off = rap->size + offset;
+		break;
+	}
+	return rap->off;
+}
+
+/* runs command on the server and returns its output */
+static char *rap_system(RIO *io, RIORap *rap, const char *command) {
+	int ret, reslen = 0, cmdlen = 0;
+	RSocket *s = rap->client;
+	unsigned int i;
+	char *ptr, *res, *str;
+	ut8 buf[RMT_MAX];
+	bool seeked = false;
+
+	buf[0] = RMT_CMD;
+	i = strlen (command) + 1;
+	if (i > RMT_MAX - 5) {
+		eprintf ("Command too long\n");
+		return NULL;
+	}
+	if (rap->caps & RAP_CAP_PREAD) {
+		/* the server only follows our seeks when asked to, move it
+		 * before the command runs without waiting for the reply */
+		ut8 tmp[10];
+		tmp[0] = RMT_SEEK;
+		tmp[1] = SEEK_SET;
+		r_write_be64 (tmp + 2, rap->off);
+		(void)r_socket_write (s, tmp, 10);
+		seeked = true;
+		// the command may change anything behind our back
+		rap_cache_flush (rap);
+	}
+	r_write_be32 (buf + 1, i);
+	memcpy (buf + 5, command, i);
+	(void)r_socket_write (s, buf, i+5);
+	r_socket_flush (s);
+	if (seeked) {
+		if (!r_socket_rap_read (s, buf, 9) || buf[0] != (RMT_SEEK | RMT_REPLY)) {
+			eprintf ("Unexpected lseek reply\n");
+			return NULL;
+		}
+	}
+
+	/* read reverse cmds */
+	for (;;) {
+		if (!r_socket_rap_read (s, buf, 1)) {
+			return NULL;
+		}
+		/* system back in the middle */
+		/* TODO: all pkt handlers should check for reverse queries */
+		if (buf[0] != RMT_CMD) {
+			break;
+		}
+		// run io->cmdstr
+		// return back the string
+		buf[0] |= RMT_REPLY;
+		memset (buf + 1, 0, 4);
+		if (!r_socket_rap_read (s, buf + 1, 4)) {
+			return NULL;
+		}
+		cmdlen = r_read_at_be32 (buf, 1);
+		if (cmdlen + 1 == 0) { // check overflow
+			cmdlen = 0;
+		}
+		str = calloc (1, cmdlen + 1);
+		ret = r_socket_read_block (s, (ut8*)str, cmdlen);
+		eprintf ("RUN %d CMD(%s)\n", ret, str);
+		if (str && *str) {
+			res = io->cb_core_cmdstr (io->user, str);
+		} else {
+			res = strdup ("");
+		}
+		eprintf ("[%s]=>(%s)\n", str, res);
+		reslen = strlen (res);
+		free (str);
+		r_write_be32 (buf + 1, reslen);
+		memcpy (buf + 5, res, reslen);
+		free (res);
+		(void)r_socket_write (s, buf, reslen + 5);
+		r_socket_flush (s);
+	}
+
+	// read
+	if (!r_socket_rap_read (s, buf + 1, 4)) {
+		return NULL;
+	}
+	if (buf[0] != (RMT_CMD | RMT_REPLY)) {
+		eprintf ("Unexpected rap cmd reply\n");
+		return NULL;
+	}
+
+	i = r_read_at_be32 (buf, 1);
+	if (i > ST32_MAX) {
+		eprintf ("Invalid length\n");
+		return NULL;
+	}
+	ptr = (char *)calloc (1, i + 1);
+	if (ptr && !r_socket_rap_read (s, (ut8*)ptr, i)) {
+		R_FREE (ptr);
+	}
+	return ptr;
+}
+
+/* asks for rap v2, v1 servers just echo the hello back */
+static void rap_hello(RIO *io, RIORap *rap) {
+	char hello[32];
+	int caps = 0, window = 0;
+	snprintf (hello, sizeof (hello), RAP_HELLO"%d", RAP_CAP_PREAD | RAP_CAP_LZ4);
+	char *res = rap_system (io, rap, hello);
+	if (res && !strncmp (res, RAP_HELLO_REPLY, strlen (RAP_HELLO_REPLY))
+			&& sscanf (res + strlen (RAP_HELLO_REPLY), "%d,%d", &caps, &window) == 2
+			&& (caps & RAP_CAP_PREAD) && window > 0) {
+		rap->caps = caps;
+		rap->window = R_MIN (window, RAP_WINDOW);
+		rap->size = UT64_MAX;
+		eprintf ("rap: using protocol v2%s\n", (caps & RAP_CAP_LZ4)? " with lz4": "");
+	}
+	free (res);
+}
+
 static bool __rap_plugin_open(RIO *io, const char *pathname, bool many) {
 	return (!strncmp (pathname, "rap://", 6)) \
 		|| (!strncmp (pathname, "raps://", 7));
@@ -208,6 +580,7 @@ static RIODesc *__rap_open(RIO *io, const char *pathname, int rw, int mode) {
 	rior = R_NEW0 (RIORap);
 	rior->listener = false;
 	rior->client = rior->fd = rap_fd;
+	rap_hello (io, rior);
 	if (file && *file) {
 		// send
 		buf[0] = RMT_OPEN;
@@ -219,7 +592,7 @@ static RIODesc *__rap_open(RIO *io, const char *pathname, int rw, int mode) {
 		// read
 		eprintf ("waiting... ");
 		buf[0] = 0;
-		r_socket_read_block (rap_fd, (ut8*)buf, 5);
+		r_socket_rap_read (rap_fd, (ut8*)buf, 5);
 		if (buf[0] != (char)(RMT_OPEN | RMT_REPLY)) {
 			eprintf ("rap: Expecting OPEN|REPLY packet. got %02x\n", buf[0]);
 			r_socket_free (rap_fd);
@@ -263,92 +636,10 @@ static int __rap_listener(RIODesc *fd) {
 }
 
 static char *__rap_system(RIO *io, RIODesc *fd, const char *command) {
-	int ret, reslen = 0, cmdlen = 0;
-	RSocket *s = RIORAP_FD (fd);
-	unsigned int i;
-	char *ptr, *res, *str;
-	ut8 buf[RMT_MAX];
-
-	buf[0] = RMT_CMD;
-	i = strlen (command) + 1;
-	if (i > RMT_MAX - 5) {
-		eprintf ("Command too long\n");
-		return NULL;
-	}
-	r_write_be32 (buf + 1, i);
-	memcpy (buf + 5, command, i);
-	(void)r_socket_write (s, buf, i+5);
-	r_socket_flush (s);
-
-	/* read reverse cmds */
-	for (;;) {
-		ret = r_socket_read_block (s, buf, 1);
-		if (ret != 1) {
-			return NULL;
-		}
-		/* system back in the middle */
-		/* TODO: all pkt handlers should check for reverse queries */
-		if (buf[0] != RMT_CMD) {
-			break;
-		}
-		// run io->cmdstr
-		// return back the string
-		buf[0] |= RMT_REPLY;
-		memset (buf + 1, 0, 4);
-		ret = r_socket_read_block (s, buf + 1, 4);
-		if (ret != 4) {
-			return NULL;
-		}
-		cmdlen = r_read_at_be32 (buf, 1);
-		if (cmdlen + 1 == 0) { // check overflow
-			cmdlen = 0;
-		}
-		str = calloc (1, cmdlen + 1);
-		ret = r_socket_read_block (s, (ut8*)str, cmdlen);
-		eprintf ("RUN %d CMD(%s)\n", ret, str);
-		if (str && *str) {
-			res = io->cb_core_cmdstr (io->user, str);
-		} else {
-			res = strdup ("");
-		}
-		eprintf ("[%s]=>(%s)\n", str, res);
-		reslen = strlen (res);
-		free (str);
-		r_write_be32 (buf + 1, reslen);
-		memcpy (buf + 5, res, reslen);
-		free (res);
-		(void)r_socket_write (s, buf, reslen + 5);
-		r_socket_flush (s);
-	}
-
-	// read
-	ret = r_socket_read_block (s, buf + 1, 4);
-	if (ret != 4) {
-		return NULL;
-	}
-	if (buf[0] != (RMT_CMD | RMT_REPLY)) {
-		eprintf ("Unexpected rap cmd reply\n");
-		return NULL;
-	}
-
-	i = r_read_at_be32 (buf, 1);
-	ret = 0;
-	if (i > ST32_MAX) {
-		eprintf ("Invalid length\n");
-		return NULL;
-	}
-	ptr = (char *)calloc (1, i + 1);
+	char *ptr = rap_system (io, fd->data, command);
 	if (ptr) {
-		int ir, tr = 0;
-		do {
-			ir = r_socket_read_block (s, (ut8*)ptr + tr, i - tr);
-			if (ir < 1) {
-				break;
-			}
-			tr += ir;
-		} while (tr < i);
+		int i = strlen (ptr);
 		// TODO: use io->cb_printf() with support for \x00
-		ptr[i] = 0;
 		if (io->cb_printf) {
 			io->cb_printf ("%s", ptr);
 		} else {
@@ -358,12 +649,6 @@ static char *__rap_system(RIO *io, RIODesc *fd, const char *command) {
 		}
 		free (ptr);
 	}
-#if DEAD_CODE
-	/* Clean */
-	if (ret > 0) {
-		ret -= r_socket_read (s, (ut8*)buf, RMT_MAX);
-	}
-#endif
 	return NULL;
 }
 
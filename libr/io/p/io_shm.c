@@ -55,6 +55,38 @@ static int shm__read(RIO *io, RIODesc *fd, ut8 *buf, int count) {
 	return count;
 }
 
+static st64 shm__read_at(RIO *io, RIODesc *fd, ut64 addr, ut8 *buf, ut64 count) {
+	RIOShm *shm;
+	if (!fd || !fd->data) {
+		return -1;
+	}
+	shm = fd->data;
+	if (addr + count >= shm->size) {
+		if (addr > shm->size) {
+			return -1;
+		}
+		count = shm->size - addr;
+	}
+	memcpy (buf, shm->buf + addr, count);
+	return count;
+}
+
+static st64 shm__write_at(RIO *io, RIODesc *fd, ut64 addr, const ut8 *buf, ut64 count) {
+	RIOShm *shm;
+	if (!fd || !fd->data) {
+		return -1;
+	}
+	shm = fd->data;
+	if (!shm->buf || addr > shm->size) {
+		return -1;
+	}
+	if (addr + count > shm->size) {
+		count = shm->size - addr;
+	}
+	(void)memcpy (shm->buf + addr, buf, count);
+	return count;
+}
+
 static int shm__close(RIODesc *fd) {
 	int ret;
 	if (!fd || !fd->data) {
@@ -129,6 +161,8 @@ RIOPlugin r_io_plugin_shm = {
 	.check = shm__plugin_open,
 	.lseek = shm__lseek,
 	.write = shm__write,
+	.read_at = shm__read_at,
+	.write_at = shm__write_at,
 };
 
 #else
@@ -175,16 +175,54 @@ R_API int r_io_plugin_write(RIODesc *desc, const ut8 *buf, int len) {
 	return desc->plugin->write (desc->io, desc, buf, len);
 }
 
-R_API int r_io_plugin_read_at(RIODesc *desc, ut64 addr, ut8 *buf, int len) {
-	if (r_io_desc_is_chardevice (desc) || (r_io_desc_seek (desc, addr, R_IO_SEEK_SET) == addr)) {
-		return r_io_plugin_read (desc, buf, len);
+// uses the positional callbacks when the plugin provides them, so the
+// desc seek state is left untouched and reads can happen concurrently
+R_API st64 r_io_plugin_read_at(RIODesc *desc, ut64 addr, ut8 *buf, ut64 len) {
+	if (!buf || !desc || !desc->plugin || !len || !(desc->perm & R_PERM_R)) {
+		return 0;
+	}
+	if (desc->plugin->read_at) {
+		return desc->plugin->read_at (desc->io, desc, addr, buf, len);
+	}
+	if (!r_io_desc_is_chardevice (desc) && r_io_desc_seek (desc, addr, R_IO_SEEK_SET) != addr) {
+		return 0;
+	}
+	ut64 done = 0;
+	while (done < len) {
+		int chunk = (int)R_MIN (len - done, ST32_MAX);
+		int ret = r_io_plugin_read (desc, buf + done, chunk);
+		if (ret < 1) {
+			return done? done: ret;
+		}
+		done += ret;
+		if (ret != chunk) {
+			break;
+		}
 	}
-	return 0;
+	return done;
 }
 
-R_API int r_io_plugin_write_at(RIODesc *desc, ut64 addr, const ut8 *buf, int len) {
-	if (r_io_desc_is_chardevice (desc) || r_io_desc_seek (desc, addr, R_IO_SEEK_SET)  == addr) {
-		return r_io_plugin_write (desc, buf, len);
+R_API st64 r_io_plugin_write_at(RIODesc *desc, ut64 addr, const ut8 *buf, ut64 len) {
+	if (!buf || !desc || !desc->plugin || !len || !(desc->perm & R_PERM_W)) {
+		return 0;
+	}
+	if (desc->plugin->write_at) {
+		return desc->plugin->write_at (desc->io, desc, addr, buf, len);
+	}
+	if (!r_io_desc_is_chardevice (desc) && r_io_desc_seek (desc, addr, R_IO_SEEK_SET) != addr) {
+		return 0;
+	}
+	ut64 done = 0;
+	while (done < len) {
+		int chunk = (int)R_MIN (len - done, ST32_MAX);
+		int ret = r_io_plugin_write (desc, buf + done, chunk);
+		if (ret < 1) {
+			return done? done: ret;
+		}
+		done += ret;
+		if (ret != chunk) {
+			break;
+		}
 	}
-	return 0;
+	return done;
 }
@@ -1,4 +1,4 @@
-/* radare - LGPL - Copyright 2015-2016 - pancake */
+/* radare - LGPL - Copyright 2015-2019 - pancake */
 /*
 Usage Example:
 
@@ -19,6 +19,7 @@ Usage Example:
 #include <r_util.h>
 #include <r_cons.h>
 #include <r_socket.h>
+#include <errno.h>
 
 #define R2P_PID(x) (((R2Pipe*)(x)->data)->pid)
 #define R2P_INPUT(x) (((R2Pipe*)(x)->data)->input[0])
@@ -32,27 +33,220 @@ static void env(const char *s, int f) {
 }
 #endif
 
+#define R2PIPE_BUFSZ (64 * 1024)
+
+#if !__WINDOWS__ || defined(__CYGWIN__)
+static bool write_all(int fd, const ut8 *buf, int len) {
+	while (len > 0) {
+		int rv = write (fd, buf, len);
+		if (rv < 1) {
+			if (rv == -1 && errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		buf += rv;
+		len -= rv;
+	}
+	return true;
+}
+
+/* makes room for more bytes at the end of the read buffer */
+static bool buf_reserve(R2Pipe *r2pipe, int len) {
+	if (r2pipe->buf_off && r2pipe->buf_off == r2pipe->buf_len) {
+		r2pipe->buf_off = r2pipe->buf_len = 0;
+	}
+	if (r2pipe->buf_len + len <= r2pipe->buf_size) {
+		return true;
+	}
+	if (r2pipe->buf_off) {
+		memmove (r2pipe->buf, r2pipe->buf + r2pipe->buf_off, r2pipe->buf_len - r2pipe->buf_off);
+		r2pipe->buf_len -= r2pipe->buf_off;
+		r2pipe->buf_off = 0;
+		if (r2pipe->buf_len + len <= r2pipe->buf_size) {
+			return true;
+		}
+	}
+	int size = R_MAX (r2pipe->buf_size * 2, r2pipe->buf_len + len);
+	ut8 *buf = realloc (r2pipe->buf, size);
+	if (!buf) {
+		return false;
+	}
+	r2pipe->buf = buf;
+	r2pipe->buf_size = size;
+	return true;
+}
+
+/* reads whatever the pipe has, up to one buffer, blocking if it is empty */
+static int buf_fill(R2Pipe *r2pipe) {
+	if (!buf_reserve (r2pipe, R2PIPE_BUFSZ)) {
+		return -1;
+	}
+	int rv;
+	do {
+		rv = read (r2pipe->output[0], r2pipe->buf + r2pipe->buf_len, R2PIPE_BUFSZ);
+	} while (rv == -1 && errno == EINTR);
+	if (rv > 0) {
+		r2pipe->buf_len += rv;
+	}
+	return rv;
+}
+
+/* pulls the replies that are ready without blocking, so the server never
+ * stalls writing them while the client is still queueing requests */
+static void buf_drain(R2Pipe *r2pipe) {
+	struct pollfd pfd = { r2pipe->output[0], POLLIN, 0 };
+	while (poll (&pfd, 1, 0) == 1 && (pfd.revents & POLLIN)) {
+		if (buf_fill (r2pipe) < 1) {
+			break;
+		}
+	}
+}
+
+static bool buf_read(R2Pipe *r2pipe, ut8 *dst, int len) {
+	while (len > 0) {
+		int avail = r2pipe->buf_len - r2pipe->buf_off;
+		if (avail > 0) {
+			int n = R_MIN (avail, len);
+			memcpy (dst, r2pipe->buf + r2pipe->buf_off, n);
+			r2pipe->buf_off += n;
+			dst += n;
+			len -= n;
+		} else if (len >= R2PIPE_BUFSZ) {
+			// big payloads go straight to their final place
+			int rv = read (r2pipe->output[0], dst, len);
+			if (rv < 1) {
+				if (rv == -1 && errno == EINTR) {
+					continue;
+				}
+				return false;
+			}
+			dst += rv;
+			len -= rv;
+		} else if (buf_fill (r2pipe) < 1) {
+			return false;
+		}
+	}
+	return true;
+}
+#endif
+
+R_API bool r2pipe_frame_write(int fd, ut32 id, const void *data, ut32 len) {
+#if __WINDOWS__ && !defined(__CYGWIN__)
+	return false;
+#else
+	ut8 small[4096];
+	r_write_be32 (small, len);
+	r_write_be32 (small + 4, id);
+	if (len <= sizeof (small) - R2PIPE_FRAME_HDR) {
+		if (len) {
+			memcpy (small + R2PIPE_FRAME_HDR, data, len);
+		}
+		return write_all (fd, small, R2PIPE_FRAME_HDR + len);
+	}
+	return write_all (fd, small, R2PIPE_FRAME_HDR) && write_all (fd, data, len);
+#endif
+}
+
+/* queues a command in framed mode and returns its request id, replies can
+ * be collected later with r2pipe_recv and come back in the same order */
+R_API ut32 r2pipe_send(R2Pipe *r2pipe, const char *cmd) {
+	r_return_val_if_fail (r2pipe && cmd, 0);
+#if __WINDOWS__ && !defined(__CYGWIN__)
+	return 0;
+#else
+	if (!r2pipe->framed) {
+		return 0;
+	}
+	int len = strlen (cmd);
+	if (len + R2PIPE_FRAME_HDR > r2pipe->wbuf_size) {
+		int size = R_MAX (len + R2PIPE_FRAME_HDR, 256);
+		ut8 *wbuf = realloc (r2pipe->wbuf, size);
+		if (!wbuf) {
+			return 0;
+		}
+		r2pipe->wbuf = wbuf;
+		r2pipe->wbuf_size = size;
+	}
+	if (!++r2pipe->id) {
+		r2pipe->id++;
+	}
+	r_write_be32 (r2pipe->wbuf, len);
+	r_write_be32 (r2pipe->wbuf + 4, r2pipe->id);
+	memcpy (r2pipe->wbuf + R2PIPE_FRAME_HDR, cmd, len);
+	buf_drain (r2pipe);
+	if (!write_all (r2pipe->input[1], r2pipe->wbuf, len + R2PIPE_FRAME_HDR)) {
+		return 0;
+	}
+	return r2pipe->id;
+#endif
+}
+
+/* returns the next framed reply, which may hold NUL bytes, its request
+ * id and length are stored in id and len if given */
+R_API char *r2pipe_recv(R2Pipe *r2pipe, ut32 *id, int *len) {
+	r_return_val_if_fail (r2pipe, NULL);
+#if __WINDOWS__ && !defined(__CYGWIN__)
+	return NULL;
+#else
+	ut8 hdr[R2PIPE_FRAME_HDR];
+	if (!r2pipe->framed || !buf_read (r2pipe, hdr, sizeof (hdr))) {
+		return NULL;
+	}
+	ut32 size = r_read_be32 (hdr);
+	char *res = (size < INT_MAX)? malloc (size + 1): NULL;
+	if (!res) {
+		return NULL;
+	}
+	if (!buf_read (r2pipe, (ut8 *)res, size)) {
+		free (res);
+		return NULL;
+	}
+	res[size] = 0;
+	if (id) {
+		*id = r_read_be32 (hdr + 4);
+	}
+	if (len) {
+		*len = size;
+	}
+	return res;
+#endif
+}
+
 R_API int r2pipe_write(R2Pipe *r2pipe, const char *str) {
-	char *cmd;
 	int ret, len;
 	if (!r2pipe || !str) {
 		return -1;
 	}
+	if (r2pipe->framed) {
+		return r2pipe_send (r2pipe, str) != 0;
+	}
 	len = strlen (str) + 2; /* include \n\x00 */
-	cmd = malloc (len + 2);
+#if __WINDOWS__ && !defined(__CYGWIN__)
+	char *cmd = malloc (len + 2);
 	if (!cmd) {
 		return 0;
 	}
 	memcpy (cmd, str, len - 1);
 	strcpy (cmd + len - 2, "\n");
-#if __WINDOWS__ && !defined(__CYGWIN__)
 	DWORD dwWritten = -1;
 	WriteFile (r2pipe->pipe, cmd, len, &dwWritten, NULL);
 	ret = (dwWritten == len);
+	free (cmd);
 #else
-	ret = (write (r2pipe->input[1], cmd, len) == len);
+	if (len > r2pipe->wbuf_size) {
+		int size = R_MAX (len, 256);
+		ut8 *wbuf = realloc (r2pipe->wbuf, size);
+		if (!wbuf) {
+			return 0;
+		}
+		r2pipe->wbuf = wbuf;
+		r2pipe->wbuf_size = size;
+	}
+	memcpy (r2pipe->wbuf, str, len - 2);
+	memcpy (r2pipe->wbuf + len - 2, "\n", 2);
+	ret = write_all (r2pipe->input[1], r2pipe->wbuf, len);
 #endif
-	free (cmd);
 	return ret;
 }
 
@@ -63,12 +257,15 @@ R_API char *r2pipe_read(R2Pipe *r2pipe) {
 	if (!r2pipe) {
 		return NULL;
 	}
+	if (r2pipe->framed) {
+		return r2pipe_recv (r2pipe, NULL, NULL);
+	}
+#if __WINDOWS__ && !defined(__CYGWIN__)
 	bufsz = 4096;
 	buf = calloc (1, bufsz);
 	if (!buf) {
 		return NULL;
 	}
-#if __WINDOWS__ && !defined(__CYGWIN__)
 	BOOL bSuccess = FALSE;
 	DWORD dwRead = 0;
 	// TODO: handle > 4096 buffers here
@@ -81,31 +278,62 @@ R_API char *r2pipe_read(R2Pipe *r2pipe) {
 	}
 	buf[bufsz - 1] = 0;
 #else
-	char *newbuf;
-	int i, rv;
-	for (i = 0; i < bufsz; i++) {
-		rv = read (r2pipe->output[0], buf + i, 1);
-		if (i + 2 >= bufsz) {
-			bufsz += 4096;
-			newbuf = realloc (buf, bufsz);
+	// the reply ends at the first NUL byte, read in bulk and keep the rest
+	int len = 0;
+	for (;;) {
+		ut8 *start = r2pipe->buf + r2pipe->buf_off;
+		int avail = r2pipe->buf_len - r2pipe->buf_off;
+		ut8 *nul = avail > 0? memchr (start, 0, avail): NULL;
+		int n = nul? nul - start: avail;
+		if (len + n + 1 > bufsz) {
+			bufsz = R_MAX (bufsz * 2, len + n + 1);
+			char *newbuf = realloc (buf, bufsz);
 			if (!newbuf) {
 				R_FREE (buf);
 				break;
 			}
 			buf = newbuf;
 		}
-		if (rv != 1 || !buf[i]) {
+		memcpy (buf + len, start, n);
+		len += n;
+		r2pipe->buf_off += n;
+		if (nul) {
+			r2pipe->buf_off++;
+			break;
+		}
+		if (buf_fill (r2pipe) < 1) {
 			break;
 		}
 	}
 	if (buf) {
-		int zpos = (i < bufsz)? i: i - 1;
-		buf[zpos] = 0;
+		buf[len] = 0;
 	}
 #endif
 	return buf;
 }
 
+/* asks the other end to switch to the framed protocol, stays in the plain
+ * NUL terminated one if it does not know about it */
+R_API bool r2pipe_framed(R2Pipe *r2pipe) {
+	r_return_val_if_fail (r2pipe, false);
+#if __WINDOWS__ && !defined(__CYGWIN__)
+	return false;
+#else
+	if (r2pipe->framed || r2pipe->coreb.core) {
+		return r2pipe->framed;
+	}
+	// no trailing NUL like r2pipe_write sends, the server switches right
+	// after the newline and would take it as the start of the first frame
+	if (!write_all (r2pipe->input[1], (const ut8 *)R2PIPE_FRAMED_HELLO "\n", strlen (R2PIPE_FRAMED_HELLO) + 1)) {
+		return false;
+	}
+	char *res = r2pipe_read (r2pipe);
+	r2pipe->framed = res && !strcmp (res, R2PIPE_FRAMED_ACK);
+	free (res);
+	return r2pipe->framed;
+#endif
+}
+
 R_API int r2pipe_close(R2Pipe *r2pipe) {
 	if (!r2pipe) {
 		return 0;
@@ -138,6 +366,8 @@ R_API int r2pipe_close(R2Pipe *r2pipe) {
 		r2pipe->child = -1;
 	}
 #endif
+	free (r2pipe->buf);
+	free (r2pipe->wbuf);
 	free (r2pipe);
 	return 0;
 }
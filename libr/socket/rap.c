@@ -0,0 +1,207 @@
+/* radare - LGPL - Copyright 2019 - pancake */
+
+#include <r_socket.h>
+#include <r_util.h>
+
+/* rap v2 helpers shared by io_rap, r_core_serve and the rap server api,
+ * see the protocol description in r_socket.h */
+
+// smaller replies are not worth compressing
+#define RAP_LZ4_MIN 512
+
+// seconds without any data before a read gives up
+#define RAP_READ_TIMEOUT 30
+
+/* r_socket_read gives up when nothing is ready, keep waiting instead
+ * because a reply over a slow link can take longer than that. Stops on
+ * EOF, on a closed socket or after RAP_READ_TIMEOUT seconds of silence */
+R_API bool r_socket_rap_read(RSocket *s, ut8 *buf, ut64 len) {
+	r_return_val_if_fail (s && buf, false);
+	int idle = 0;
+	while (len > 0) {
+		if (s->fd == -1) {
+			return false;
+		}
+		int ready = r_socket_ready (s, 0, 500 * 1000);
+		if (ready < 0) {
+			return false;
+		}
+		if (!ready) {
+			if (++idle >= RAP_READ_TIMEOUT * 2) {
+				eprintf ("rap: no reply after %d seconds\n", RAP_READ_TIMEOUT);
+				return false;
+			}
+			continue;
+		}
+		idle = 0;
+		int n = r_socket_read (s, buf, len > ST32_MAX? ST32_MAX: (int)len);
+		if (n < 1) {
+			return false;
+		}
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
+
+/* consumes a reply payload that cannot be used, so the next reply can
+ * still be read */
+static bool rap_skip(RSocket *s, ut64 len) {
+	ut8 tmp[4096];
+	while (len > 0) {
+		ut64 n = R_MIN (len, sizeof (tmp));
+		if (!r_socket_rap_read (s, tmp, n)) {
+			return false;
+		}
+		len -= n;
+	}
+	return true;
+}
+
+/* returns the reply for a RAP_HELLO command or NULL if cmd is not one */
+R_API char *r_socket_rap_hello(const char *cmd, int caps, int *ocaps) {
+	r_return_val_if_fail (cmd, NULL);
+	const size_t hello_len = strlen (RAP_HELLO);
+	if (strncmp (cmd, RAP_HELLO, hello_len)) {
+		return NULL;
+	}
+	caps &= atoi (cmd + hello_len);
+	if (ocaps) {
+		*ocaps = caps;
+	}
+	return r_str_newf (RAP_HELLO_REPLY"%d,%d\n", caps, RAP_WINDOW);
+}
+
+/* sends n PREAD requests tagged tag..tag+n-1 in a single write */
+R_API bool r_socket_rap_pread(RSocket *s, ut32 tag, const ut64 *off, const ut64 *len, int n) {
+	r_return_val_if_fail (s && off && len && n > 0, false);
+	ut8 *req = malloc (n * RAP_PREAD_SIZE);
+	if (!req) {
+		return false;
+	}
+	int i;
+	for (i = 0; i < n; i++) {
+		ut8 *r = req + i * RAP_PREAD_SIZE;
+		r[0] = RAP_RMT_PREAD;
+		r_write_be32 (r + 1, tag + i);
+		r_write_be64 (r + 5, off[i]);
+		r_write_be64 (r + 13, len[i]);
+	}
+	bool ret = r_socket_write (s, req, n * RAP_PREAD_SIZE) == n * RAP_PREAD_SIZE;
+	r_socket_flush (s);
+	free (req);
+	return ret;
+}
+
+R_API bool r_socket_rap_pread_reply(RSocket *s, ut32 tag, const ut8 *buf, ut64 len, int caps) {
+	r_return_val_if_fail (s && (buf || !len) && len <= RAP_WINDOW, false);
+	ut8 hdr[RAP_PREAD_REPLY_SIZE];
+	const ut8 *data = buf;
+	ut32 wlen = (ut32)len;
+	ut8 *cbuf = NULL;
+	hdr[5] = 0;
+	if ((caps & RAP_CAP_LZ4) && len >= RAP_LZ4_MIN) {
+		int bound = r_lz4_bound ((int)len);
+		cbuf = malloc (bound);
+		if (cbuf) {
+			int n = r_lz4_compress (buf, (int)len, cbuf, bound);
+			if (n > 0 && n < len) {
+				data = cbuf;
+				wlen = n;
+				hdr[5] = RAP_CAP_LZ4;
+			}
+		}
+	}
+	hdr[0] = RAP_RMT_PREAD | RAP_RMT_REPLY;
+	r_write_be32 (hdr + 1, tag);
+	r_write_be64 (hdr + 6, len);
+	r_write_be32 (hdr + 14, wlen);
+	bool ret = r_socket_write (s, hdr, sizeof (hdr)) == sizeof (hdr);
+	if (ret && wlen) {
+		ret = r_socket_write (s, (void *)data, wlen) == wlen;
+	}
+	r_socket_flush (s);
+	free (cbuf);
+	return ret;
+}
+
+/* reads the reply for the PREAD tagged with tag into buf, returns the
+ * number of bytes read or -1 */
+R_API st64 r_socket_rap_pread_recv(RSocket *s, ut32 tag, ut8 *buf, ut64 len) {
+	r_return_val_if_fail (s && buf, -1);
+	ut8 hdr[RAP_PREAD_REPLY_SIZE];
+	if (!r_socket_rap_read (s, hdr, sizeof (hdr))) {
+		return -1;
+	}
+	if (hdr[0] != (RAP_RMT_PREAD | RAP_RMT_REPLY) || r_read_be32 (hdr + 1) != tag) {
+		eprintf ("rap: unexpected pread reply 0x%02x\n", hdr[0]);
+		return -1;
+	}
+	ut64 rlen = r_read_be64 (hdr + 6);
+	ut32 wlen = r_read_be32 (hdr + 14);
+	if (rlen > len || rlen > RAP_WINDOW) {
+		eprintf ("rap: unexpected pread size %"PFMT64d"\n", rlen);
+		rap_skip (s, wlen);
+		return -1;
+	}
+	if (!(hdr[5] & RAP_CAP_LZ4)) {
+		if (wlen != rlen) {
+			rap_skip (s, wlen);
+			return -1;
+		}
+		return r_socket_rap_read (s, buf, rlen)? (st64)rlen: -1;
+	}
+	if (wlen > r_lz4_bound ((int)rlen)) {
+		rap_skip (s, wlen);
+		return -1;
+	}
+	ut8 *cbuf = malloc (wlen + 1);
+	if (!cbuf) {
+		return -1;
+	}
+	st64 ret = -1;
+	if (r_socket_rap_read (s, cbuf, wlen)
+			&& r_lz4_decompress (cbuf, wlen, buf, (int)rlen) == rlen) {
+		ret = rlen;
+	}
+	free (cbuf);
+	return ret;
+}
+
+R_API bool r_socket_rap_pwrite(RSocket *s, ut32 tag, ut64 off, const ut8 *buf, ut64 len) {
+	r_return_val_if_fail (s && (buf || !len) && len <= RAP_WINDOW, false);
+	ut8 req[RAP_PREAD_SIZE];
+	req[0] = RAP_RMT_PWRITE;
+	r_write_be32 (req + 1, tag);
+	r_write_be64 (req + 5, off);
+	r_write_be64 (req + 13, len);
+	if (r_socket_write (s, req, sizeof (req)) != sizeof (req)) {
+		return false;
+	}
+	return !len || r_socket_write (s, (void *)buf, (int)len) == len;
+}
+
+R_API bool r_socket_rap_pwrite_reply(RSocket *s, ut32 tag, ut64 written) {
+	r_return_val_if_fail (s, false);
+	ut8 rep[RAP_PWRITE_REPLY_SIZE];
+	rep[0] = RAP_RMT_PWRITE | RAP_RMT_REPLY;
+	r_write_be32 (rep + 1, tag);
+	r_write_be64 (rep + 5, written);
+	bool ret = r_socket_write (s, rep, sizeof (rep)) == sizeof (rep);
+	r_socket_flush (s);
+	return ret;
+}
+
+/* returns the number of bytes written by the PWRITE tagged with tag or -1 */
+R_API st64 r_socket_rap_pwrite_recv(RSocket *s, ut32 tag) {
+	r_return_val_if_fail (s, -1);
+	ut8 rep[RAP_PWRITE_REPLY_SIZE];
+	if (!r_socket_rap_read (s, rep, sizeof (rep))) {
+		return -1;
+	}
+	if (rep[0] != (RAP_RMT_PWRITE | RAP_RMT_REPLY) || r_read_be32 (rep + 1) != tag) {
+		eprintf ("rap: unexpected pwrite reply 0x%02x\n", rep[0]);
+		return -1;
+	}
+	return (st64)r_read_be64 (rep + 5);
+}
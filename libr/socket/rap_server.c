@@ -48,6 +48,40 @@ R_API RSocket* r_socket_server_accept (RSocketRapServer *s) {
 	return r_socket_accept (s->fd);
 }
 
+static bool rap_server_pread(RSocketRapServer *s, ut32 tag, ut64 off, ut64 len) {
+	if (len > RAP_WINDOW) {
+		len = RAP_WINDOW;
+	}
+	ut8 *buf = malloc (len + 1);
+	if (!buf) {
+		return false;
+	}
+	int n = 0;
+	if (s->seek (s->user, off, 0) != -1) {
+		n = s->read (s->user, buf, (int)len);
+	}
+	bool ret = r_socket_rap_pread_reply (s->fd, tag, buf, R_MAX (n, 0), s->caps);
+	free (buf);
+	return ret;
+}
+
+static bool rap_server_pwrite(RSocketRapServer *s, ut32 tag, ut64 off, ut64 len) {
+	if (len > RAP_WINDOW) {
+		r_socket_close (s->fd);
+		return false;
+	}
+	ut8 *buf = malloc (len + 1);
+	if (!buf) {
+		return false;
+	}
+	int n = 0;
+	if (r_socket_rap_read (s->fd, buf, len) && s->seek (s->user, off, 0) != -1) {
+		n = s->write (s->user, buf, (int)len);
+	}
+	free (buf);
+	return r_socket_rap_pwrite_reply (s->fd, tag, R_MAX (n, 0));
+}
+
 R_API bool r_socket_server_continue (RSocketRapServer *s) {
 	r_return_val_if_fail (s && s->fd, false);
 
@@ -57,18 +91,20 @@ R_API bool r_socket_server_continue (RSocketRapServer *s) {
 	if (!r_socket_is_connected (s->fd)) {
 		return false;
 	}
-	r_socket_read_block (s->fd, s->buf, 1);
+	if (!r_socket_rap_read (s->fd, s->buf, 1)) {
+		return false;
+	}
 	switch (s->buf[0]) {
 	case RAP_RMT_OPEN:
-		r_socket_read_block (s->fd, &s->buf[1], 2);
-		r_socket_read_block (s->fd, &s->buf[3], (int)s->buf[2]);
+		r_socket_rap_read (s->fd, &s->buf[1], 2);
+		r_socket_rap_read (s->fd, &s->buf[3], (int)s->buf[2]);
 		s->open (s->user, (const char *)&s->buf[3], (int)s->buf[1], 0);
 		s->buf[0] = RAP_RMT_OPEN | RAP_RMT_REPLY;
 		r_socket_write (s->fd, s->buf, 5);
 		r_socket_flush (s->fd);
 		break;
 	case RAP_RMT_READ:
-		r_socket_read_block (s->fd, &s->buf[1], 4);
+		r_socket_rap_read (s->fd, &s->buf[1], 4);
 		i = r_read_be32 (&s->buf[1]);
 		if (i > RAP_RMT_MAX || i < 0) {
 			i = RAP_RMT_MAX;
@@ -79,12 +115,12 @@ R_API bool r_socket_server_continue (RSocketRapServer *s) {
 		r_socket_flush (s->fd);
 		break;
 	case RAP_RMT_WRITE:
-		r_socket_read_block (s->fd, s->buf + 1, 4);
+		r_socket_rap_read (s->fd, s->buf + 1, 4);
 		i = r_read_be32 (s->buf + 1);
 		if (i > RAP_RMT_MAX || i < 0) {
 			i = RAP_RMT_MAX;
 		}
-		r_socket_read_block (s->fd, s->buf + 5, i);
+		r_socket_rap_read (s->fd, s->buf + 5, i);
 		r_write_be32 (s->buf + 1, s->write (s->user, s->buf + 5, i));
 		s->buf[0] = RAP_RMT_WRITE | RAP_RMT_REPLY;
 		r_socket_write (s->fd, s->buf, 5);
@@ -92,7 +128,7 @@ R_API bool r_socket_server_continue (RSocketRapServer *s) {
 		break;
 	case RAP_RMT_SEEK:
 		{
-		r_socket_read_block (s->fd, &s->buf[1], 9);
+		r_socket_rap_read (s->fd, &s->buf[1], 9);
 		int whence = s->buf[1];
 		ut64 offset = r_read_be64 (s->buf + 2);
 		offset = s->seek (s->user, offset, whence);
@@ -103,11 +139,27 @@ R_API bool r_socket_server_continue (RSocketRapServer *s) {
 		r_socket_flush (s->fd);
 		}
 		break;
+	case RAP_RMT_PREAD:
+		r_socket_rap_read (s->fd, &s->buf[1], RAP_PREAD_SIZE - 1);
+		return rap_server_pread (s, r_read_be32 (s->buf + 1),
+			r_read_be64 (s->buf + 5), r_read_be64 (s->buf + 13));
+	case RAP_RMT_PWRITE:
+		r_socket_rap_read (s->fd, &s->buf[1], RAP_PREAD_SIZE - 1);
+		return rap_server_pwrite (s, r_read_be32 (s->buf + 1),
+			r_read_be64 (s->buf + 5), r_read_be64 (s->buf + 13));
 	case RAP_RMT_CMD:
-		r_socket_read_block (s->fd, &s->buf[1], 4);
+		r_socket_rap_read (s->fd, &s->buf[1], 4);
 		i = r_read_be32 (&s->buf[1]);
-		r_socket_read_block (s->fd, &s->buf[5], i);
-		ptr = s->cmd (s->user, (const char *)&s->buf[5]);
+		if (i < 0 || i > RAP_RMT_MAX) {
+			i = RAP_RMT_MAX;
+		}
+		r_socket_rap_read (s->fd, &s->buf[5], i);
+		s->buf[5 + i] = 0;
+		ptr = r_socket_rap_hello ((const char *)&s->buf[5],
+			RAP_CAP_PREAD | RAP_CAP_LZ4, &s->caps);
+		if (!ptr) {
+			ptr = s->cmd (s->user, (const char *)&s->buf[5]);
+		}
 		i = (ptr)? strlen (ptr) + 1: 0;
 		r_write_be32 (&s->buf[1], i);
 		s->buf[0] = RAP_RMT_CMD | RAP_RMT_REPLY;
@@ -119,7 +171,7 @@ R_API bool r_socket_server_continue (RSocketRapServer *s) {
 		R_FREE (ptr);
 		break;
 	case RAP_RMT_CLOSE:
-		r_socket_read_block (s->fd, &s->buf[1], 4);
+		r_socket_rap_read (s->fd, &s->buf[1], 4);
 		i = r_read_be32 (&s->buf[1]);
 		s->close (s->user, i);
 		s->buf[0] = RAP_RMT_CLOSE | RAP_RMT_REPLY;
@@ -771,7 +771,7 @@ R_API int r_socket_write(RSocket *s, void *buf, int len) {
 			break;
 		}
 		if (ret == len) {
-			return len;
+			return delta + len;
 		}
 		delta += ret;
 		len -= ret;
@@ -2,6 +2,144 @@
 
 #include <r_util.h>
 
+/* Compiled type cache. It is attached to a types Sdb as a hook, so every
+ * edit of the types db drops it, and keeps what r_type queries would
+ * otherwise re-read and re-split from sdb strings on every call: the bit
+ * size of each type string, the member layout of each struct and the
+ * struct members found at each byte offset. */
+
+typedef struct {
+	char *name;
+	char *nested; // name of the embedded struct, if any
+	int boff; // bit offset of the member
+	int bend; // bit offset where the member ends
+} RTypeMember;
+
+typedef struct {
+	RTypeMember *members;
+	int count;
+	bool sorted; // member offsets never go backwards
+} RTypeLayout;
+
+typedef struct {
+	bool valid;
+	HtPP *sizes; // type -> bitsize
+	HtPP *layouts; // struct name -> RTypeLayout
+	HtUP *offsets; // byte offset -> RList of "struct.member"
+	RList *structs; // struct names sorted like the types db
+} RTypeCache;
+
+static void type_cache_hook(Sdb *s, void *user, const char *k, const char *v);
+
+static RTypeCache *type_cache_find(Sdb *TDB) {
+	SdbListIter *iter;
+	void *hook;
+	int i = 0;
+	ls_foreach (TDB->hooks, iter, hook) {
+		if (!(i % 2) && hook == (void *)type_cache_hook && iter->n) {
+			return iter->n->data;
+		}
+		i++;
+	}
+	return NULL;
+}
+
+static void layout_free(RTypeLayout *l) {
+	if (l) {
+		int i;
+		for (i = 0; i < l->count; i++) {
+			free (l->members[i].name);
+			free (l->members[i].nested);
+		}
+		free (l->members);
+		free (l);
+	}
+}
+
+static void layout_kv_free(HtPPKv *kv) {
+	free (kv->key);
+	layout_free (kv->value);
+}
+
+static void offsets_kv_free(HtUPKv *kv) {
+	r_list_free (kv->value);
+}
+
+static void type_cache_clear(RTypeCache *tc) {
+	ht_pp_free (tc->sizes);
+	ht_pp_free (tc->layouts);
+	ht_up_free (tc->offsets);
+	r_list_free (tc->structs);
+	tc->sizes = NULL;
+	tc->layouts = NULL;
+	tc->offsets = NULL;
+	tc->structs = NULL;
+	tc->valid = false;
+}
+
+static bool type_cache_setup(RTypeCache *tc) {
+	tc->sizes = ht_pp_new0 ();
+	tc->layouts = ht_pp_new (NULL, layout_kv_free, NULL);
+	tc->offsets = ht_up_new (NULL, offsets_kv_free, NULL);
+	tc->valid = tc->sizes && tc->layouts && tc->offsets;
+	if (!tc->valid) {
+		type_cache_clear (tc);
+	}
+	return tc->valid;
+}
+
+static void type_cache_hook(Sdb *s, void *user, const char *k, const char *v) {
+	RTypeCache *tc = user;
+	// links are set all the time while analyzing but never change a type
+	if (!strncmp (k, "link.", 5) || !strncmp (k, "offset.", 7)) {
+		return;
+	}
+	if (tc->valid) {
+		type_cache_clear (tc);
+	}
+}
+
+R_API bool r_type_cache_init(Sdb *TDB) {
+	r_return_val_if_fail (TDB, false);
+	if (type_cache_find (TDB)) {
+		return true;
+	}
+	RTypeCache *tc = R_NEW0 (RTypeCache);
+	if (!tc) {
+		return false;
+	}
+	if (!sdb_hook (TDB, type_cache_hook, tc)) {
+		free (tc);
+		return false;
+	}
+	return true;
+}
+
+R_API void r_type_cache_fini(Sdb *TDB) {
+	r_return_if_fail (TDB);
+	RTypeCache *tc = type_cache_find (TDB);
+	if (tc) {
+		sdb_unhook (TDB, type_cache_hook);
+		type_cache_clear (tc);
+		free (tc);
+	}
+}
+
+// needed after edits that do not go through sdb_set, like sdb_reset
+R_API void r_type_cache_invalidate(Sdb *TDB) {
+	r_return_if_fail (TDB);
+	RTypeCache *tc = type_cache_find (TDB);
+	if (tc && tc->valid) {
+		type_cache_clear (tc);
+	}
+}
+
+/* returns the attached cache, rebuilding its tables after an invalidation */
+static RTypeCache *type_cache_get(Sdb *TDB) {
+	RTypeCache *tc = type_cache_find (TDB);
+	return (tc && (tc->valid || type_cache_setup (tc)))? tc: NULL;
+}
+
 R_API int r_type_set(Sdb *TDB, ut64 at, const char *field, ut64 val) {
 	const char *kind;
 	char var[128];
@@ -118,7 +256,7 @@ R_API char *r_type_enum_getbitfield(Sdb *TDB, const char *name, ut64 val) {
 	return ret;
 }
 
-R_API int r_type_get_bitsize(Sdb *TDB, const char *type) {
+static int type_bitsize(Sdb *TDB, const char *type) {
 	char *query;
 	/* Filter out the structure keyword if type looks like "struct mystruc" */
 	const char *tmptype;
@@ -192,7 +330,125 @@ R_API int r_type_get_bitsize(Sdb *TDB, const char *type) {
 	return 0;
 }
 
-R_API char *r_type_get_struct_memb(Sdb *TDB, const char *type, int offset) {
+R_API int r_type_get_bitsize(Sdb *TDB, const char *type) {
+	RTypeCache *tc = type_cache_get (TDB);
+	if (!tc) {
+		return type_bitsize (TDB, type);
+	}
+	bool found = false;
+	int r = (int)(intptr_t)ht_pp_find (tc->sizes, type, &found);
+	if (found) {
+		return r;
+	}
+	// a struct embedding itself is 0 bits here instead of a stack overflow
+	ht_pp_insert (tc->sizes, type, (void *)(intptr_t)0);
+	r = type_bitsize (TDB, type);
+	ht_pp_update (tc->sizes, type, (void *)(intptr_t)r);
+	return r;
+}
+
+/* member offsets are summed like struct_memb() does, the offset stored
+ * in each member entry is not trusted either */
+static RTypeLayout *type_layout(RTypeCache *tc, Sdb *TDB, const char *type) {
+	bool found = false;
+	RTypeLayout *l = ht_pp_find (tc->layouts, type, &found);
+	if (found) {
+		return l;
+	}
+	l = R_NEW0 (RTypeLayout);
+	if (!l) {
+		return NULL;
+	}
+	l->sorted = true;
+	// no sdb_fmt here, type itself may live in one of its buffers
+	char *query = r_str_newf ("struct.%s", type);
+	char *members = query? sdb_get (TDB, query, 0): NULL;
+	free (query);
+	if (members) {
+		int i, typesize = 0;
+		int nargs = r_str_split (members, ',');
+		l->members = R_NEWS0 (RTypeMember, nargs);
+		for (i = 0; l->members && i < nargs; i++) {
+			const char *name = r_str_word_get0 (members, i);
+			if (!name) {
+				break;
+			}
+			query = r_str_newf ("struct.%s.%s", type, name);
+			char *subtype = query? sdb_get (TDB, query, 0): NULL;
+			free (query);
+			if (!subtype) {
+				break;
+			}
+			int len = r_str_split (subtype, ',');
+			if (len < 3) {
+				free (subtype);
+				break;
+			}
+			int val = r_num_math (NULL, r_str_word_get0 (subtype, len - 1));
+			int arrsz = val ? val : 1;
+			RTypeMember *m = &l->members[l->count++];
+			m->name = strdup (name);
+			m->boff = typesize;
+			typesize += r_type_get_bitsize (TDB, subtype) * arrsz;
+			m->bend = typesize;
+			if (m->bend < m->boff) {
+				l->sorted = false;
+			}
+			const char *nested_type = r_str_word_get0 (subtype, 0);
+			if (r_str_startswith (nested_type, "struct ") && !r_str_endswith (nested_type, " *")) {
+				const char *n = nested_type + 7;
+				const char *sp = strchr (n, ' ');
+				m->nested = sp? r_str_ndup (n, sp - n): strdup (n);
+			}
+			free (subtype);
+		}
+		free (members);
+	}
+	ht_pp_insert (tc->layouts, type, l);
+	return l;
+}
+
+static char *type_layout_memb(RTypeCache *tc, Sdb *TDB, const char *type, int offset) {
+	RTypeLayout *l = type_layout (tc, TDB, type);
+	if (!l) {
+		return NULL;
+	}
+	int i = 0;
+	if (l->sorted) {
+		// first member that does not end before offset
+		int hi = l->count;
+		while (i < hi) {
+			int mid = i + (hi - i) / 2;
+			if (l->members[mid].bend / 8 < offset) {
+				i = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+	}
+	for (; i < l->count; i++) {
+		RTypeMember *m = &l->members[i];
+		if (m->boff / 8 == offset) {
+			return r_str_newf ("%s.%s", type, m->name);
+		}
+		if (l->sorted && m->boff / 8 > offset) {
+			break;
+		}
+		// Handle nested structs
+		if (m->nested && offset < m->bend / 8) {
+			char *nested_res = r_type_get_struct_memb (TDB, m->nested, offset - (m->boff / 8));
+			if (nested_res) {
+				const char *last = r_str_lchr (nested_res, '.');
+				char *res = r_str_newf ("%s.%s.%s", type, m->name, last? last + 1: nested_res);
+				free (nested_res);
+				return res;
+			}
+		}
+	}
+	return NULL;
+}
+
+static char *struct_memb(Sdb *TDB, const char *type, int offset) {
 	int i, prev_typesize, typesize = 0;
 	char *res = NULL;
 
@@ -256,8 +512,69 @@ R_API char *r_type_get_struct_memb(Sdb *TDB, const char *type, int offset) {
 	return res;
 }
 
+R_API char *r_type_get_struct_memb(Sdb *TDB, const char *type, int offset) {
+	if (offset < 0) {
+		return NULL;
+	}
+	RTypeCache *tc = type_cache_get (TDB);
+	return tc? type_layout_memb (tc, TDB, type, offset): struct_memb (TDB, type, offset);
+}
+
+static RList *type_cache_by_offset(RTypeCache *tc, Sdb *TDB, ut64 offset) {
+	bool found = false;
+	RList *hits = ht_up_find (tc->offsets, offset, &found);
+	if (!found) {
+		if (!tc->structs) {
+			tc->structs = r_list_newf (free);
+			if (!tc->structs) {
+				return NULL;
+			}
+			SdbList *ls = sdb_foreach_list (TDB, true);
+			SdbListIter *lsi;
+			SdbKv *kv;
+			ls_foreach (ls, lsi, kv) {
+				// TODO: Add unions support
+				if (!strncmp (sdbkv_value (kv), "struct", 6) && strncmp (sdbkv_key (kv), "struct.", 7)) {
+					r_list_append (tc->structs, strdup (sdbkv_key (kv)));
+				}
+			}
+			ls_free (ls);
+		}
+		hits = r_list_newf (free);
+		if (!hits) {
+			return NULL;
+		}
+		RListIter *iter;
+		const char *name;
+		r_list_foreach (tc->structs, iter, name) {
+			char *res = r_type_get_struct_memb (TDB, name, offset);
+			if (res) {
+				r_list_append (hits, res);
+			}
+		}
+		ht_up_insert (tc->offsets, offset, hits);
+	}
+	// the cache can be dropped by the next type edit, hand out a copy
+	RList *res = r_list_newf (free);
+	if (res) {
+		RListIter *iter;
+		const char *name;
+		r_list_foreach (hits, iter, name) {
+			r_list_append (res, strdup (name));
+		}
+	}
+	return res;
+}
+
 R_API RList* r_type_get_by_offset(Sdb *TDB, ut64 offset) {
-	RList *offtypes = r_list_new ();
+	RTypeCache *tc = type_cache_get (TDB);
+	if (tc) {
+		RList *hits = type_cache_by_offset (tc, TDB, offset);
+		if (hits) {
+			return hits;
+		}
+	}
+	RList *offtypes = r_list_newf (free);
 	SdbList *ls = sdb_foreach_list (TDB, true);
 	SdbListIter *lsi;
 	SdbKv *kv;
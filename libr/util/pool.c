@@ -0,0 +1,146 @@
+/* radare - LGPL - Copyright 2019 - pancake */
+
+#include <r_util.h>
+
+/* fixed size node allocator: nodes are carved from slabs of poolsize
+ * nodes and released ones are kept in a freelist for the next alloc */
+
+#define POOL_ALIGN (sizeof (void *) * 2)
+
+R_API RMemoryPool *r_mem_pool_deinit(RMemoryPool *pool) {
+	int i;
+	if (!pool) {
+		return NULL;
+	}
+	if (pool->nodes) {
+		for (i = 0; i <= pool->npool && i < pool->poolcount; i++) {
+			R_FREE (pool->nodes[i]);
+		}
+		R_FREE (pool->nodes);
+	}
+	pool->npool = -1;
+	pool->ncount = pool->poolsize; // force a new slab on next alloc
+	pool->freelist = NULL;
+	pool->live = 0;
+	return pool;
+}
+
+R_API RMemoryPool *r_mem_pool_new(int nodesize, int poolsize, int poolcount) {
+	r_return_val_if_fail (nodesize > 0, NULL);
+	RMemoryPool *pool = R_NEW0 (RMemoryPool);
+	if (!pool) {
+		return NULL;
+	}
+	if (nodesize < sizeof (void *)) {
+		nodesize = sizeof (void *);
+	}
+	pool->nodesize = R_ROUND (nodesize, POOL_ALIGN);
+	pool->poolsize = (poolsize > 0)? poolsize: 1024;
+	pool->poolcount = (poolcount > 0)? poolcount: 8;
+	pool->npool = -1;
+	pool->ncount = pool->poolsize;
+	char *e = r_sys_getenv ("R2_NOPOOL");
+	pool->nopool = e && *e && *e != '0';
+	free (e);
+	pool->lock = r_th_lock_new (false);
+	if (!pool->lock) {
+		free (pool);
+		return NULL;
+	}
+	return pool;
+}
+
+R_API RMemoryPool *r_mem_pool_free(RMemoryPool *pool) {
+	if (pool) {
+		r_th_lock_free (pool->lock);
+		free (r_mem_pool_deinit (pool));
+	}
+	return NULL;
+}
+
+static bool pool_grow(RMemoryPool *pool) {
+	int n = pool->npool + 1;
+	if (!pool->nodes || n >= pool->poolcount) {
+		int count = pool->nodes? pool->poolcount * 2: pool->poolcount;
+		ut8 **nodes = realloc (pool->nodes, count * sizeof (ut8 *));
+		if (!nodes) {
+			return false;
+		}
+		pool->nodes = nodes;
+		pool->poolcount = count;
+	}
+	pool->nodes[n] = malloc ((size_t)pool->nodesize * pool->poolsize);
+	if (!pool->nodes[n]) {
+		return false;
+	}
+	pool->npool = n;
+	pool->ncount = 0;
+	return true;
+}
+
+// returns a zeroed node
+R_API void *r_mem_pool_alloc(RMemoryPool *pool) {
+	r_return_val_if_fail (pool, NULL);
+	void *p;
+	r_th_lock_enter (pool->lock);
+	if (pool->nopool) {
+		p = calloc (1, pool->nodesize);
+	} else if (pool->freelist) {
+		p = pool->freelist;
+		pool->freelist = *(void **)p;
+		memset (p, 0, pool->nodesize);
+	} else {
+		if (pool->ncount >= pool->poolsize && !pool_grow (pool)) {
+			r_th_lock_leave (pool->lock);
+			return NULL;
+		}
+		p = pool->nodes[pool->npool] + (size_t)pool->ncount * pool->nodesize;
+		pool->ncount++;
+		memset (p, 0, pool->nodesize);
+	}
+	if (p) {
+		pool->nalloc++;
+		if (++pool->live > pool->peak) {
+			pool->peak = pool->live;
+		}
+	}
+	r_th_lock_leave (pool->lock);
+	return p;
+}
+
+// p must come from r_mem_pool_alloc on the same pool
+R_API void r_mem_pool_release(RMemoryPool *pool, void *p) {
+	r_return_if_fail (pool);
+	if (!p) {
+		return;
+	}
+	r_th_lock_enter (pool->lock);
+	if (pool->nopool) {
+		free (p);
+	} else {
+		*(void **)p = pool->freelist;
+		pool->freelist = p;
+	}
+	pool->nrelease++;
+	pool->live--;
+	bool gone = pool->dropped && !pool->live;
+	r_th_lock_leave (pool->lock);
+	if (gone) {
+		r_mem_pool_free (pool);
+	}
+}
+
+/* frees the pool now, or when its last node is released if some are still
+ * in use, for owners whose nodes may outlive them */
+R_API void r_mem_pool_drop(RMemoryPool *pool) {
+	if (!pool) {
+		return;
+	}
+	r_th_lock_enter (pool->lock);
+	bool gone = !pool->live;
+	pool->dropped = true;
+	r_th_lock_leave (pool->lock);
+	if (gone) {
+		r_mem_pool_free (pool);
+	}
+}
@@ -1507,6 +1507,13 @@ R_API void r_print_rangebar(RPrint *p, ut64 startA, ut64 endA, ut64 min, ut64 ma
 }
 
 R_API void r_print_zoom(RPrint *p, void *user, RPrintZoomCallback cb, ut64 from, ut64 to, int len, int maxlen) {
+	r_print_zoom_ex (p, user, cb, NULL, from, to, len, maxlen);
+}
+
+/* statcb is optional: it is called with bufz == NULL and may return the
+ * value for a block without reading it, or -1 to have cb called on the
+ * block bytes as r_print_zoom does */
+R_API void r_print_zoom_ex(RPrint *p, void *user, RPrintZoomCallback cb, RPrintZoomCallback statcb, ut64 from, ut64 to, int len, int maxlen) {
 	static int mode = -1;
 	ut8 *bufz = NULL, *bufz2 = NULL;
 	int i, j = 0;
@@ -1542,10 +1549,13 @@ R_API void r_print_zoom(RPrint *p, void *user, RPrintZoomCallback cb, ut64 from,
 			return;
 		}
 
-		// TODO: memoize blocks or gtfo
 		for (i = 0; i < len; i++) {
-			p->iob.read_at (p->iob.io, from + j, bufz2, size);
-			bufz[i] = cb (user, p->zoom->mode, from + j, bufz2, size);
+			int v = statcb? statcb (user, p->zoom->mode, from + j, NULL, size): -1;
+			if (v < 0) {
+				p->iob.read_at (p->iob.io, from + j, bufz2, size);
+				v = cb (user, p->zoom->mode, from + j, bufz2, size);
+			}
+			bufz[i] = v;
 			j += size;
 		}
 		free (bufz2);
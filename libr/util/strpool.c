@@ -34,16 +34,13 @@ R_API char *r_strpool_alloc (RStrpool *p, int l) {
 	char *ret = p->str + p->len;
 	if ((p->len + l) >= p->size) {
 		ut64 osize = p->size;
-		if (l >= R_STRPOOL_INC) {
-			p->size += l + R_STRPOOL_INC;
-		} else {
-			p->size += R_STRPOOL_INC;
-		}
-		if (p->size < osize) {
+		// grow geometrically, appending many strings must not be quadratic
+		ut64 nsize = R_MAX (osize * 2, (ut64)p->len + l + R_STRPOOL_INC);
+		if (nsize > ST32_MAX) {
 			eprintf ("Underflow!\n");
-			p->size = osize;
 			return NULL;
 		}
+		p->size = nsize;
 		ret = realloc (p->str, p->size);
 		if (!ret) {
 			eprintf ("Realloc failed!\n");
@@ -1,7 +1,12 @@
-/* radare - LGPL - Copyright 2014-2015 - pancake */
+/* radare - LGPL - Copyright 2014-2019 - pancake */
 
 #include <r_util.h>
 #include <zlib.h>
+#ifdef R_MESON_VERSION
+#include <lz4.h>
+#else
+#include "../../shlr/lz4/lz4.c"
+#endif
 
 
 // set a maximum output buffer of 50MB
@@ -84,3 +89,24 @@ R_API ut8 *r_inflate(const ut8 *src, int srcLen, int *srcConsumed, int *dstLen)
 	free (dst);
 	return NULL;
 }
+
+/* raw lz4 blocks, both return the number of bytes written to dst or -1 */
+R_API int r_lz4_bound(int len) {
+	return LZ4_compressBound (len);
+}
+
+R_API int r_lz4_compress(const ut8 *src, int len, ut8 *dst, int dst_len) {
+	if (!src || !dst || len < 0 || dst_len < 0) {
+		return -1;
+	}
+	int ret = LZ4_compress_default ((const char *)src, (char *)dst, len, dst_len);
+	return ret > 0? ret: -1;
+}
+
+R_API int r_lz4_decompress(const ut8 *src, int len, ut8 *dst, int dst_len) {
+	if (!src || !dst || len < 0 || dst_len < 0) {
+		return -1;
+	}
+	int ret = LZ4_decompress_safe ((const char *)src, (char *)dst, len, dst_len);
+	return ret >= 0? ret: -1;
+}
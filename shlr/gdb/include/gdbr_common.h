@@ -13,6 +13,15 @@ int handle_qSupported(libgdbr_t *g);
  */
 int send_msg(libgdbr_t* g, const char* msg);
 
+/*!
+ * \brief Function sends a binary message, escaping whatever needs it
+ * \param g the "instance" of the current libgdbr session
+ * \param data the bytes that will be sent
+ * \param len the number of bytes in data
+ * \returns a failure code (currently -1) or 0 if call successfully
+ */
+int send_msg_bin(libgdbr_t* g, const ut8* data, int len);
+
 /*!
  * \brief Functions sends a single ack ('+')
  * \param g the "instance" of the current libgdbr session
@@ -85,9 +85,11 @@ typedef struct libgdbr_stub_features_t {
 	bool EnableDisableTracepoints;
 	bool tracenz;
 	bool BreakpointCommands;
+	bool binary_upload; // 'x' packets, replies prefixed with 'b'
 	// lldb-specific features
 	struct {
 		bool g;
+		bool x; // 'x' packets with raw replies
 		bool QThreadSuffixSupported;
 		bool QListThreadsInStopReply;
 		bool qEcho;
@@ -186,6 +188,14 @@ typedef struct libgdbr_t {
 	bool get_baddr;
 	libgdbr_stop_reason_t stop_reason;
 
+	// target memory read since the last stop, dropped whenever it can change
+	struct {
+		ut8 *buf;
+		ut64 *addr; // page held by each slot, UT64_MAX if none
+		int page_size;
+		bool disabled;
+	} mem_cache;
+
 	// parsed from target
 	struct {
 		char *regprofile;
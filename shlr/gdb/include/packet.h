@@ -29,5 +29,6 @@ int send_packet(libgdbr_t *g);
 int read_packet(libgdbr_t *g, bool vcont);
 
 int pack(libgdbr_t *g, const char *msg);
+int pack_bin(libgdbr_t *g, const ut8 *data, int len);
 
 #endif
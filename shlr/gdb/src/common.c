@@ -106,6 +106,8 @@ int handle_qSupported(libgdbr_t *g) {
 			}
 		} else if (r_str_startswith (tok, "multiprocess")) {
 			g->stub_features.multiprocess = (tok[strlen ("multiprocess")] == '+');
+		} else if (r_str_startswith (tok, "binary-upload")) {
+			g->stub_features.binary_upload = (tok[strlen ("binary-upload")] == '+');
 		} else if (r_str_startswith (tok, "qEcho")) {
 			g->remote_type = GDB_REMOTE_TYPE_LLDB;
 			g->stub_features.lldb.qEcho = (tok[strlen ("qEcho")] == '+');
@@ -148,3 +150,16 @@ int send_msg(libgdbr_t *g, const char *msg) {
 	g->send_len = ret;
 	return ret;
 }
+
+int send_msg_bin(libgdbr_t *g, const ut8 *data, int len) {
+	int ret;
+	if (!g || !data) {
+		return -1;
+	}
+	if (pack_bin (g, data, len) < 0) {
+		return -1;
+	}
+	ret = send_packet (g);
+	g->send_len = ret;
+	return ret;
+}
@@ -85,6 +85,11 @@ static int gdbr_connect_lldb(libgdbr_t *g) {
 	if (g->stub_features.qXfer_features_read) {
 		gdbr_read_target_xml (g);
 	}
+	// debugserver answers an empty 'x' read with OK when it supports them
+	if (send_msg (g, "x0,0") < 0 || read_packet (g, false) < 0 || send_ack (g) < 0) {
+		return -1;
+	}
+	g->stub_features.lldb.x = g->data_len == 2 && !strncmp (g->data, "OK", 2);
 	// Check if 'g' packet is supported
 	if (send_msg (g, "g") < 0 || read_packet (g, false) < 0 || send_ack (g) < 0) {
 		return -1;
@@ -203,6 +208,7 @@ int gdbr_disconnect(libgdbr_t *g) {
 		return -1;
 	}
 	reg_cache.valid = false;
+	gdbr_invalidate_mem_cache (g);
 	g->stop_reason.is_valid = false;
 	free (reg_cache.buf);
 	if (g->target.valid) {
@@ -216,6 +222,7 @@ int gdbr_disconnect(libgdbr_t *g) {
 int gdbr_select(libgdbr_t *g, int pid, int tid) {
 	char cmd[64] = { 0 };
 	reg_cache.valid = false;
+	gdbr_invalidate_mem_cache (g);
 	g->pid = pid;
 	g->tid = tid;
 	strcpy (cmd, "Hg");
@@ -287,6 +294,7 @@ int gdbr_check_extended_mode(libgdbr_t *g) {
 	int ret;
 	g->stop_reason.is_valid = false;
 	reg_cache.valid = false;
+	gdbr_invalidate_mem_cache (g);
 	// Activate extended mode if possible.
 	ret = send_msg (g, "!");
 	if (ret < 0) {
@@ -318,6 +326,7 @@ int gdbr_attach(libgdbr_t *g, int pid) {
 	}
 	g->stop_reason.is_valid = false;
 	reg_cache.valid = false;
+	gdbr_invalidate_mem_cache (g);
 
 	if (g->stub_features.extended_mode == -1) {
 		gdbr_check_extended_mode (g);
@@ -359,6 +368,7 @@ int gdbr_detach(libgdbr_t *g) {
 		return -1;
 	}
 	reg_cache.valid = false;
+	gdbr_invalidate_mem_cache (g);
 	g->stop_reason.is_valid = false;
 	ret = send_msg (g, "D");
 	if (ret < 0) {
@@ -377,6 +387,7 @@ int gdbr_detach_pid(libgdbr_t *g, int pid) {
 		return -1;
 	}
 	reg_cache.valid = false;
+	gdbr_invalidate_mem_cache (g);
 	g->stop_reason.is_valid = false;
 
 	buffer_size = strlen (CMD_DETACH_MP) + (sizeof (pid) * 2) + 1;
@@ -413,6 +424,7 @@ bool gdbr_kill(libgdbr_t *g) {
 		return false;
 	}
 	reg_cache.valid = false;
+	gdbr_invalidate_mem_cache (g);
 	g->stop_reason.is_valid = false;
 
 	if (g->stub_features.multiprocess) {
@@ -438,6 +450,7 @@ bool gdbr_kill_pid(libgdbr_t *g, int pid) {
 		return false;
 	}
 	reg_cache.valid = false;
+	gdbr_invalidate_mem_cache (g);
 	g->stop_reason.is_valid = false;
 
 	buffer_size = strlen (CMD_KILL_MP) + (sizeof (pid) * 2) + 1;
@@ -514,9 +527,35 @@ int gdbr_read_registers(libgdbr_t *g) {
 	return 0;
 }
 
+// pages kept between stops and largest read served through them
+#define MEM_CACHE_SLOTS 64
+#define MEM_CACHE_MAX_PAGES 16
+
+void gdbr_invalidate_mem_cache(libgdbr_t *g) {
+	if (g && g->mem_cache.addr) {
+		memset (g->mem_cache.addr, 0xff, MEM_CACHE_SLOTS * sizeof (ut64));
+	}
+}
+
+/* reads up to len bytes with a single packet, stubs may send less */
+static int read_memory_packet(libgdbr_t *g, ut64 address, ut8 *buf, int len) {
+	char command[64];
+	bool bin = g->stub_features.binary_upload || g->stub_features.lldb.x;
+	snprintf (command, sizeof (command), "%s%"PFMT64x",%x",
+		bin? CMD_READMEM_BIN: CMD_READMEM, address, len);
+	if (send_msg (g, command) < 0 || read_packet (g, false) < 0) {
+		return -1;
+	}
+	if ((bin? handle_x (g): handle_m (g)) < 0) {
+		return -1;
+	}
+	int n = R_MIN (g->data_len, len);
+	memcpy (buf, g->data, n);
+	return n;
+}
+
+/* reads len bytes using as few packets as the stub allows */
 static int gdbr_read_memory_page(libgdbr_t *g, ut64 address, ut8 *buf, int len) {
-	char command[128] = {0};
-	int last, ret_len, pkt;
 	if (!g) {
 		return -1;
 	}
@@ -524,65 +563,27 @@ static int gdbr_read_memory_page(libgdbr_t *g, ut64 address, ut8 *buf, int len)
 		return len;
 	}
 	g->stub_features.pkt_sz = R_MAX (g->stub_features.pkt_sz, GDB_MAX_PKTSZ);
-	int data_sz = g->stub_features.pkt_sz / 2;
-	int num_pkts = len / data_sz;
-	last = len % data_sz;
-	ret_len = 0;
-	for (pkt = 0; pkt < num_pkts; pkt++) {
-		if (snprintf (command, sizeof (command) - 1,
-			      "%s%"PFMT64x ",%"PFMT64x, CMD_READMEM,
-			      (ut64)address + (pkt * data_sz),
-			      (ut64)data_sz) < 0) {
-			return -1;
+	// hex replies take two chars per byte, binary ones leave room for
+	// the 'b' prefix and the framing
+	int data_sz = (g->stub_features.binary_upload || g->stub_features.lldb.x)
+		? R_MAX ((int)g->stub_features.pkt_sz - 8, 1)
+		: g->stub_features.pkt_sz / 2;
+	int ret_len = 0;
+	while (ret_len < len) {
+		int n = read_memory_packet (g, address + ret_len, buf + ret_len,
+			R_MIN (data_sz, len - ret_len));
+		if (n < 0) {
+			return ret_len? ret_len: -1;
 		}
-		if (send_msg (g, command) < 0) {
-			return -1;
-		}
-		if (read_packet (g, false) < 0) {
-			return -1;
-		}
-		if (handle_m (g) < 0) {
-			return -1;
-		}
-		int delta = (pkt * data_sz);
-
-		if (delta > len) {
-			eprintf ("oops\n");
+		if (!n) {
 			break;
 		}
-		int left = R_MIN (g->data_len, len - delta);
-		if (left > 0) {
-			memcpy (buf + delta, g->data, left);
-			ret_len += g->data_len;
-		}
-        }
-	if (last) {
-		if (snprintf (command, sizeof (command) - 1,
-			      "%s%016"PFMT64x ",%"PFMT64x, CMD_READMEM,
-			      (ut64)(address + (num_pkts * data_sz)),
-			      (ut64)last) < 0) {
-			return -1;
-		}
-		if (send_msg (g, command) < 0) {
-			return -1;
-		}
-		if (read_packet (g, false) < 0) {
-			return -1;
-		}
-		if (handle_m (g) < 0) {
-			return -1;
-		}
-		int delta = num_pkts * data_sz;
-		int left = R_MIN (g->data_len, len - delta);
-		if (left > 0) {
-			memcpy (buf + delta, g->data, left);
-			ret_len += g->data_len;
-		}
+		ret_len += n;
 	}
 	return ret_len;
 }
 
-int gdbr_read_memory(libgdbr_t *g, ut64 address, ut8 *buf, int len) {
+static int gdbr_read_memory_direct(libgdbr_t *g, ut64 address, ut8 *buf, int len) {
 	int ret_len, ret, tmp;
 	int page_size = g->page_size;
 	ret_len = 0;
@@ -618,6 +619,89 @@ int gdbr_read_memory(libgdbr_t *g, ut64 address, ut8 *buf, int len) {
 	return ret_len + ret;
 }
 
+static bool mem_cache_init(libgdbr_t *g) {
+	int page_size = g->page_size;
+	if (g->mem_cache.buf && g->mem_cache.page_size == page_size) {
+		return true;
+	}
+	free (g->mem_cache.buf);
+	g->mem_cache.buf = malloc ((size_t)MEM_CACHE_SLOTS * page_size);
+	if (!g->mem_cache.addr) {
+		g->mem_cache.addr = malloc (MEM_CACHE_SLOTS * sizeof (ut64));
+	}
+	if (!g->mem_cache.buf || !g->mem_cache.addr) {
+		R_FREE (g->mem_cache.buf);
+		return false;
+	}
+	g->mem_cache.page_size = page_size;
+	gdbr_invalidate_mem_cache (g);
+	return true;
+}
+
+static ut8 *mem_cache_page(libgdbr_t *g, ut64 page) {
+	int slot = (page / g->mem_cache.page_size) % MEM_CACHE_SLOTS;
+	if (g->mem_cache.addr[slot] != page) {
+		return NULL;
+	}
+	return g->mem_cache.buf + (size_t)slot * g->mem_cache.page_size;
+}
+
+/* fetches n whole pages with maximal packets, false unless all arrived */
+static bool mem_cache_fill(libgdbr_t *g, ut64 page, int n) {
+	int i, page_size = g->mem_cache.page_size;
+	ut8 *tmp = malloc ((size_t)n * page_size);
+	if (!tmp) {
+		return false;
+	}
+	if (gdbr_read_memory_page (g, page, tmp, n * page_size) != n * page_size) {
+		free (tmp);
+		return false;
+	}
+	for (i = 0; i < n; i++, page += page_size) {
+		int slot = (page / page_size) % MEM_CACHE_SLOTS;
+		memcpy (g->mem_cache.buf + (size_t)slot * page_size, tmp + (size_t)i * page_size, page_size);
+		g->mem_cache.addr[slot] = page;
+	}
+	free (tmp);
+	return true;
+}
+
+/* Reads go through a cache of whole pages that lives until the target
+ * runs or its memory is written. Missing pages are fetched in runs so
+ * adjacent reads share packets, anything that can not be fully read
+ * (unmapped pages, big reads, odd page sizes) takes the direct path. */
+int gdbr_read_memory(libgdbr_t *g, ut64 address, ut8 *buf, int len) {
+	int page_size = g->page_size;
+	if (len < 1 || g->mem_cache.disabled || page_size < 1 || (page_size & (page_size - 1))
+			|| len > MEM_CACHE_MAX_PAGES * page_size || address > UT64_MAX - len
+			|| !mem_cache_init (g)) {
+		return gdbr_read_memory_direct (g, address, buf, len);
+	}
+	ut64 first = address & ~(ut64)(page_size - 1);
+	ut64 last = (address + len - 1) & ~(ut64)(page_size - 1);
+	int i, n = (int)((last - first) / page_size) + 1, run = -1;
+	for (i = 0; i <= n; i++) {
+		bool miss = i < n && !mem_cache_page (g, first + (ut64)i * page_size);
+		if (miss && run < 0) {
+			run = i;
+		} else if (!miss && run >= 0) {
+			if (!mem_cache_fill (g, first + (ut64)run * page_size, i - run)) {
+				return gdbr_read_memory_direct (g, address, buf, len);
+			}
+			run = -1;
+		}
+	}
+	int done = 0;
+	for (i = 0; i < n; i++) {
+		ut64 page = first + (ut64)i * page_size;
+		int delta = (int)(R_MAX (address, page) - page);
+		int chunk = R_MIN (page_size - delta, len - done);
+		memcpy (buf + done, mem_cache_page (g, page) + delta, chunk);
+		done += chunk;
+	}
+	return done;
+}
+
 int gdbr_write_memory(libgdbr_t *g, ut64 address, const uint8_t *data, ut64 len) {
 	int ret = 0;
 	int command_len, pkt, max_cmd_len = 64;
@@ -626,6 +710,7 @@ int gdbr_write_memory(libgdbr_t *g, ut64 address, const uint8_t *data, ut64 len)
 	if (!g || !data) {
 		return -1;
 	}
+	gdbr_invalidate_mem_cache (g);
 	g->stub_features.pkt_sz = R_MAX (g->stub_features.pkt_sz, GDB_MAX_PKTSZ);
 	data_sz = g->stub_features.pkt_sz / 2;
 	if (data_sz < 1) {
@@ -951,6 +1036,7 @@ int send_vcont(libgdbr_t *g, const char *command, const char *thread_id) {
 		return ret;
 	}
 	reg_cache.valid = false;
+	gdbr_invalidate_mem_cache (g);
 	g->stop_reason.is_valid = false;
 	ret = send_msg (g, tmp);
 	if (ret < 0) {
@@ -1205,6 +1291,7 @@ int gdbr_send_qRcmd(libgdbr_t *g, const char *cmd, PrintfCallback cb_printf) {
 	strcpy (buf, "qRcmd,");
 	g->stop_reason.is_valid = false;
 	reg_cache.valid = false;
+	gdbr_invalidate_mem_cache (g);
 	pack_hex (cmd, strlen (cmd), buf + 6);
 	if (send_msg (g, buf) < 0) {
 		free (buf);
@@ -45,6 +45,24 @@ int handle_m(libgdbr_t *g) {
 	return send_ack (g);
 }
 
+/* binary memory read reply, read_packet already undid the escaping */
+int handle_x(libgdbr_t *g) {
+	if (g->stub_features.binary_upload) {
+		// gdb style replies are 'b' followed by the data or an error
+		if (g->data_len < 1 || g->data[0] != 'b') {
+			send_ack (g);
+			return -1;
+		}
+		memmove (g->data, g->data + 1, --g->data_len);
+	} else if (g->data_len == 3 && g->data[0] == 'E'
+			&& isxdigit ((ut8)g->data[1]) && isxdigit ((ut8)g->data[2])) {
+		// lldb sends raw bytes, an error looks like a 3 byte read
+		send_ack (g);
+		return -1;
+	}
+	return send_ack (g);
+}
+
 int handle_qStatus(libgdbr_t *g) {
 	if (!g || !g->data || !*g->data) {
 		return -1;
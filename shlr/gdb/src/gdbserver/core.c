@@ -17,7 +17,7 @@ static int _server_handle_qSupported(libgdbr_t *g) {
 	if (!(buf = malloc (128))) {
 		return -1;
 	}
-	snprintf (buf, 127, "PacketSize=%x;QStartNoAckMode+;qXfer:exec-file:read+",
+	snprintf (buf, 127, "PacketSize=%x;QStartNoAckMode+;qXfer:exec-file:read+;binary-upload+",
 		  (ut32) (g->read_max - 1));
 	if ((ret = handle_qSupported (g)) < 0) {
 		free (buf);
@@ -413,6 +413,39 @@ static int _server_handle_m(libgdbr_t *g, gdbr_server_cmd_cb cmd_cb, void *core_
 	return send_msg (g, g->data);
 }
 
+// Binary memory read, the callback still sees an 'm' command
+static int _server_handle_x(libgdbr_t *g, gdbr_server_cmd_cb cmd_cb, void *core_ptr) {
+	ut64 addr;
+	ut32 len;
+	int length;
+	char cmd[64];
+	ut8 *buf;
+	if (send_ack (g) < 0) {
+		return -1;
+	}
+	g->data[g->data_len] = 0;
+	if (sscanf (g->data, "x%"PFMT64x",%x", &addr, &len) != 2) {
+		return send_msg (g, "E01");
+	}
+	if (!len) {
+		return send_msg (g, "OK");
+	}
+	// replies may not be longer than the advertised packet size
+	len = R_MIN (len, g->read_max - 2);
+	snprintf (cmd, sizeof (cmd), "m%"PFMT64x",%x", addr, len);
+	if (!(buf = malloc (len + 1))) {
+		return send_msg (g, "E01");
+	}
+	if ((length = cmd_cb (g, core_ptr, cmd, (char *)buf + 1, len)) < 0 || length > len) {
+		free (buf);
+		return send_msg (g, "E01");
+	}
+	buf[0] = 'b';
+	int ret = send_msg_bin (g, buf, length + 1);
+	free (buf);
+	return ret;
+}
+
 // Read register number
 static int _server_handle_p(libgdbr_t *g, gdbr_server_cmd_cb cmd_cb, void *core_ptr) {
 	char message[128] = { 0 }, cmd[128] = { 0 };
@@ -617,6 +650,12 @@ int gdbr_server_serve(libgdbr_t *g, gdbr_server_cmd_cb cmd_cb, void *core_ptr) {
 			}
 			continue;
 		}
+		if (r_str_startswith (g->data, "x")) {
+			if ((ret = _server_handle_x (g, cmd_cb, core_ptr)) < 0) {
+				return ret;
+			}
+			continue;
+		}
 		if (r_str_startswith (g->data, "M")) {
 			if ((ret = _server_handle_M (g, cmd_cb, core_ptr)) < 0) {
 				return ret;
@@ -89,5 +89,7 @@ int gdbr_cleanup(libgdbr_t *g) {
 	g->send_len = 0;
 	R_FREE (g->send_buff);
 	R_FREE (g->read_buff);
+	R_FREE (g->mem_cache.buf);
+	R_FREE (g->mem_cache.addr);
 	return 0;
 }
@@ -263,3 +263,37 @@ int pack(libgdbr_t *g, const char *msg) {
 	g->send_len += 3;
 	return g->send_len;
 }
+
+/* like pack for binary payloads such as 'x' replies: no run length
+ * encoding, NUL bytes are data and '*' has to be escaped as well */
+int pack_bin(libgdbr_t *g, const ut8 *data, int len) {
+	int i;
+	ut8 sum = 0;
+	if (!g || !data || len < 0) {
+		return -1;
+	}
+	if (g->send_max < 2 * (ssize_t)len + 5) {
+		char *buf = realloc (g->send_buff, 2 * len + 5);
+		if (!buf) {
+			return -1;
+		}
+		g->send_buff = buf;
+		g->send_max = 2 * len + 5;
+	}
+	g->send_buff[0] = '$';
+	g->send_len = 1;
+	for (i = 0; i < len; i++) {
+		char c = data[i];
+		if (c == '#' || c == '$' || c == '}' || c == '*') {
+			g->send_buff[g->send_len++] = '}';
+			c ^= 0x20;
+		}
+		g->send_buff[g->send_len++] = c;
+	}
+	for (i = 1; i < g->send_len; i++) {
+		sum += (ut8)g->send_buff[i];
+	}
+	snprintf (g->send_buff + g->send_len, 4, "#%.2x", sum);
+	g->send_len += 3;
+	return g->send_len;
+}
@@ -23,8 +23,10 @@
 SDB_API char *sdb_fmt(const char *fmt, ...) {
 #define KL 256
 #define KN 16
-	static char Key[KN][KL];
-	static int n = 0;
+	// one ring per thread, the returned keys are only valid until the
+	// same thread has made KN more calls
+	static SDB_THREAD_LOCAL char Key[KN][KL];
+	static SDB_THREAD_LOCAL int n = 0;
 	va_list ap;
 	va_start (ap, fmt);
 	n = (n + 1) % KN;
@@ -14,3 +14,29 @@ SDB_API HtName_(Ht)* Ht_(new0)(void) {
 	};
 	return Ht_(new_opt) (&opt);
 }
+
+// creates a HtUU with enough buckets for initial_size elements, so filling
+// it with a known number of items does not need to grow and rehash it
+SDB_API HtName_(Ht)* Ht_(new_size)(ut32 initial_size) {
+	HT_(Options) opt = {
+		.cmp = NULL,
+		.hashfn = NULL,
+		.dupkey = NULL,
+		.dupvalue = NULL,
+		.calcsizeK = NULL,
+		.calcsizeV = NULL,
+		.freefn = NULL
+	};
+	ut32 i = 0;
+
+	while (i < S_ARRAY_SIZE (ht_primes_sizes) &&
+		ht_primes_sizes[i] * LOAD_FACTOR < initial_size) {
+		i++;
+	}
+	if (i == S_ARRAY_SIZE (ht_primes_sizes)) {
+		i = UT32_MAX;
+	}
+
+	ut32 sz = compute_size (i, (ut32)(initial_size * (2 - LOAD_FACTOR)));
+	return internal_ht_new (sz, i, &opt);
+}
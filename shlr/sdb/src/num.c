@@ -14,6 +14,16 @@ SDB_API ut64 sdb_num_get(Sdb *s, const char *key, ut32 *cas) {
 	return (!v || *v == '-') ? 0LL : sdb_atoi (v);
 }
 
+SDB_API ut64 sdb_num_get_at(Sdb *s, const char *prefix, ut64 n, ut32 *cas) {
+	char key[SDB_NUMKEY_BUFSZ];
+	return sdb_num_get (s, sdb_numkey (key, sizeof (key), prefix, n, NULL), cas);
+}
+
+SDB_API int sdb_num_set_at(Sdb *s, const char *prefix, ut64 n, ut64 v, ut32 cas) {
+	char key[SDB_NUMKEY_BUFSZ];
+	return sdb_num_set (s, sdb_numkey (key, sizeof (key), prefix, n, NULL), v, cas);
+}
+
 SDB_API int sdb_num_add(Sdb *s, const char *key, ut64 v, ut32 cas) {
 	char *val, b[SDB_NUM_BUFSZ];
 	int numbase = sdb_num_base (sdb_const_get (s, key, NULL));
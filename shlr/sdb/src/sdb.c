@@ -153,7 +153,107 @@ SDB_API bool sdb_merge(Sdb* d, Sdb *s) {
 	return sdb_foreach (s, sdb_merge_cb, d);
 }
 
+static void sdb_layer_free(void *p) {
+	sdb_free ((Sdb *)p);
+}
+
+/* a cdb lookup finds the first of the repeated keys while a merge keeps
+ * the last one, keep those few in the memory of the layer */
+static void sdb_layer_dups(Sdb *l) {
+	char k[SDB_MAX_KEY];
+	ut32 klen, vlen, eod;
+	ut32 pos = sizeof (((struct cdb_make *)0)->final);
+	ut32_unpack (l->db.map, &eod);
+	if (eod > l->db.size) {
+		return;
+	}
+	while (pos < eod && cdb_getkvlen (&l->db, &klen, &vlen, pos)) {
+		if (klen < 1 || vlen < 1 || eod - pos - KVLSZ < klen + vlen) {
+			break;
+		}
+		const char *key = l->db.map + pos + KVLSZ;
+		if (klen < SDB_MAX_KEY && !key[klen - 1]) {
+			memcpy (k, key, klen);
+			cdb_findstart (&l->db);
+			if (cdb_findnext (&l->db, sdb_hash (k), k, klen - 1) > 0
+					&& cdb_datapos (&l->db) != pos + KVLSZ + klen) {
+				sdb_set (l, k, key + klen, 0);
+			}
+		}
+		pos += KVLSZ + klen + vlen;
+	}
+}
+
+/* stacks a cdb file below the keys of s instead of copying them like
+ * sdb_merge does, lookups read the mapped file (shared by every process
+ * using it) and writes stay in memory. the last layer added wins, adding
+ * a file again moves it to the top */
+SDB_API bool sdb_layer(Sdb *s, const char *file) {
+	SdbListIter *it;
+	Sdb *l;
+	if (!s || !file) {
+		return false;
+	}
+	ls_foreach (s->layers, it, l) {
+		if (l->dir && !strcmp (l->dir, file)) {
+			ls_delete (s->layers, it);
+			break;
+		}
+	}
+	l = sdb_new (NULL, file, 0);
+	if (!l) {
+		return false;
+	}
+	if (l->fd == -1 || !l->db.map) {
+		sdb_free (l);
+		return false;
+	}
+	sdb_layer_dups (l);
+	if (!s->layers) {
+		s->layers = ls_newf (sdb_layer_free);
+		if (!s->layers) {
+			sdb_free (l);
+			return false;
+		}
+	}
+	ls_prepend (s->layers, l);
+	return true;
+}
+
+static bool cdb_has(Sdb *s, const char *key, ut32 klen) {
+	if (s->fd == -1) {
+		return false;
+	}
+	cdb_findstart (&s->db);
+	return cdb_findnext (&s->db, sdb_hash (key), key, klen) > 0;
+}
+
+static bool sdb_layers_has(Sdb *s, const char *key, ut32 klen) {
+	SdbListIter *it;
+	Sdb *l;
+	ls_foreach (s->layers, it, l) {
+		if (cdb_has (l, key, klen)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static const char *sdb_layers_get(Sdb *s, const char *key, int *vlen) {
+	SdbListIter *it;
+	const char *v;
+	Sdb *l;
+	ls_foreach (s->layers, it, l) {
+		if ((v = sdb_const_get_len (l, key, vlen, NULL))) {
+			return v;
+		}
+	}
+	return NULL;
+}
+
 SDB_API bool sdb_isempty(Sdb *s) {
+	SdbListIter *it;
+	Sdb *l;
 	if (s) {
 		if (s->db.fd != -1) {
 			sdb_dump_begin (s);
@@ -164,12 +264,27 @@ SDB_API bool sdb_isempty(Sdb *s) {
 		if (s->ht && s->ht->count > 0) {
 			return false;
 		}
+		ls_foreach (s->layers, it, l) {
+			if (!sdb_isempty (l)) {
+				return false;
+			}
+		}
 	}
 	return true;
 }
 
+static int sdb_count_cb(void *user, const char *k, const char *v) {
+	(*(int *)user)++;
+	return true;
+}
+
 SDB_API int sdb_count(Sdb *s) {
 	int count = 0;
+	if (s && !ls_empty (s->layers)) {
+		// keys can be shadowed by the upper files, walk them
+		sdb_foreach (s, sdb_count_cb, &count);
+		return count;
+	}
 	if (s) {
 		if (s->db.fd != -1) {
 			sdb_dump_begin (s);
@@ -194,6 +309,8 @@ static void sdb_fini(Sdb* s, int donull) {
 		sdb_unlock (sdb_lock_file (s->dir));
 	}
 	sdb_ns_free (s);
+	ls_free (s->layers);
+	s->layers = NULL;
 	s->refs = 0;
 	free (s->name);
 	free (s->path);
@@ -270,11 +387,11 @@ SDB_API const char *sdb_const_get_len(Sdb* s, const char *key, int *vlen, ut32 *
 	}
 	/* search in disk */
 	if (s->fd == -1) {
-		return NULL;
+		return sdb_layers_get (s, key, vlen);
 	}
 	(void) cdb_findstart (&s->db);
 	if (cdb_findnext (&s->db, s->ht->opt.hashfn (key), key, keylen) < 1) {
-		return NULL;
+		return sdb_layers_get (s, key, vlen);
 	}
 	len = cdb_datalen (&s->db);
 	if (len < SDB_MIN_VALUE || len >= SDB_MAX_VALUE) {
@@ -306,6 +423,28 @@ SDB_API int sdb_unset(Sdb* s, const char *key, ut32 cas) {
 	return key? sdb_set (s, key, "", cas): 0;
 }
 
+/* the *_at accessors take the key as prefix + n in hex, see sdb_numkey */
+
+SDB_API const char *sdb_const_get_at(Sdb* s, const char *prefix, ut64 n, ut32 *cas) {
+	char key[SDB_NUMKEY_BUFSZ];
+	return sdb_const_get (s, sdb_numkey (key, sizeof (key), prefix, n, NULL), cas);
+}
+
+SDB_API char *sdb_get_at(Sdb* s, const char *prefix, ut64 n, ut32 *cas) {
+	char key[SDB_NUMKEY_BUFSZ];
+	return sdb_get (s, sdb_numkey (key, sizeof (key), prefix, n, NULL), cas);
+}
+
+SDB_API int sdb_set_at(Sdb* s, const char *prefix, ut64 n, const char *val, ut32 cas) {
+	char key[SDB_NUMKEY_BUFSZ];
+	return sdb_set (s, sdb_numkey (key, sizeof (key), prefix, n, NULL), val, cas);
+}
+
+SDB_API int sdb_unset_at(Sdb* s, const char *prefix, ut64 n, ut32 cas) {
+	char key[SDB_NUMKEY_BUFSZ];
+	return sdb_unset (s, sdb_numkey (key, sizeof (key), prefix, n, NULL), cas);
+}
+
 /* remove from memory */
 SDB_API bool sdb_remove(Sdb *s, const char *key, ut32 cas) {
 	return sdb_ht_delete (s->ht, key);
@@ -381,7 +520,7 @@ SDB_API bool sdb_exists(Sdb* s, const char *key) {
 		return v && *v;
 	}
 	if (s->fd == -1) {
-		return false;
+		return sdb_layers_get (s, key, NULL) != NULL;
 	}
 	(void)cdb_findstart (&s->db);
 	if (cdb_findnext (&s->db, sdb_hash (key), key, klen)) {
@@ -389,7 +528,7 @@ SDB_API bool sdb_exists(Sdb* s, const char *key) {
 		cdb_read (&s->db, &ch, 1, pos);
 		return ch != 0;
 	}
-	return false;
+	return sdb_layers_get (s, key, NULL) != NULL;
 }
 
 SDB_API int sdb_open(Sdb *s, const char *file) {
@@ -445,6 +584,8 @@ SDB_API void sdb_reset(Sdb* s) {
 	/* ignore disk cache, file is not removed, but we will ignore
 	 * its values when syncing again */
 	sdb_close (s);
+	ls_free (s->layers);
+	s->layers = NULL;
 	/* empty memory hashtable */
 	sdb_ht_free (s->ht);
 	s->ht = sdb_ht_new ();
@@ -573,7 +714,9 @@ static ut32 sdb_set_internal(Sdb* s, const char *key, char *val, int owned, ut32
 	cdb_findstart (&s->db);
 	kv = sdb_ht_find_kvp (s->ht, key, &found);
 	if (found && sdbkv_value (kv)) {
-		if (cdb_findnext (&s->db, sdb_hash (key), key, klen)) {
+		// an empty value only needs to stay as a tombstone hiding a file key
+		if (vlen || cdb_findnext (&s->db, sdb_hash (key), key, klen)
+				|| sdb_layers_has (s, key, klen)) {
 			if (cas && kv->cas != cas) {
 				if (owned) {
 					free (val);
@@ -777,16 +920,83 @@ static bool sdb_foreach_cdb(Sdb *s, SdbForeachCallback cb,
 	return true;
 }
 
+/* true if k is in the file of s or in a layer above l */
+static bool sdb_layer_shadowed(Sdb *s, Sdb *l, const char *k) {
+	SdbListIter *it;
+	Sdb *u;
+	ut32 klen = strlen (k);
+	if (cdb_has (s, k, klen)) {
+		return true;
+	}
+	ls_foreach (s->layers, it, u) {
+		if (u == l) {
+			break;
+		}
+		if (cdb_has (u, k, klen)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* walks the file of d, being s or one of its layers, skipping the keys
+ * that the memory of s or an upper file overrides */
+static bool sdb_foreach_disk(Sdb *s, Sdb *d, SdbForeachCallback cb, void *user) {
+	char *v = NULL;
+	char k[SDB_MAX_KEY] = {0};
+	bool found;
+	SdbKv *kv;
+	ut32 i, j, count;
+	sdb_dump_begin (d);
+	while (sdb_dump_dupnext (d, k, &v, NULL)) {
+		(void)sdb_ht_find_kvp (s->ht, k, &found);
+		if (!found && d != s) {
+			(void)sdb_ht_find_kvp (d->ht, k, &found);
+			if (!found) {
+				found = sdb_layer_shadowed (s, d, k);
+			}
+		}
+		if (!found && v && !cb (user, k, v)) {
+			free (v);
+			return false;
+		}
+		free (v);
+	}
+	if (d == s) {
+		return true;
+	}
+	/* the repeated keys of the layer */
+	for (i = 0; i < d->ht->size; i++) {
+		HtPPBucket *bt = &d->ht->table[i];
+		BUCKET_FOREACH_SAFE (d->ht, bt, j, count, kv) {
+			(void)sdb_ht_find_kvp (s->ht, sdbkv_key (kv), &found);
+			if (found || sdb_layer_shadowed (s, d, sdbkv_key (kv))) {
+				continue;
+			}
+			if (!cb (user, sdbkv_key (kv), sdbkv_value (kv))) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
 SDB_API bool sdb_foreach(Sdb* s, SdbForeachCallback cb, void *user) {
-	bool result;
+	SdbListIter *it;
+	Sdb *l;
 	if (!s) {
 		return false;
 	}
 	s->depth++;
-	result = sdb_foreach_cdb (s, cb, NULL, user);
-	if (!result) {
+	// keys also in memory are listed with the hashtable below
+	if (!sdb_foreach_disk (s, s, cb, user)) {
 		return sdb_foreach_end (s, false);
 	}
+	ls_foreach (s->layers, it, l) {
+		if (!sdb_foreach_disk (s, l, cb, user)) {
+			return sdb_foreach_end (s, false);
+		}
+	}
 
 	ut32 i;
 	for (i = 0; i < s->ht->size; ++i) {
@@ -99,6 +99,40 @@ SDB_API const char *sdb_itoca(ut64 n) {
 	return sdb_itoa (n, sdb_fmt (NULL), 16);
 }
 
+static void numkey_append(char *buf, size_t size, size_t *len, const char *s, size_t slen) {
+	if (*len + slen >= size) {
+		slen = size - *len - 1;
+	}
+	memcpy (buf + *len, s, slen);
+	*len += slen;
+}
+
+/* Builds prefix + n in lowercase hex + suffix into buf without parsing a
+ * format string or touching shared state, so it can replace sdb_fmt for
+ * address keys on hot paths and from any thread. The "0x" is up to the
+ * prefix. Returns buf, truncated to size if needed. */
+SDB_API char *sdb_numkey(char *buf, size_t size, const char *prefix, ut64 n, const char *suffix) {
+	static const char hex[] = "0123456789abcdef";
+	char num[16];
+	size_t i = sizeof (num), len = 0;
+	if (!buf || !size) {
+		return NULL;
+	}
+	do {
+		num[--i] = hex[n & 0xf];
+		n >>= 4;
+	} while (n);
+	if (prefix) {
+		numkey_append (buf, size, &len, prefix, strlen (prefix));
+	}
+	numkey_append (buf, size, &len, num + i, sizeof (num) - i);
+	if (suffix) {
+		numkey_append (buf, size, &len, suffix, strlen (suffix));
+	}
+	buf[len] = 0;
+	return buf;
+}
+
 // assert (sizeof (s)>64)
 // if s is null, the returned pointer must be freed!!
 SDB_API char *sdb_itoa(ut64 n, char *s, int base) {
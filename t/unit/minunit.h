@@ -0,0 +1,62 @@
+#ifndef _MINUNIT_H_
+#define _MINUNIT_H_
+
+#include <stdio.h>
+#include <r_types.h>
+#include <r_util/r_str.h>
+
+#define MU_PASSED 0
+#define MU_ERR 1
+
+#define TRED     "\x1b[31m"
+#define TGREEN   "\x1b[32m"
+#define TBOLD    "\x1b[1m"
+#define TRESET   "\x1b[0m"
+
+#define mu_assert(message, test) do { \
+		if (!(test)) { \
+			printf (TRED "FAIL" TRESET "\n  %s:%d %s\n", __FILE__, __LINE__, message); \
+			return MU_ERR; \
+		} \
+	} while (0)
+
+#define mu_assert_true(actual, message) mu_assert (message, (actual))
+#define mu_assert_false(actual, message) mu_assert (message, !(actual))
+#define mu_assert_null(actual, message) mu_assert (message, (actual) == NULL)
+#define mu_assert_notnull(actual, message) mu_assert (message, (actual) != NULL)
+
+#define mu_assert_eq(actual, expected, message) do { \
+		ut64 act__ = (ut64)(actual), exp__ = (ut64)(expected); \
+		if (act__ != exp__) { \
+			printf (TRED "FAIL" TRESET "\n  %s:%d %s: expected 0x%"PFMT64x", got 0x%"PFMT64x"\n", \
+				__FILE__, __LINE__, message, exp__, act__); \
+			return MU_ERR; \
+		} \
+	} while (0)
+
+#define mu_assert_streq(actual, expected, message) do { \
+		const char *act__ = (actual), *exp__ = (expected); \
+		if (!act__ || strcmp (act__, exp__)) { \
+			printf (TRED "FAIL" TRESET "\n  %s:%d %s: expected \"%s\", got \"%s\"\n", \
+				__FILE__, __LINE__, message, exp__, act__? act__: "(null)"); \
+			return MU_ERR; \
+		} \
+	} while (0)
+
+#define mu_end do { \
+		printf (TGREEN "OK" TRESET "\n"); \
+		return MU_PASSED; \
+	} while (0)
+
+#define mu_run_test(test) do { \
+		printf (TBOLD #test TRESET " "); \
+		if (!test ()) { \
+			tests_passed++; \
+		} \
+		tests_run++; \
+	} while (0)
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#endif
@@ -0,0 +1,90 @@
+#include <r_cons.h>
+#include "minunit.h"
+
+#define COLS 100
+#define ROWS 40
+#define NODES 8
+
+/* a visual graph like frame: boxed nodes with a few lines of text, the
+ * selected one in another color, flushed the way agraph_print does */
+static int draw(RConsCanvas *c, bool damage, int sel, int fd) {
+	int i, j;
+	r_cons_canvas_clear (c);
+	for (i = 0; i < NODES; i++) {
+		int x = 2 + (i % 4) * 24, y = 1 + (i / 4) * 18;
+		r_cons_canvas_box (c, x, y, 22, 16, i == sel? Color_BYELLOW: Color_BLUE);
+		for (j = 0; j < 12; j++) {
+			if (r_cons_canvas_gotoxy (c, x + 2, y + 2 + j)) {
+				r_cons_canvas_write (c, sdb_fmt ("0x%08x mov r%d, %d", 0x1000 + i * 0x40 + j * 4, j, i));
+			}
+		}
+	}
+	off_t start = lseek (fd, 0, SEEK_CUR);
+	if (damage) {
+		r_cons_gotoxy (0, 0);
+	} else {
+		r_cons_clear00 ();
+	}
+	r_cons_canvas_print_region (c);
+	r_cons_newline ();
+	r_cons_visual_flush ();
+	return (int)(lseek (fd, 0, SEEK_CUR) - start);
+}
+
+static int open_sink(void) {
+	char *path = NULL;
+	int fd = r_file_mkstemp ("damage", &path);
+	if (path) {
+		r_file_rm (path);
+		free (path);
+	}
+	return fd;
+}
+
+int test_graph_damage(void) {
+	RCons *cons = r_cons_new ();
+	RConsCanvas *c = r_cons_canvas_new (COLS, ROWS);
+	mu_assert_notnull (c, "cannot create the canvas");
+	int fd = open_sink ();
+	mu_assert_true (fd != -1, "cannot create the output file");
+	const int fdout = cons->fdout;
+	cons->fdout = fd;
+	cons->columns = COLS;
+	cons->rows = ROWS;
+	c->color = 1;
+
+	cons->damage = false;
+	int full = draw (c, false, 0, fd);
+	int full_sel = draw (c, false, 1, fd);
+
+	cons->damage = true;
+	int first = draw (c, true, 0, fd);
+	int same = draw (c, true, 0, fd);
+	int sel = draw (c, true, 1, fd);
+	eprintf ("bytes per frame: full %d, full after tab %d, damage first %d, unchanged %d, after tab %d\n",
+		full, full_sel, first, same, sel);
+
+	mu_assert_true (full > 0 && full_sel > 0, "nothing was written");
+	mu_assert_true (first > 0, "the first frame must be painted in full");
+	mu_assert_eq (same, 0, "an unchanged frame must not write anything");
+	mu_assert_true (sel > 0, "the selection change was not painted");
+	// only the rows crossing the two recolored boxes are sent again
+	mu_assert_true (sel * 4 < full_sel * 3, "moving the selection repaints too much");
+
+	cons->fdout = fdout;
+	cons->damage = false;
+	r_cons_visual_invalidate ();
+	close (fd);
+	r_cons_canvas_free (c);
+	r_cons_free ();
+	mu_end;
+}
+
+int all_tests(void) {
+	mu_run_test (test_graph_damage);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
@@ -0,0 +1,130 @@
+#include <r_core.h>
+#include "minunit.h"
+
+#define CACHE_BASE 0x180000000ULL
+#define DELTA_MASK 0x00ffff0000000000ULL
+// the slide info stores pointer deltas in 4 byte units
+#define PTR_DELTA(x) (((ut64)(x) / 4) << 40)
+
+/* one text and one data mapping, slide info v2 rebasing a chain of two
+ * pointers at the start of the data mapping */
+static char *write_cache(void) {
+	ut8 *buf = calloc (1, 0x3000);
+	if (!buf) {
+		return NULL;
+	}
+	memcpy (buf, "dyld_v1   arm64", 15);
+	r_write_le32 (buf + 0x10, 0x100); // mappingOffset
+	r_write_le32 (buf + 0x14, 2); // mappingCount
+	r_write_le32 (buf + 0x18, 0x200); // imagesOffset
+	r_write_le32 (buf + 0x1c, 1); // imagesCount
+	r_write_le64 (buf + 0x38, 0x2000); // slideInfoOffset
+	r_write_le64 (buf + 0x40, 0x100); // slideInfoSize
+	r_write_le64 (buf + 0x78, CACHE_BASE + 0x400); // accelerateInfoAddr
+	r_write_le64 (buf + 0x80, 0x48); // accelerateInfoSize
+
+	ut8 *map = buf + 0x100;
+	r_write_le64 (map, CACHE_BASE);
+	r_write_le64 (map + 8, 0x1000);
+	r_write_le64 (map + 16, 0);
+	r_write_le32 (map + 24, 5);
+	r_write_le32 (map + 28, 5);
+	map += 32;
+	r_write_le64 (map, CACHE_BASE + 0x1000);
+	r_write_le64 (map + 8, 0x1000);
+	r_write_le64 (map + 16, 0x1000);
+	r_write_le32 (map + 24, 3);
+	r_write_le32 (map + 28, 3);
+
+	r_write_le64 (buf + 0x200, CACHE_BASE + 0x800);
+	r_write_le32 (buf + 0x218, 0x300);
+	strcpy ((char *)buf + 0x300, "/usr/lib/libtest.dylib");
+
+	ut8 *slide = buf + 0x2000;
+	r_write_le32 (slide, 2); // version
+	r_write_le32 (slide + 4, 0x1000); // page_size
+	r_write_le32 (slide + 8, 0x28); // page_starts_offset
+	r_write_le32 (slide + 12, 1); // page_starts_count
+	r_write_le32 (slide + 16, 0x30); // page_extras_offset
+	r_write_le32 (slide + 20, 0); // page_extras_count
+	r_write_le64 (slide + 24, DELTA_MASK);
+	r_write_le64 (slide + 32, CACHE_BASE); // value_add
+	r_write_le16 (slide + 0x28, 0x40 / 4);
+
+	r_write_le64 (buf + 0x1040, PTR_DELTA (8) | 0x4000);
+	r_write_le64 (buf + 0x1048, 0x5000);
+
+	char *path = NULL;
+	int fd = r_file_mkstemp ("dyldcache", &path);
+	if (fd == -1) {
+		free (buf);
+		return NULL;
+	}
+	close (fd);
+	if (!r_file_dump (path, buf, 0x3000, false)) {
+		R_FREE (path);
+	}
+	free (buf);
+	return path;
+}
+
+int test_dyldcache_rebased_read(void) {
+	char *path = write_cache ();
+	mu_assert_notnull (path, "cannot write the test cache");
+
+	// the read hook finds the cache through the core owning the io
+	RCore *core = R_NEW0 (RCore);
+	RIO *io = r_io_new ();
+	RBin *bin = r_bin_new ();
+	core->io = io;
+	core->bin = bin;
+	io->user = core;
+	io->va = false;
+	r_io_bind (io, &bin->iob);
+
+	RIODesc *desc = r_io_open_nomap (io, path, R_PERM_R, 0);
+	mu_assert_notnull (desc, "cannot open the test cache");
+	r_io_use_fd (io, desc->fd);
+	RIOPlugin *plugin = desc->plugin;
+	void *read = plugin->read, *read_at = plugin->read_at;
+
+	RBinOptions opt;
+	r_bin_options_init (&opt, desc->fd, 0, 0, false);
+	mu_assert_true (r_bin_open (bin, path, &opt), "cannot load the test cache");
+	mu_assert_streq (bin->cur->o->plugin->name, "dyldcache", "wrong plugin");
+	mu_assert_true (plugin->read_at != read_at, "read_at is not hooked");
+
+	ut8 ptr[8];
+	mu_assert_eq (r_io_desc_read_at (desc, 0x1040, ptr, sizeof (ptr)), sizeof (ptr), "short read");
+	mu_assert_eq (r_read_le64 (ptr), CACHE_BASE + 0x4000, "first pointer is not rebased");
+	mu_assert_eq (r_io_desc_read_at (desc, 0x1048, ptr, sizeof (ptr)), sizeof (ptr), "short read");
+	mu_assert_eq (r_read_le64 (ptr), CACHE_BASE + 0x5000, "chained pointer is not rebased");
+
+	// the seek based read takes the same path
+	mu_assert_eq (r_io_desc_seek (desc, 0x1040, R_IO_SEEK_SET), 0x1040, "cannot seek");
+	mu_assert_eq (r_io_desc_read (desc, ptr, sizeof (ptr)), sizeof (ptr), "short read");
+	mu_assert_eq (r_read_le64 (ptr), CACHE_BASE + 0x4000, "seek read is not rebased");
+
+	// bytes outside the data mapping are left alone
+	mu_assert_eq (r_io_desc_read_at (desc, 0x200, ptr, sizeof (ptr)), sizeof (ptr), "short read");
+	mu_assert_eq (r_read_le64 (ptr), CACHE_BASE + 0x800, "text bytes changed");
+
+	// the callbacks belong to the shared plugin, give them back
+	plugin->read = read;
+	plugin->read_at = read_at;
+	r_bin_free (bin);
+	r_io_free (io);
+	free (core);
+	r_file_rm (path);
+	free (path);
+	mu_end;
+}
+
+int all_tests(void) {
+	mu_run_test (test_dyldcache_rebased_read);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
@@ -0,0 +1,129 @@
+#include <r_io.h>
+#include "minunit.h"
+
+#define BLOCK (64 * 1024)
+#define SIZE (5 * BLOCK + 1234)
+
+static ut8 *data;
+
+static int frame_header(ut8 *out, ut8 flg) {
+	r_write_le32 (out, 0x184D2204);
+	out[4] = flg;
+	out[5] = 0x40; // 64K blocks
+	out[6] = 0; // header checksum, not verified
+	return 7;
+}
+
+/* two frames: the first one with a stored block, the second one with a
+ * content checksum, separated by a skippable frame */
+static char *write_lz4(bool linked) {
+	ut8 *buf = malloc (2 * SIZE);
+	ut8 *cbuf = malloc (r_lz4_bound (BLOCK));
+	int n = 0, off;
+	if (!buf || !cbuf) {
+		free (buf);
+		free (cbuf);
+		return NULL;
+	}
+	n += frame_header (buf + n, linked? 0x40: 0x60);
+	for (off = 0; off < SIZE; off += BLOCK) {
+		int len = R_MIN (BLOCK, SIZE - off);
+		if (off == 3 * BLOCK) {
+			r_write_le32 (buf + n, 0); // end mark of the first frame
+			r_write_le32 (buf + n + 4, 0x184D2A53);
+			r_write_le32 (buf + n + 8, 3);
+			n += 12 + 3;
+			n += frame_header (buf + n, 0x64);
+		}
+		if (off == BLOCK) {
+			r_write_le32 (buf + n, len | 0x80000000);
+			memcpy (buf + n + 4, data + off, len);
+			n += 4 + len;
+			continue;
+		}
+		int clen = r_lz4_compress (data + off, len, cbuf, r_lz4_bound (BLOCK));
+		r_write_le32 (buf + n, clen);
+		memcpy (buf + n + 4, cbuf, clen);
+		n += 4 + clen;
+	}
+	r_write_le32 (buf + n, 0);
+	n += 4;
+	r_write_le32 (buf + n, 0x12345678); // content checksum, not verified
+	n += 4;
+	free (cbuf);
+
+	char *path = NULL;
+	int fd = r_file_mkstemp ("lz4", &path);
+	if (fd != -1) {
+		close (fd);
+		if (!r_file_dump (path, buf, n, false)) {
+			R_FREE (path);
+		}
+	}
+	free (buf);
+	return path;
+}
+
+int test_lz4_read(void) {
+	char *path = write_lz4 (false);
+	mu_assert_notnull (path, "cannot write the test file");
+	RIO *io = r_io_new ();
+	char *uri = r_str_newf ("lz4://%s", path);
+	RIODesc *desc = r_io_open_nomap (io, uri, R_PERM_R, 0);
+	mu_assert_notnull (desc, "cannot open the lz4 file");
+	mu_assert_eq (r_io_desc_size (desc), SIZE, "wrong uncompressed size");
+
+	ut8 *buf = malloc (SIZE);
+	// reads crossing the stored block and the frame boundary
+	const ut64 at[] = { 0, BLOCK - 10, 2 * BLOCK - 7, 3 * BLOCK - 100, SIZE - 500 };
+	int i;
+	for (i = 0; i < sizeof (at) / sizeof (at[0]); i++) {
+		int len = (int)R_MIN (BLOCK + 300, SIZE - at[i]);
+		mu_assert_eq (r_io_desc_read_at (desc, at[i], buf, len), len, "short read");
+		mu_assert_true (!memcmp (buf, data + at[i], len), "wrong bytes");
+	}
+	mu_assert_eq (r_io_desc_read_at (desc, 0, buf, SIZE), SIZE, "short read");
+	mu_assert_true (!memcmp (buf, data, SIZE), "wrong bytes in the full read");
+
+	free (buf);
+	r_io_desc_close (desc);
+	r_io_free (io);
+	r_file_rm (path);
+	free (uri);
+	free (path);
+	mu_end;
+}
+
+int test_lz4_linked(void) {
+	char *path = write_lz4 (true);
+	mu_assert_notnull (path, "cannot write the test file");
+	RIO *io = r_io_new ();
+	char *uri = r_str_newf ("lz4://%s", path);
+	mu_assert_null (r_io_open_nomap (io, uri, R_PERM_R, 0), "linked blocks must be rejected");
+	r_io_free (io);
+	r_file_rm (path);
+	free (uri);
+	free (path);
+	mu_end;
+}
+
+int all_tests(void) {
+	mu_run_test (test_lz4_read);
+	mu_run_test (test_lz4_linked);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	int i;
+	data = malloc (SIZE);
+	if (!data) {
+		return 1;
+	}
+	// compressible text, with a noisy block that lz4 would store as is
+	for (i = 0; i < SIZE; i++) {
+		data[i] = (i / BLOCK == 1)? (ut8)(r_num_rand (256)): "radare2 lz4 "[i % 12] + (i / 4096) % 3;
+	}
+	int ret = all_tests ();
+	free (data);
+	return ret;
+}
@@ -0,0 +1,53 @@
+#include <r_util.h>
+#include "minunit.h"
+
+int test_pool_recycle(void) {
+	RMemoryPool *pool = r_mem_pool_new (24, 4, 1);
+	mu_assert_notnull (pool, "cannot create the pool");
+	if (pool->nopool) {
+		r_mem_pool_free (pool);
+		mu_end;
+	}
+	ut8 *a = r_mem_pool_alloc (pool);
+	ut8 *b = r_mem_pool_alloc (pool);
+	mu_assert_notnull (a, "alloc failed");
+	mu_assert_notnull (b, "alloc failed");
+	memset (a, 0x41, 24);
+	r_mem_pool_release (pool, a);
+	ut8 *c = r_mem_pool_alloc (pool);
+	mu_assert_true (c == a, "released node was not reused");
+	mu_assert_eq (c[8], 0, "reused node is not zeroed");
+	mu_assert_eq (pool->live, 2, "wrong live count");
+	r_mem_pool_release (pool, b);
+	r_mem_pool_release (pool, c);
+	mu_assert_eq (pool->live, 0, "wrong live count");
+	r_mem_pool_free (pool);
+	mu_end;
+}
+
+int test_pool_drop(void) {
+	RMemoryPool *pool = r_mem_pool_new (32, 4, 1);
+	mu_assert_notnull (pool, "cannot create the pool");
+	void *a = r_mem_pool_alloc (pool);
+	void *b = r_mem_pool_alloc (pool);
+	// the owner goes away first, the nodes keep the pool alive
+	r_mem_pool_drop (pool);
+	mu_assert_true (pool->dropped, "pool is not dropped");
+	r_mem_pool_release (pool, a);
+	mu_assert_eq (pool->live, 1, "wrong live count");
+	// the last release frees it, ASan reports a leak otherwise
+	r_mem_pool_release (pool, b);
+	// an empty pool is freed right away
+	r_mem_pool_drop (r_mem_pool_new (32, 4, 1));
+	mu_end;
+}
+
+int all_tests(void) {
+	mu_run_test (test_pool_recycle);
+	mu_run_test (test_pool_drop);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}